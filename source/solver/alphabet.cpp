@@ -278,6 +278,7 @@ Alphabet::set(const string& characters)
     LOG("setting alphabet to " + Utils::quoted(g_characters_as_string));
 
     g_characters.clear();
+    g_word_characters.clear();
     for (size_t i = 0; i != g_characters_as_string.size(); ++i)
     {
         g_characters.add_character_at(i);
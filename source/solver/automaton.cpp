@@ -0,0 +1,154 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "automaton.hpp"
+
+#include <cassert>
+
+using namespace std;
+
+
+Automaton::Transition::Transition(const SetOfCharacters& characters_,
+                                  size_t                 to_) :
+  characters(characters_),
+  to(to_)
+{
+}
+
+Automaton::EpsilonTransition::EpsilonTransition(size_t to_, Anchor anchor_) :
+  to(to_),
+  anchor(anchor_)
+{
+}
+
+// instance creation and deletion
+
+// Create an automaton with an initial state and a final state, and no
+// transitions. It recognizes no strings.
+Automaton::Automaton()
+{
+    add_state();
+    add_state();
+}
+
+// accessing
+
+// Return the states which can be reached from 'state' with epsilon
+// transitions only, including 'state' itself. 'at_start' and 'at_end'
+// tell whether the position of 'state' in the string is the beginning
+// and/or the end of the string.
+vector<size_t>
+Automaton::epsilon_closure(size_t state, bool at_start, bool at_end) const
+{
+    assert(state < num_states());
+
+    vector<bool> is_reached(num_states(), false);
+    vector<size_t> result;
+    vector<size_t> states_to_visit = { state };
+
+    while (!states_to_visit.empty())
+    {
+        const auto state_ = states_to_visit.back();
+        states_to_visit.pop_back();
+
+        if (is_reached[state_])
+        {
+            continue;
+        }
+
+        is_reached[state_] = true;
+        result.push_back(state_);
+
+        for (const auto& transition : m_epsilon_transitions[state_])
+        {
+            if ((transition.anchor == Anchor::start && !at_start) ||
+                (transition.anchor == Anchor::end   && !at_end))
+            {
+                continue;
+            }
+
+            states_to_visit.push_back(transition.to);
+        }
+    }
+
+    return result;
+}
+
+size_t
+Automaton::final_state()
+{
+    return 1;
+}
+
+size_t
+Automaton::initial_state()
+{
+    return 0;
+}
+
+size_t
+Automaton::num_states() const
+{
+    return m_transitions.size();
+}
+
+const vector<Automaton::Transition>&
+Automaton::transitions(size_t state) const
+{
+    assert(state < num_states());
+    return m_transitions[state];
+}
+
+// modifying
+
+void
+Automaton::add_epsilon_transition(size_t from, size_t to, Anchor anchor)
+{
+    assert(from < num_states());
+    assert(to < num_states());
+
+    m_epsilon_transitions[from].emplace_back(to, anchor);
+}
+
+// Add a state without transitions, and return it.
+size_t
+Automaton::add_state()
+{
+    m_transitions.emplace_back();
+    m_epsilon_transitions.emplace_back();
+    return num_states() - 1;
+}
+
+void
+Automaton::add_transition(size_t                 from,
+                          const SetOfCharacters& characters,
+                          size_t                 to)
+{
+    assert(from < num_states());
+    assert(to < num_states());
+
+    m_transitions[from].emplace_back(characters, to);
+}
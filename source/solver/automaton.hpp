@@ -0,0 +1,115 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef AUTOMATON_HPP
+#define AUTOMATON_HPP
+
+#include "set_of_characters.hpp"
+
+#include <vector>
+
+
+// An instance of this class is a nondeterministic finite automaton,
+// with epsilon transitions, which recognizes the strings that a regex
+// matches (see Regex::get_automaton()).
+//
+// Its states are numbered from 0. It has a single initial state and a
+// single final state. An epsilon transition may be restricted to the
+// beginning or to the end of the string, which is how '^' and '$' are
+// represented.
+//
+// For example, the automaton of 'A|B*' could be:
+//
+//     0 --A--> 1
+//     0 --eps--> 2 --B--> 2 --eps--> 1
+//
+// where 0 is the initial state, 1 the final state, and "eps" an
+// epsilon transition.
+class Automaton final
+{
+public:
+    // Where an epsilon transition may be taken.
+    enum class Anchor
+    {
+        none,    // anywhere
+        start,   // only at the beginning of the string
+        end      // only at the end of the string
+    };
+
+    // A transition on one of 'characters' to state 'to'.
+    struct Transition
+    {
+        Transition(const SetOfCharacters& characters_, size_t to_);
+
+        SetOfCharacters characters;
+        size_t          to;
+    };
+
+    // instance creation and deletion
+    Automaton();
+
+    // accessing
+    std::vector<size_t> epsilon_closure(size_t state,
+                                        bool   at_start,
+                                        bool   at_end) const;
+    static size_t final_state();
+    static size_t initial_state();
+    size_t num_states() const;
+    const std::vector<Transition>& transitions(size_t state) const;
+
+    // modifying
+    void add_epsilon_transition(size_t from,
+                                size_t to,
+                                Anchor anchor = Anchor::none);
+    size_t add_state();
+    void add_transition(size_t                 from,
+                        const SetOfCharacters& characters,
+                        size_t                 to);
+
+private:
+    // An epsilon transition to state 'to', which may only be taken
+    // where 'anchor' allows.
+    struct EpsilonTransition
+    {
+        EpsilonTransition(size_t to_, Anchor anchor_);
+
+        size_t to;
+        Anchor anchor;
+    };
+
+    // data members
+
+    // 'm_transitions[s]' contains the transitions on characters from
+    // state 's'.
+    std::vector<std::vector<Transition>> m_transitions;
+
+    // 'm_epsilon_transitions[s]' contains the epsilon transitions from
+    // state 's'.
+    std::vector<std::vector<EpsilonTransition>> m_epsilon_transitions;
+};
+
+
+#endif // AUTOMATON_HPP
@@ -29,11 +29,14 @@
 #include "logger.hpp"
 #include "regex_crossword_solver_exception.hpp"
 #include "regex_optimizations.hpp"
+#include "search_options.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <vector>
 
 using namespace std;
@@ -43,12 +46,19 @@ namespace
 {
 
 // accessing
+void   parse_branching_option(const string& branching_option);
+void   parse_estimate_option(const string& estimate_option);
 void   parse_help_option(vector<string>::const_iterator& args_it);
 void   parse_log_option(const string& log_option);
 void   parse_normal_option(vector<string>::const_iterator& args_it);
+void   parse_optim_option(const string& optim_option);
 void   parse_options(vector<string>::const_iterator& args_it,
                      const vector<string>&           args);
+void   parse_portfolio_option(const string& portfolio_option);
+void   parse_seed_option(const string& seed_option);
 void   parse_stop_after_option(const string& stop_after_option);
+void   parse_strategy_option(const string& strategy_option);
+void   parse_threads_option(const string& threads_option);
 string parse_value_option(const string& option, const string& option_specifier);
 void   parse_version_option(vector<string>::const_iterator& args_it);
 
@@ -63,12 +73,20 @@ void check_more_arguments_follow(vector<string>::const_iterator args_it,
                                  const vector<string>&          args);
 void check_no_more_arguments_follow(vector<string>::const_iterator args_it,
                                     const vector<string>&          args);
+void check_thread_options();
 
 // data
 
+const SearchOptions::Branching g_branching_default =
+                                  SearchOptions::Branching::CHARACTERS;
+const bool         g_edit_benchmark_is_requested_default = false;
+// 0 means that no search cost estimate is requested.
+const unsigned int g_estimate_time_budget_ms_default = 0;
 const bool         g_help_is_requested_default = false;
 const string       g_input_filepath_default = "";
 const bool         g_is_verbose_default = false;
+const bool         g_kernel_statistics_are_requested_default = false;
+const bool         g_line_branching_default = false;
 const string       g_log_filepath_default = "";
 // Reasons for setting the default value of
 // 'g_num_solutions_to_find_default' to 2:
@@ -78,27 +96,74 @@ const string       g_log_filepath_default = "";
 // * Limiting the number of solutions to 2 prevents the program from
 //   running for a long time in case there would be many solutions.
 const unsigned int g_num_solutions_to_find_default = 2;
+const size_t       g_num_threads_default = 1;
+const bool         g_optimization_statistics_are_requested_default = false;
 const bool         g_optimize_concatenations_default = true;
+const bool         g_optimize_factorizations_default = true;
 const bool         g_optimize_groups_default = true;
+const bool         g_optimize_repetitions_default = true;
 const bool         g_optimize_unions_default = true;
+const size_t       g_portfolio_size_default = 1;
 const string       g_program_path_default = "";
+const bool         g_search_statistics_are_requested_default = false;
+const unsigned int g_seed_default = 1;
+const SearchOptions::Strategy g_strategy_default =
+                                 SearchOptions::Strategy::DEPTH_FIRST;
 const bool         g_version_is_requested_default = false;
 
+SearchOptions::Branching g_branching = g_branching_default;
+bool         g_edit_benchmark_is_requested =
+                 g_edit_benchmark_is_requested_default;
+unsigned int g_estimate_time_budget_ms = g_estimate_time_budget_ms_default;
 bool         g_help_is_requested = g_help_is_requested_default;
 string       g_input_filepath = g_input_filepath_default;
 bool         g_is_verbose = g_is_verbose_default;
+bool         g_kernel_statistics_are_requested =
+                 g_kernel_statistics_are_requested_default;
+bool         g_line_branching = g_line_branching_default;
 string       g_log_filepath = g_log_filepath_default;
 unsigned int g_num_solutions_to_find = g_num_solutions_to_find_default;
+size_t       g_num_threads = g_num_threads_default;
+bool         g_optimization_statistics_are_requested =
+                 g_optimization_statistics_are_requested_default;
 bool         g_optimize_concatenations = g_optimize_concatenations_default;
+bool         g_optimize_factorizations = g_optimize_factorizations_default;
 bool         g_optimize_groups = g_optimize_groups_default;
+bool         g_optimize_repetitions = g_optimize_repetitions_default;
 bool         g_optimize_unions = g_optimize_unions_default;
+
+// The optimization passes given with '--optim=<passes>', in the order
+// in which they are to be applied, or nothing if that option was not
+// given (in which case the default passes are applied).
+vector<RegexOptimizations::Type> g_optimization_passes;
+size_t       g_portfolio_size = g_portfolio_size_default;
 string       g_program_path = g_program_path_default;
+bool         g_search_statistics_are_requested =
+                 g_search_statistics_are_requested_default;
+unsigned int g_seed = g_seed_default;
+SearchOptions::Strategy g_strategy = g_strategy_default;
 bool         g_version_is_requested = g_version_is_requested_default;
 
 bool         g_command_line_was_parsed = false;
 
 // accessing
 
+// Parse '--branching=<branching>'.
+void
+parse_branching_option(const string& branching_option)
+{
+    const string branching_option_specifier = "--branching";
+
+    const auto value = parse_value_option(branching_option,
+                                          branching_option_specifier);
+
+    if (!SearchOptions::branching_from_name(value, &g_branching))
+    {
+        throw CommandLineException("unknown branching: " +
+                                   Utils::quoted(value));
+    }
+}
+
 // When this function is called, 'args_it' points to the '--help'
 // option.
 //
@@ -122,6 +187,29 @@ parse_log_option(const string& log_option)
     check_log_option();
 }
 
+// Parse '--estimate=<ms>'.
+void
+parse_estimate_option(const string& estimate_option)
+{
+    const string estimate_option_specifier = "--estimate";
+
+    const auto value = parse_value_option(estimate_option,
+                                          estimate_option_specifier);
+
+    if (!Utils::string_to_unsigned(value, &g_estimate_time_budget_ms))
+    {
+        throw CommandLineException("invalid value for " +
+                                   Utils::quoted(estimate_option_specifier));
+    }
+
+    if (g_estimate_time_budget_ms == 0)
+    {
+        throw CommandLineException("value for "                             +
+                                   Utils::quoted(estimate_option_specifier) +
+                                   " must not be 0");
+    }
+}
+
 // When this function is called, 'args_it' points to the next option
 // (which is not '--help', nor '--version').
 //
@@ -134,7 +222,27 @@ parse_normal_option(vector<string>::const_iterator& args_it)
     assert(!is_help_option(option));
     assert(!is_version_option(option));
 
-    if (Utils::starts_with(option, "--log"))
+    if (Utils::starts_with(option, "--branching"))
+    {
+        parse_branching_option(option);
+    }
+    else if (option == "--edit-benchmark")
+    {
+        g_edit_benchmark_is_requested = true;
+    }
+    else if (Utils::starts_with(option, "--estimate"))
+    {
+        parse_estimate_option(option);
+    }
+    else if (option == "--kernel-stats")
+    {
+        g_kernel_statistics_are_requested = true;
+    }
+    else if (option == "--line-branching")
+    {
+        g_line_branching = true;
+    }
+    else if (Utils::starts_with(option, "--log"))
     {
         parse_log_option(option);
     }
@@ -142,6 +250,10 @@ parse_normal_option(vector<string>::const_iterator& args_it)
     {
         g_optimize_concatenations = false;
     }
+    else if (option == "--no-factor-optim")
+    {
+        g_optimize_factorizations = false;
+    }
     else if (option == "--no-group-optim")
     {
         g_optimize_groups = false;
@@ -149,17 +261,51 @@ parse_normal_option(vector<string>::const_iterator& args_it)
     else if (option == "--no-optim")
     {
         g_optimize_concatenations = false;
+        g_optimize_factorizations = false;
         g_optimize_groups = false;
+        g_optimize_repetitions = false;
         g_optimize_unions = false;
     }
+    else if (option == "--no-repeat-optim")
+    {
+        g_optimize_repetitions = false;
+    }
     else if (option == "--no-union-optim")
     {
         g_optimize_unions = false;
     }
+    else if (option == "--optim-stats")
+    {
+        g_optimization_statistics_are_requested = true;
+    }
+    else if (Utils::starts_with(option, "--optim"))
+    {
+        parse_optim_option(option);
+    }
+    else if (Utils::starts_with(option, "--portfolio"))
+    {
+        parse_portfolio_option(option);
+    }
+    else if (option == "--search-stats")
+    {
+        g_search_statistics_are_requested = true;
+    }
+    else if (Utils::starts_with(option, "--seed"))
+    {
+        parse_seed_option(option);
+    }
     else if (Utils::starts_with(option, "--stop-after"))
     {
         parse_stop_after_option(option);
     }
+    else if (Utils::starts_with(option, "--strategy"))
+    {
+        parse_strategy_option(option);
+    }
+    else if (Utils::starts_with(option, "--threads"))
+    {
+        parse_threads_option(option);
+    }
     else if (option == "--verbose" || option == "-v")
     {
         g_is_verbose = true;
@@ -171,6 +317,48 @@ parse_normal_option(vector<string>::const_iterator& args_it)
     }
 }
 
+// Parse '--optim=<passes>', where <passes> is a comma-separated list of
+// optimization pass names.
+void
+parse_optim_option(const string& optim_option)
+{
+    const string optim_option_specifier = "--optim";
+
+    const auto value = parse_value_option(optim_option,
+                                          optim_option_specifier);
+
+    g_optimization_passes.clear();
+
+    istringstream iss(value);
+    string name;
+
+    while (getline(iss, name, ','))
+    {
+        RegexOptimizations::Type type;
+
+        if (!RegexOptimizations::type_from_name(name, &type))
+        {
+            throw CommandLineException("unknown optimization pass: " +
+                                       Utils::quoted(name));
+        }
+
+        if (find(g_optimization_passes.cbegin(),
+                 g_optimization_passes.cend(),
+                 type) != g_optimization_passes.cend())
+        {
+            throw CommandLineException("duplicate optimization pass: " +
+                                       Utils::quoted(name));
+        }
+
+        g_optimization_passes.push_back(type);
+    }
+
+    if (value.back() == ',')
+    {
+        throw CommandLineException("missing optimization pass after ','");
+    }
+}
+
 // When this function is called, 'args_it' points to the first command
 // line argument after the program name.
 //
@@ -201,6 +389,45 @@ parse_options(vector<string>::const_iterator& args_it,
     }
 }
 
+// Parse '--portfolio=<n>'.
+void
+parse_portfolio_option(const string& portfolio_option)
+{
+    const string portfolio_option_specifier = "--portfolio";
+
+    const auto value = parse_value_option(portfolio_option,
+                                          portfolio_option_specifier);
+
+    if (!Utils::string_to_unsigned(value, &g_portfolio_size))
+    {
+        throw CommandLineException("invalid value for " +
+                                   Utils::quoted(portfolio_option_specifier));
+    }
+
+    if (g_portfolio_size == 0)
+    {
+        throw CommandLineException("value for "                              +
+                                   Utils::quoted(portfolio_option_specifier) +
+                                   " must not be 0");
+    }
+}
+
+// Parse '--seed=<n>'.
+void
+parse_seed_option(const string& seed_option)
+{
+    const string seed_option_specifier = "--seed";
+
+    const auto value = parse_value_option(seed_option,
+                                          seed_option_specifier);
+
+    if (!Utils::string_to_unsigned(value, &g_seed))
+    {
+        throw CommandLineException("invalid value for " +
+                                   Utils::quoted(seed_option_specifier));
+    }
+}
+
 // Parse '--stop-after=<n>'.
 void
 parse_stop_after_option(const string& stop_after_option)
@@ -230,6 +457,45 @@ parse_stop_after_option(const string& stop_after_option)
     }
 }
 
+// Parse '--strategy=<strategy>'.
+void
+parse_strategy_option(const string& strategy_option)
+{
+    const string strategy_option_specifier = "--strategy";
+
+    const auto value = parse_value_option(strategy_option,
+                                          strategy_option_specifier);
+
+    if (!SearchOptions::strategy_from_name(value, &g_strategy))
+    {
+        throw CommandLineException("unknown strategy: " +
+                                   Utils::quoted(value));
+    }
+}
+
+// Parse '--threads=<n>'.
+void
+parse_threads_option(const string& threads_option)
+{
+    const string threads_option_specifier = "--threads";
+
+    const auto value = parse_value_option(threads_option,
+                                          threads_option_specifier);
+
+    if (!Utils::string_to_unsigned(value, &g_num_threads))
+    {
+        throw CommandLineException("invalid value for " +
+                                   Utils::quoted(threads_option_specifier));
+    }
+
+    if (g_num_threads == 0)
+    {
+        throw CommandLineException("value for "                            +
+                                   Utils::quoted(threads_option_specifier) +
+                                   " must not be 0");
+    }
+}
+
 // 'option' is of the form '--xxx=yyy', where '--xxx' is the option
 // specifier and 'yyy' is the option value. Return the option value.
 //
@@ -340,6 +606,24 @@ check_no_more_arguments_follow(vector<string>::const_iterator args_it,
     }
 }
 
+// The workers of a portfolio, and the lines constrained with several
+// threads, run in parallel threads, whereas logging is not thread-safe.
+void
+check_thread_options()
+{
+    if (g_portfolio_size > 1 && !g_log_filepath.empty())
+    {
+        throw CommandLineException("options '--log' and '--portfolio' "
+                                   "cannot be combined");
+    }
+
+    if (g_num_threads > 1 && !g_log_filepath.empty())
+    {
+        throw CommandLineException("options '--log' and '--threads' "
+                                   "cannot be combined");
+    }
+}
+
 } // unnamed namespace
 
 
@@ -366,6 +650,15 @@ CommandLine::num_solutions_to_find()
     return g_num_solutions_to_find;
 }
 
+// Return the number of workers with which to solve the grid (see
+// Portfolio), which is 1 unless '--portfolio=<n>' was given.
+size_t
+CommandLine::portfolio_size()
+{
+    assert(g_command_line_was_parsed);
+    return g_portfolio_size;
+}
+
 // 'argc' and 'argv' are the same arguments as those passed to main().
 void
 CommandLine::parse(int argc, const char* const* argv)
@@ -389,6 +682,7 @@ CommandLine::parse(int argc, const char* const* argv)
     }
 
     check_no_more_arguments_follow(args_it, args);
+    check_thread_options();
 
     g_command_line_was_parsed = true;
 }
@@ -400,17 +694,77 @@ CommandLine::regex_optimizations()
 
     auto optimizations = RegexOptimizations::all();
 
+    if (!g_optimization_passes.empty())
+    {
+        optimizations.set_passes(g_optimization_passes);
+    }
+
     using ROT = RegexOptimizations::Type;
 
-    optimizations.set(ROT::CONCATENATIONS, g_optimize_concatenations);
-    optimizations.set(ROT::GROUPS, g_optimize_groups);
-    optimizations.set(ROT::UNIONS, g_optimize_unions);
+    // The '--no-xxx-optim' options take precedence over
+    // '--optim=<passes>'.
+    const struct
+    {
+        ROT  type;
+        bool is_enabled;
+    } enabled_passes[] =
+    {
+        { ROT::CONCATENATIONS, g_optimize_concatenations },
+        { ROT::FACTORIZATIONS, g_optimize_factorizations },
+        { ROT::GROUPS,         g_optimize_groups         },
+        { ROT::REPETITIONS,    g_optimize_repetitions    },
+        { ROT::UNIONS,         g_optimize_unions         }
+    };
+
+    for (const auto& pass : enabled_passes)
+    {
+        if (!pass.is_enabled)
+        {
+            optimizations.set(pass.type, false);
+        }
+    }
 
     return optimizations;
 }
 
+// Return the time, in milliseconds, within which to estimate the cost
+// of searching the grid (see SearchCostEstimate).
+//
+// Precondition:
+// * search_cost_estimate_is_requested()
+unsigned int
+CommandLine::search_cost_estimate_time_budget_ms()
+{
+    assert(g_command_line_was_parsed);
+    assert(search_cost_estimate_is_requested());
+    return g_estimate_time_budget_ms;
+}
+
+SearchOptions
+CommandLine::search_options()
+{
+    assert(g_command_line_was_parsed);
+
+    SearchOptions options;
+    options.set_branching(g_branching);
+    options.set_branches_on_lines(g_line_branching);
+    options.set_num_threads(g_num_threads);
+    options.set_seed(g_seed);
+    options.set_strategy(g_strategy);
+    return options;
+}
+
 // querying
 
+// Return whether the time to answer edits of the regexes of the grid is
+// to be measured (with '--edit-benchmark'), instead of solving the grid.
+bool
+CommandLine::edit_benchmark_is_requested()
+{
+    assert(g_command_line_was_parsed);
+    return g_edit_benchmark_is_requested;
+}
+
 bool
 CommandLine::help_is_requested()
 {
@@ -425,6 +779,36 @@ CommandLine::is_verbose()
     return g_is_verbose;
 }
 
+bool
+CommandLine::kernel_statistics_are_requested()
+{
+    assert(g_command_line_was_parsed);
+    return g_kernel_statistics_are_requested;
+}
+
+bool
+CommandLine::optimization_statistics_are_requested()
+{
+    assert(g_command_line_was_parsed);
+    return g_optimization_statistics_are_requested;
+}
+
+// Return whether the cost of searching the grid is to be estimated
+// (with '--estimate=<ms>'), instead of solving the grid.
+bool
+CommandLine::search_cost_estimate_is_requested()
+{
+    assert(g_command_line_was_parsed);
+    return g_estimate_time_budget_ms != g_estimate_time_budget_ms_default;
+}
+
+bool
+CommandLine::search_statistics_are_requested()
+{
+    assert(g_command_line_was_parsed);
+    return g_search_statistics_are_requested;
+}
+
 bool
 CommandLine::version_is_requested()
 {
@@ -446,6 +830,18 @@ CommandLine::print_usage(ostream& os)
 {
     const string indentation(4, ' ');
 
+    string default_passes;
+
+    for (const auto type : RegexOptimizations::default_order())
+    {
+        if (!default_passes.empty())
+        {
+            default_passes += ',';
+        }
+
+        default_passes += RegexOptimizations::name(type);
+    }
+
     os
     << endl
 
@@ -471,6 +867,73 @@ CommandLine::print_usage(ostream& os)
     << "with <option> one of:" << endl
     << endl
 
+    << indentation
+    << "--branching=<b>    Search a cell by restricting it to each of its"
+    << endl
+
+    << indentation
+    << "                   possible characters, if <b> is 'characters'"
+    << endl
+
+    << indentation
+    << "                   (the default), or to each half of them, if <b>"
+    << endl
+
+    << indentation
+    << "                   is 'halves'." << endl
+
+    << indentation
+    << "--edit-benchmark   Instead of solving the grid, replace each of its"
+    << endl
+
+    << indentation
+    << "                   regexes with '.*' and back, and print the time"
+    << endl
+
+    << indentation
+    << "                   to tell after each edit whether the grid still"
+    << endl
+
+    << indentation
+    << "                   has a unique solution." << endl
+
+    << indentation
+    << "--estimate=<ms>    Instead of solving the grid, estimate in about"
+    << endl
+
+    << indentation
+    << "                   <ms> milliseconds the number of nodes of its"
+    << endl
+
+    << indentation
+    << "                   search tree, and the time to search it, from"
+    << endl
+
+    << indentation
+    << "                   random probes of the tree." << endl
+
+    << indentation
+    << "--kernel-stats     Print the number of regexes constrained by each"
+    << endl
+
+    << indentation
+    << "                   regex kernel, by the generic enumeration of"
+    << endl
+
+    << indentation
+    << "                   regex values, or ignored." << endl
+
+    << indentation
+    << "--line-branching   When a line has few possible strings left, search"
+    << endl
+
+    << indentation
+    << "                   it by restricting it to each of them, rather"
+    << endl
+
+    << indentation
+    << "                   than searching a cell." << endl
+
     << indentation
     << "--log=<log file>   For this option to work, the program must be built"
     << endl
@@ -493,12 +956,29 @@ CommandLine::print_usage(ostream& os)
     << "                   (concatenations are optimized by default)."
     << endl
 
+    << indentation
+    << "--no-factor-optim  Disable factorization optimization" << endl
+
+    << indentation
+    << "                   (common prefixes and suffixes are factored out"
+    << endl
+
+    << indentation
+    << "                   of unions by default)." << endl
+
     << indentation
     << "--no-group-optim   Disable group optimization" << endl
 
     << indentation
     << "                   (groups are optimized by default)." << endl
 
+    << indentation
+    << "--no-repeat-optim  Disable repetition optimization" << endl
+
+    << indentation
+    << "                   (adjacent repetitions are merged by default)."
+    << endl
+
     << indentation
     << "--no-union-optim   Disable union optimization" << endl
 
@@ -509,8 +989,78 @@ CommandLine::print_usage(ostream& os)
     << "--no-optim         Same as" << endl
 
     << indentation
-    << "                   '--no-concat-optim --no-group-optim "
-       "--no-union-optim'." << endl
+    << "                   '--no-concat-optim --no-factor-optim "
+       "--no-group-optim" << endl
+
+    << indentation
+    << "                   --no-repeat-optim --no-union-optim'." << endl
+
+    << indentation
+    << "--optim=<passes>   Apply only the optimization passes listed in"
+    << endl
+
+    << indentation
+    << "                   <passes>, separated by commas, in that order."
+    << endl
+
+    << indentation
+    << "                   The passes, in their default order, are:" << endl
+
+    << indentation
+    << "                   " << default_passes << '.' << endl
+
+    << indentation
+    << "--optim-stats      Print, for each optimization pass, the number"
+    << endl
+
+    << indentation
+    << "                   of regex nodes and of enumeration steps before"
+    << endl
+
+    << indentation
+    << "                   and after the pass." << endl
+
+    << indentation
+    << "--portfolio=<n>    Solve the grid with <n> configurations of the"
+    << endl
+
+    << indentation
+    << "                   solver in parallel (varying the strategy, the"
+    << endl
+
+    << indentation
+    << "                   seed, the optimizations and the branching), and"
+    << endl
+
+    << indentation
+    << "                   keep the result of the first one which finishes."
+    << endl
+
+    << indentation
+    << "                   Cannot be combined with '--log'." << endl
+
+    << indentation
+    << "--search-stats     Print the number of nodes of the search tree, and"
+    << endl
+
+    << indentation
+    << "                   the number of lookups and hits of the table of"
+    << endl
+
+    << indentation
+    << "                   grid states known to have no solutions." << endl
+
+    << indentation
+    << "--seed=<n>         Seed the random order of the branches of the"
+    << endl
+
+    << indentation
+    << "                   search with <n>, when it restarts (see"
+    << endl
+
+    << indentation
+    << "                   '--strategy'). Default is " << g_seed_default
+    << '.' << endl
 
     << indentation
     << "--stop-after=<n>   Stop after <n> solutions have been found."
@@ -524,6 +1074,52 @@ CommandLine::print_usage(ostream& os)
     << "                   Default is " << g_num_solutions_to_find_default
     << '.' << endl
 
+    << indentation
+    << "--strategy=<s>     Explore the search tree depth-first, if <s> is"
+    << endl
+
+    << indentation
+    << "                   'depth-first' (the default), by increasing"
+    << endl
+
+    << indentation
+    << "                   numbers of discrepancies from the preferred"
+    << endl
+
+    << indentation
+    << "                   branches, if <s> is 'discrepancy', or with"
+    << endl
+
+    << indentation
+    << "                   restarts in random order after a number of"
+    << endl
+
+    << indentation
+    << "                   nodes which grows geometrically, if <s> is"
+    << endl
+
+    << indentation
+    << "                   'geometric-restarts', or following the Luby"
+    << endl
+
+    << indentation
+    << "                   sequence, if <s> is 'luby-restarts'." << endl
+
+    << indentation
+    << "--threads=<n>      Constrain the lines of the grid in rounds, each"
+    << endl
+
+    << indentation
+    << "                   round with up to <n> threads. This speeds up"
+    << endl
+
+    << indentation
+    << "                   large grids. Default is " << g_num_threads_default
+    << '.' << endl
+
+    << indentation
+    << "                   Cannot be combined with '--log'." << endl
+
     << indentation
     << "-v                 Same as '--verbose'." << endl
 
@@ -565,15 +1161,32 @@ CommandLine::print_version(ostream& os)
 void
 CommandLine::reset_to_defaults()
 {
+    g_branching = g_branching_default;
+    g_edit_benchmark_is_requested = g_edit_benchmark_is_requested_default;
+    g_estimate_time_budget_ms = g_estimate_time_budget_ms_default;
     g_help_is_requested = g_help_is_requested_default;
     g_input_filepath = g_input_filepath_default;
     g_is_verbose = g_is_verbose_default;
+    g_kernel_statistics_are_requested =
+        g_kernel_statistics_are_requested_default;
+    g_line_branching = g_line_branching_default;
     g_log_filepath = g_log_filepath_default;
     g_num_solutions_to_find = g_num_solutions_to_find_default;
+    g_num_threads = g_num_threads_default;
+    g_optimization_passes.clear();
+    g_optimization_statistics_are_requested =
+        g_optimization_statistics_are_requested_default;
     g_optimize_concatenations = g_optimize_concatenations_default;
+    g_optimize_factorizations = g_optimize_factorizations_default;
     g_optimize_groups = g_optimize_groups_default;
+    g_optimize_repetitions = g_optimize_repetitions_default;
     g_optimize_unions = g_optimize_unions_default;
+    g_portfolio_size = g_portfolio_size_default;
     g_program_path = g_program_path_default;
+    g_search_statistics_are_requested =
+        g_search_statistics_are_requested_default;
+    g_seed = g_seed_default;
+    g_strategy = g_strategy_default;
     g_version_is_requested = g_version_is_requested_default;
 
     g_command_line_was_parsed = false;
@@ -27,10 +27,12 @@
 #ifndef COMMAND_LINE_HPP
 #define COMMAND_LINE_HPP
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 
 class RegexOptimizations;
+class SearchOptions;
 
 
 // This module provides facilities for handling the command line.
@@ -56,11 +58,19 @@ std::string        input_filepath();
 std::string        log_filepath();
 unsigned int       num_solutions_to_find();
 void               parse(int argc, const char* const* argv);
+size_t             portfolio_size();
 RegexOptimizations regex_optimizations();
+unsigned int       search_cost_estimate_time_budget_ms();
+SearchOptions      search_options();
 
 // querying
+bool edit_benchmark_is_requested();
 bool help_is_requested();
 bool is_verbose();
+bool kernel_statistics_are_requested();
+bool optimization_statistics_are_requested();
+bool search_cost_estimate_is_requested();
+bool search_statistics_are_requested();
 bool version_is_requested();
 
 // printing
@@ -0,0 +1,252 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "compact_table.hpp"
+
+#include "alphabet.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace std;
+
+
+namespace
+{
+
+const size_t num_bits_per_element = 64;
+
+// Return the number of set bits in 'bits'.
+size_t
+num_set_bits(uint64_t bits)
+{
+    size_t result = 0;
+
+    while (bits != 0)
+    {
+        bits &= bits - 1;
+        ++result;
+    }
+
+    return result;
+}
+
+} // unnamed namespace
+
+
+// instance creation and deletion
+
+// Precondition:
+// * all the elements of 'strings' are 'string_length' characters long,
+//   and contain only characters of the alphabet
+CompactTable::CompactTable(const vector<string>& strings,
+                           size_t                string_length) :
+  m_string_length(string_length),
+  m_alphabet_size(Alphabet::characters_as_string().size()),
+  m_num_bits_per_bitset((strings.size() + num_bits_per_element - 1) /
+                        num_bits_per_element),
+  m_valid_strings(m_num_bits_per_bitset, 0)
+{
+    auto supports_ = make_shared<vector<Bits>>(
+                       m_string_length * m_alphabet_size *
+                       m_num_bits_per_bitset,
+                       0);
+
+    for (size_t i = 0; i != strings.size(); ++i)
+    {
+        const auto& string_ = strings[i];
+        assert(string_.size() == m_string_length);
+
+        const auto element_index = i / num_bits_per_element;
+        const auto bit = Bits(1) << (i % num_bits_per_element);
+
+        for (size_t pos = 0; pos != m_string_length; ++pos)
+        {
+            const auto character_index =
+                Alphabet::index_of_character(string_[pos]);
+            const auto supports_index =
+                (pos * m_alphabet_size + character_index) *
+                m_num_bits_per_bitset;
+
+            (*supports_)[supports_index + element_index] |= bit;
+        }
+
+        m_valid_strings[element_index] |= bit;
+    }
+
+    m_supports = move(supports_);
+}
+
+// accessing
+
+size_t
+CompactTable::num_valid_strings() const
+{
+    return accumulate(m_valid_strings.cbegin(),
+                      m_valid_strings.cend(),
+                      size_t(0),
+                      [](size_t sum, Bits bits)
+                      {
+                          return sum + num_set_bits(bits);
+                      });
+}
+
+// Return the strings of this table which are still valid, in the order
+// in which the table was given them.
+vector<string>
+CompactTable::valid_strings() const
+{
+    vector<string> result;
+    const auto num_strings = m_num_bits_per_bitset * num_bits_per_element;
+
+    for (size_t i = 0; i != num_strings; ++i)
+    {
+        const auto element_index = i / num_bits_per_element;
+        const auto bit = Bits(1) << (i % num_bits_per_element);
+
+        if ((m_valid_strings[element_index] & bit) == 0)
+        {
+            continue;
+        }
+
+        string string_(m_string_length, ' ');
+
+        for (size_t pos = 0; pos != m_string_length; ++pos)
+        {
+            for (size_t c = 0; c != m_alphabet_size; ++c)
+            {
+                if ((supports(pos, c)[element_index] & bit) != 0)
+                {
+                    string_[pos] = Alphabet::character_at(c);
+                    break;
+                }
+            }
+        }
+
+        result.push_back(string_);
+    }
+
+    return result;
+}
+
+// Return the first element of the bitset of the supports of the
+// character with index 'character_index' at position 'pos'.
+const CompactTable::Bits*
+CompactTable::supports(size_t pos, size_t character_index) const
+{
+    return m_supports->data() +
+           (pos * m_alphabet_size + character_index) * m_num_bits_per_bitset;
+}
+
+// querying
+
+// Return whether one of the supports of the character with index
+// 'character_index' at position 'pos' is still valid.
+bool
+CompactTable::has_a_valid_support(size_t pos, size_t character_index) const
+{
+    const auto supports_ = supports(pos, character_index);
+
+    for (size_t i = 0; i != m_num_bits_per_bitset; ++i)
+    {
+        if ((m_valid_strings[i] & supports_[i]) != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// modifying
+
+// Constrain 'constraint' with the strings of this table which are
+// still valid, and return the result. See the class comment.
+//
+// Precondition:
+// * 'constraint' is tighter than or equal to the last constraint that
+//   this table was given, if any
+Constraint
+CompactTable::constrain(const Constraint& constraint)
+{
+    assert(constraint.size() == m_string_length);
+    assert(m_last_constraint.empty() ||
+           constraint.is_tighter_than_or_equal_to(m_last_constraint));
+
+    for (size_t pos = 0; pos != m_string_length; ++pos)
+    {
+        if (m_last_constraint.empty() ||
+            constraint[pos] != m_last_constraint[pos])
+        {
+            remove_strings_which_do_not_fit(pos, constraint[pos]);
+        }
+    }
+
+    m_last_constraint = constraint;
+
+    auto result = Constraint::none(m_string_length);
+
+    for (size_t pos = 0; pos != m_string_length; ++pos)
+    {
+        for (const auto c : constraint[pos])
+        {
+            const auto character_index = Alphabet::index_of_character(c);
+
+            if (has_a_valid_support(pos, character_index))
+            {
+                result[pos].add_character_at(character_index);
+            }
+        }
+    }
+
+    return result;
+}
+
+// Remove from the valid strings those which do not have one of
+// 'characters' at position 'pos'.
+void
+CompactTable::remove_strings_which_do_not_fit(size_t                 pos,
+                                              const SetOfCharacters& characters)
+{
+    vector<Bits> strings_which_fit(m_num_bits_per_bitset, 0);
+
+    for (const auto c : characters)
+    {
+        const auto supports_ =
+            supports(pos, Alphabet::index_of_character(c));
+
+        for (size_t i = 0; i != m_num_bits_per_bitset; ++i)
+        {
+            strings_which_fit[i] |= supports_[i];
+        }
+    }
+
+    for (size_t i = 0; i != m_num_bits_per_bitset; ++i)
+    {
+        m_valid_strings[i] &= strings_which_fit[i];
+    }
+}
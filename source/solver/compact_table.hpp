@@ -0,0 +1,118 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef COMPACT_TABLE_HPP
+#define COMPACT_TABLE_HPP
+
+#include "constraint.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// An instance of this class constrains a line with an explicit list of
+// the strings which the line may contain (a "table"), instead of with
+// the regexes of the line.
+//
+// The table keeps track of the strings which are still valid (i.e.,
+// which fit in all the constraints that the table was given so far) in
+// a bitset. For each position and each character, it precomputes the
+// bitset of the strings which have that character at that position
+// (the "supports" of that character at that position). Constraining
+// then only needs bitwise operations:
+// 1. for each position whose possible characters changed since the
+//    last time, the strings which do not fit in them are removed from
+//    the valid strings
+// 2. a character is kept at a position iff one of its supports at that
+//    position is still valid
+//
+// For example, with strings { "AB", "BA", "BB" } and constraint
+// { "AB", "B" }, "BA" is removed, and the new constraint is
+// { "AB", "B" }. With constraint { "A", "B" } afterwards, "BB" is
+// removed too, and the new constraint is { "A", "B" }.
+//
+// This is exact: the new constraint contains a character at a position
+// iff a valid string has that character at that position. The
+// constraints that a table is given must get tighter over time, as is
+// the case for the constraints of a line while a grid is solved.
+//
+// Copies of a table share their supports, which never change.
+class CompactTable final
+{
+public:
+    // instance creation and deletion
+    CompactTable(const std::vector<std::string>& strings,
+                 size_t                          string_length);
+
+    // accessing
+    size_t num_valid_strings() const;
+    std::vector<std::string> valid_strings() const;
+
+    // modifying
+    Constraint constrain(const Constraint& constraint);
+
+private:
+    typedef std::uint64_t Bits;
+
+    // accessing
+    const Bits* supports(size_t pos, size_t character_index) const;
+
+    // querying
+    bool has_a_valid_support(size_t pos, size_t character_index) const;
+
+    // modifying
+    void remove_strings_which_do_not_fit(size_t                 pos,
+                                         const SetOfCharacters& characters);
+
+    // data members
+
+    // The length of the strings of this table.
+    size_t m_string_length;
+
+    // The number of characters in the alphabet.
+    size_t m_alphabet_size;
+
+    // The number of elements of type 'Bits' in each bitset of strings.
+    size_t m_num_bits_per_bitset;
+
+    // The bitsets of the supports of each character at each position,
+    // one after the other: the bitset of the character with index 'c'
+    // (see Alphabet::index_of_character()) at position 'pos' starts at
+    // index ('pos' * m_alphabet_size + 'c') * m_num_bits_per_bitset.
+    std::shared_ptr<const std::vector<Bits>> m_supports;
+
+    // The bitset of the strings which are still valid.
+    std::vector<Bits> m_valid_strings;
+
+    // The last constraint that this table was given, or an empty
+    // constraint if there is none.
+    Constraint m_last_constraint;
+};
+
+
+#endif // COMPACT_TABLE_HPP
@@ -102,6 +102,16 @@ Constraint::size() const
     return m_constraint.size();
 }
 
+// Precondition:
+// * 'lhs' and 'rhs' have the same size
+Constraint
+operator&(const Constraint& lhs, const Constraint& rhs)
+{
+    auto result = lhs;
+    result &= rhs;
+    return result;
+}
+
 // Precondition:
 // * 'lhs' and 'rhs' have the same size
 Constraint
@@ -161,6 +171,27 @@ Constraint::is_possible() const
     return !is_impossible();
 }
 
+// Return whether 's' satisfies this constraint (see the class comment).
+//
+// Precondition:
+// * 's' has the same size as this constraint
+bool
+Constraint::is_satisfied_by(const string& s) const
+{
+    const auto size_ = size();
+    assert(size_ == s.size());
+
+    for (size_t i = 0; i != size_; ++i)
+    {
+        if (!m_constraint[i].contains(s[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // Return whether, for each index i in [0, size()), the element at index
 // i of this constraint is a (not necessarily strict) subset of 'rhs[i]'.
 //
@@ -185,6 +216,22 @@ Constraint::is_tighter_than_or_equal_to(const Constraint& rhs) const
 
 // modifying
 
+// Precondition:
+// * 'rhs' has the same size as this constraint
+Constraint&
+Constraint::operator&=(const Constraint& rhs)
+{
+    const auto size_ = size();
+    assert(size_ == rhs.size());
+
+    for (size_t i = 0; i != size_; ++i)
+    {
+        (*this)[i] &= rhs[i];
+    }
+
+    return *this;
+}
+
 // Precondition:
 // * 'rhs' has the same size as this constraint
 Constraint&
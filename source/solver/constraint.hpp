@@ -72,9 +72,11 @@ public:
     bool empty() const;
     bool is_impossible() const;
     bool is_possible() const;
+    bool is_satisfied_by(const std::string& s) const;
     bool is_tighter_than_or_equal_to(const Constraint& rhs) const;
 
     // modifying
+    Constraint& operator&=(const Constraint& rhs);
     Constraint& operator|=(const Constraint& rhs);
 
 private:
@@ -91,6 +93,7 @@ bool operator!=(const Constraint& lhs, const Constraint& rhs);
 
 bool operator<(const Constraint& lhs, const Constraint& rhs);
 
+Constraint operator&(const Constraint& lhs, const Constraint& rhs);
 Constraint operator|(const Constraint& lhs, const Constraint& rhs);
 
 
@@ -30,12 +30,26 @@
 #include "grid_cell.hpp"
 #include "grid_line.hpp"
 #include "logger.hpp"
+#include "regex_kernel.hpp"
+#include "search_cost_estimate.hpp"
+#include "search_statistics.hpp"
+#include "transposition_table.hpp"
 #include "utils.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <exception>
 #include <iterator>
+#include <limits>
 #include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 using namespace std;
 
@@ -43,6 +57,33 @@ using namespace std;
 namespace
 {
 
+// The value of Grid::m_num_discrepancies_left when the discrepancies
+// are not limited.
+const size_t unlimited_num_discrepancies = numeric_limits<size_t>::max();
+
+// Return the 'i'th element (counting from 1) of the Luby sequence
+// 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+size_t
+luby(size_t i)
+{
+    assert(i != 0);
+
+    // Find 'k' such that 2 ^ ('k' - 1) <= 'i' < 2 ^ 'k'.
+    size_t k = 1;
+
+    while ((size_t(1) << k) <= i)
+    {
+        ++k;
+    }
+
+    if (i == (size_t(1) << k) - 1)
+    {
+        return size_t(1) << (k - 1);
+    }
+
+    return luby(i - (size_t(1) << (k - 1)) + 1);
+}
+
 // Return the first lines that appear in a report corresponding to the
 // given arguments.
 vector<string>
@@ -99,13 +140,52 @@ log_solutions(const vector<unique_ptr<Grid>>& solutions,
 } // unnamed namespace
 
 
+// The state of a run of the search (see solve()), which the grid to
+// solve and the grids copied from it while searching share.
+struct Grid::SearchRun
+{
+    // The number of nodes (see SearchStatistics) beyond which this run
+    // is cut off, and the number of nodes which it has explored so far.
+    size_t max_num_nodes = numeric_limits<size_t>::max();
+    size_t num_nodes = 0;
+
+    // The number of nodes which this run did not explore because of its
+    // limits (of nodes, or of discrepancies - see
+    // SearchOptions::Strategy). If there are none, this run explored
+    // the whole search tree.
+    size_t num_cut_off_nodes = 0;
+
+    // The number of solutions which this run did not report because an
+    // earlier run did.
+    size_t num_skipped_solutions = 0;
+
+    // The source of the random order of the branches, when the search
+    // restarts.
+    mt19937 random_engine;
+
+    // The hashes (see Grid::hash()) of the solutions reported so far,
+    // when the search restarts.
+    unordered_set<uint64_t> solution_hashes;
+
+    // A flag which another thread sets to stop the search (see
+    // Grid::solve()), or nullptr if the search cannot be cancelled.
+    const atomic<bool>* is_cancelled = nullptr;
+};
+
 // instance creation and deletion
 
-Grid::Grid()
+Grid::Grid() :
+  m_num_discrepancies_left(unlimited_num_discrepancies)
 {
 }
 
-Grid::Grid(const Grid& /*rhs*/)
+Grid::Grid(const Grid& rhs) :
+  m_transposition_table(rhs.m_transposition_table),
+  m_search_options(rhs.m_search_options),
+  m_search_statistics(rhs.m_search_statistics),
+  m_search_run(rhs.m_search_run),
+  m_num_discrepancies_left(rhs.m_num_discrepancies_left),
+  m_component(rhs.m_component)
 {
     // copy_lines_and_cells() (indirectly) calls virtual functions, so
     // copy_lines_and_cells() is not called here. Instead, it is called
@@ -176,9 +256,26 @@ Grid::construct_grid(const vector<vector<string>>& regex_groups)
     build_grid_structure();
     build_regexes(regex_groups);
     set_alphabet();
+    ignore_universal_regexes();
+    specialize_regexes();
     initialize_cells();
 }
 
+// Ignore the regexes which match all the strings of the length of their
+// line over the alphabet of this grid, since they constrain nothing.
+void
+Grid::ignore_universal_regexes() const
+{
+    for (auto line : all_lines())
+    {
+        line->ignore_universal_regexes();
+    }
+}
+
+// Set the possible characters of each cell to those which each of the
+// regexes of its lines, considered alone, allows at its position, so
+// that the first constraining round does not start from the full
+// alphabet.
 void
 Grid::initialize_cells()
 {
@@ -186,6 +283,11 @@ Grid::initialize_cells()
     {
         cell->set_possible_characters_to_all_characters();
     }
+
+    for (auto line : all_lines())
+    {
+        line->narrow_cells_with_profiles();
+    }
 }
 
 shared_ptr<GridCell>
@@ -229,8 +331,45 @@ Grid::set_alphabet() const
     Alphabet::set(explicit_regex_characters());
 }
 
+// Specialize the regexes for the length of their line.
+void
+Grid::specialize_regexes() const
+{
+    for (auto line : all_lines())
+    {
+        line->specialize_regexes();
+    }
+}
+
 // copying
 
+// Return a copy of this grid with which to search the branch with index
+// 'branch_index' of this grid, or nullptr if the limits of the current
+// run (see SearchRun) forbid it. Any branch but the first one is a
+// discrepancy (see SearchOptions::Strategy).
+unique_ptr<Grid>
+Grid::clone_for_branch(size_t branch_index)
+{
+    const auto is_discrepancy = branch_index != 0;
+
+    if (m_search_run->num_nodes == m_search_run->max_num_nodes ||
+        (is_discrepancy && m_num_discrepancies_left == 0))
+    {
+        ++m_search_run->num_cut_off_nodes;
+        return nullptr;
+    }
+
+    auto result = clone();
+
+    if (is_discrepancy &&
+        m_num_discrepancies_left != unlimited_num_discrepancies)
+    {
+        --result->m_num_discrepancies_left;
+    }
+
+    return result;
+}
+
 // Copy to this grid the cell in 'source_grid' at coordinates 'x' and 'y'.
 void
 Grid::copy_cell(const Grid& source_grid, size_t x, size_t y)
@@ -330,6 +469,86 @@ Grid::all_lines() const
     return result;
 }
 
+// Return the sets of characters which the search restricts 'cell' to,
+// one per branch, in the order in which they are to be searched (see
+// SearchOptions::Branching), which is random if the search restarts
+// (see SearchOptions::Strategy).
+vector<SetOfCharacters>
+Grid::branches(const GridCell& cell) const
+{
+    const auto possible_characters = cell.possible_characters();
+    vector<SetOfCharacters> result;
+
+    if (m_search_options->branching() ==
+        SearchOptions::Branching::CHARACTERS)
+    {
+        for (auto c : possible_characters)
+        {
+            result.emplace_back(c);
+        }
+    }
+    else
+    {
+        result = halves(cell);
+    }
+
+    if (m_search_options->restarts())
+    {
+        shuffle(result.begin(),
+                result.end(),
+                m_search_run->random_engine);
+    }
+
+    return result;
+}
+
+// Return the two halves of the possible characters of 'cell' which the
+// search restricts it to, when it branches by halves (see branches()):
+// the characters with the most supports in the lines through 'cell'
+// (see GridLine::num_supports()) come first, so that the first half is
+// the likeliest to contain a solution, and that constraining the second
+// half - which is searched only if more solutions are to be found - has
+// the most chances to refute it at once.
+vector<SetOfCharacters>
+Grid::halves(const GridCell& cell) const
+{
+    const auto possible_characters = cell.possible_characters();
+    const auto lines = lines_through(cell.coordinates());
+    vector<pair<size_t, char>> supported_characters;
+
+    for (auto c : possible_characters)
+    {
+        const auto num_supports =
+            accumulate(lines.cbegin(),
+                       lines.cend(),
+                       size_t(0),
+                       [&cell, c](size_t sum, const GridLine* line)
+                       {
+                           return sum + line->num_supports(cell, c);
+                       });
+        supported_characters.emplace_back(num_supports, c);
+    }
+
+    stable_sort(supported_characters.begin(),
+                supported_characters.end(),
+                [](const pair<size_t, char>& lhs,
+                   const pair<size_t, char>& rhs)
+                {
+                    return lhs.first > rhs.first;
+                });
+
+    const auto half_size = (supported_characters.size() + 1) / 2;
+    vector<SetOfCharacters> result(2);
+
+    for (size_t i = 0; i != supported_characters.size(); ++i)
+    {
+        result[i < half_size ? 0 : 1] |=
+            SetOfCharacters(supported_characters[i].second);
+    }
+
+    return result;
+}
+
 shared_ptr<GridCell>
 Grid::cell(const vector<size_t>& coordinates) const
 {
@@ -344,13 +563,34 @@ Grid::cell(const vector<size_t>& coordinates) const
     return row->cell(index_on_row);
 }
 
+// Return the cells which solving this grid is to solve: all its cells,
+// unless solving is restricted to a component (see
+// search_components()).
+vector<shared_ptr<GridCell>>
+Grid::cells_to_solve() const
+{
+    if (m_component == nullptr)
+    {
+        return all_cells();
+    }
+
+    vector<shared_ptr<GridCell>> result;
+
+    for (const auto& coordinates : *m_component)
+    {
+        result.push_back(cell(coordinates));
+    }
+
+    return result;
+}
+
 // Precondition:
-// * there is at least one cell in this grid which can be searched
-//   (i.e., one cell with several possible characters)
+// * there is at least one cell to solve (see cells_to_solve()) which can
+//   be searched (i.e., one cell with several possible characters)
 shared_ptr<GridCell>
 Grid::cell_to_search() const
 {
-    const auto cells = all_cells();
+    const auto cells = cells_to_solve();
 
     vector<shared_ptr<GridCell>> cells_that_can_be_searched;
     copy_if(cells.cbegin(),
@@ -376,6 +616,91 @@ Grid::cell_to_search() const
                         });
 }
 
+// Return the coordinates of the unsolved cells to solve (see
+// cells_to_solve()), grouped into independent components: two unsolved
+// cells are in the same component iff they are connected through lines
+// which contain unsolved cells of both. No line contains unsolved cells
+// of two components, so the components can be solved independently.
+vector<vector<vector<size_t>>>
+Grid::independent_components() const
+{
+    // The index of each unsolved cell to solve in 'unsolved_cells'.
+    const auto cells = cells_to_solve();
+    unordered_map<const GridCell*, size_t> unsolved_cell_indices;
+    vector<shared_ptr<GridCell>> unsolved_cells;
+
+    unsolved_cell_indices.reserve(cells.size());
+
+    for (const auto& cell_ : cells)
+    {
+        if (!cell_->is_solved())
+        {
+            unsolved_cell_indices.emplace(cell_.get(), unsolved_cells.size());
+            unsolved_cells.push_back(cell_);
+        }
+    }
+
+    // Merge the unsolved cells of each line, with a union-find
+    // structure where 'parents[i]' is the parent of unsolved cell 'i'.
+    vector<size_t> parents(unsolved_cells.size());
+    iota(parents.begin(), parents.end(), size_t(0));
+
+    const auto root = [&parents](size_t i)
+                      {
+                          while (parents[i] != i)
+                          {
+                              parents[i] = parents[parents[i]];
+                              i = parents[i];
+                          }
+                          return i;
+                      };
+
+    for (auto line : all_lines())
+    {
+        const size_t no_cell = unsolved_cells.size();
+        auto first_cell = no_cell;
+
+        for (const auto& cell_ : line->cells())
+        {
+            const auto it = unsolved_cell_indices.find(cell_.get());
+
+            if (it == unsolved_cell_indices.cend())
+            {
+                continue;
+            }
+
+            if (first_cell == no_cell)
+            {
+                first_cell = it->second;
+            }
+            else
+            {
+                parents[root(it->second)] = root(first_cell);
+            }
+        }
+    }
+
+    // Group the cells by root, in the order of their first cells.
+    const auto no_component = unsolved_cells.size();
+    vector<size_t> component_indices(unsolved_cells.size(), no_component);
+    vector<vector<vector<size_t>>> result;
+
+    for (size_t i = 0; i != unsolved_cells.size(); ++i)
+    {
+        auto& component_index = component_indices[root(i)];
+
+        if (component_index == no_component)
+        {
+            component_index = result.size();
+            result.emplace_back();
+        }
+
+        result[component_index].push_back(unsolved_cells[i]->coordinates());
+    }
+
+    return result;
+}
+
 // Return the characters which appear explicitly in the regexes of this
 // grid.
 string
@@ -392,6 +717,21 @@ Grid::explicit_regex_characters() const
                       });
 }
 
+// Return the Zobrist hash (see ZobristHash) of the possible characters
+// of the cells of this grid. Each cell belongs to exactly one row, so
+// this is the exclusive or of the hashes of the rows.
+uint64_t
+Grid::hash() const
+{
+    return accumulate(rows().cbegin(),
+                      rows().cend(),
+                      uint64_t(0),
+                      [](uint64_t sum, const unique_ptr<GridLine>& row)
+                      {
+                          return sum ^ row->hash();
+                      });
+}
+
 GridLine*
 Grid::line_at(size_t line_direction, size_t line_index) const
 {
@@ -402,6 +742,75 @@ Grid::line_at(size_t line_direction, size_t line_index) const
     return lines_for_direction[line_index].get();
 }
 
+// Return the line which the search is to branch on, rather than on a
+// cell, if the search branches on lines (see SearchOptions), and set
+// 'candidates' to the strings that this line may still contain. Return
+// nullptr if there is no such line.
+//
+// The line is one whose candidates (see GridLine::get_candidates()) are
+// the fewest, provided that they are few, and that it has at least two
+// unsolved cells to solve (see cells_to_solve()). Assigning a whole
+// line at once then makes the search tree shallower than searching its
+// cells one at a time. The candidates are in a random order if the
+// search restarts (see SearchOptions::Strategy).
+GridLine*
+Grid::line_to_search(vector<string>& candidates) const
+{
+    // Above this number of candidates, branching on a line would have
+    // a wider fan-out than is worth its depth.
+    const size_t max_num_candidates = 8;
+
+    candidates.clear();
+
+    if (!m_search_options->branches_on_lines())
+    {
+        return nullptr;
+    }
+
+    unordered_set<const GridCell*> cells_to_solve_;
+
+    for (const auto& cell_ : cells_to_solve())
+    {
+        cells_to_solve_.insert(cell_.get());
+    }
+
+    GridLine* result = nullptr;
+    vector<string> line_candidates;
+
+    for (const auto line : all_lines())
+    {
+        const auto& cells = line->cells();
+        const auto num_unsolved_cells_to_solve =
+            count_if(cells.cbegin(),
+                     cells.cend(),
+                     [&cells_to_solve_](const shared_ptr<GridCell>& cell_)
+                     {
+                         return !cell_->is_solved() &&
+                                cells_to_solve_.count(cell_.get()) != 0;
+                     });
+
+        const auto max_num_line_candidates =
+            result == nullptr ? max_num_candidates : candidates.size() - 1;
+
+        if (num_unsolved_cells_to_solve >= 2 &&
+            line->get_candidates(line_candidates, max_num_line_candidates) &&
+            line_candidates.size() >= 2)
+        {
+            result = line;
+            candidates.swap(line_candidates);
+        }
+    }
+
+    if (result != nullptr && m_search_options->restarts())
+    {
+        shuffle(candidates.begin(),
+                candidates.end(),
+                m_search_run->random_engine);
+    }
+
+    return result;
+}
+
 // Return the lines that go through the cell at 'coordinates'.
 vector<GridLine*>
 Grid::lines_through(const vector<size_t>& coordinates) const
@@ -462,10 +871,11 @@ Grid::rows() const
 
 // querying
 
+// Return whether the cells to solve (see cells_to_solve()) are solved.
 bool
 Grid::is_solved() const
 {
-    const auto cells = all_cells();
+    const auto cells = cells_to_solve();
 
     return all_of(cells.cbegin(),
                   cells.cend(),
@@ -475,6 +885,15 @@ Grid::is_solved() const
                   });
 }
 
+// Return whether another thread cancelled the search of this grid (see
+// solve()).
+bool
+Grid::search_is_cancelled() const
+{
+    return m_search_run->is_cancelled != nullptr &&
+           *m_search_run->is_cancelled;
+}
+
 // printing
 
 // Log the result of the constrain that was done to this grid. The
@@ -505,6 +924,58 @@ Grid::print() const
     return do_print(verbose);
 }
 
+// Return, for each regex kernel, the number of regexes of this grid
+// for which that kernel constrains lines, followed by the number of
+// regexes for which lines are constrained by enumerating the regex
+// values, and by the number of ignored regexes.
+vector<string>
+Grid::print_kernel_statistics() const
+{
+    vector<string> kernel_names;
+
+    for (auto line : all_lines())
+    {
+        line->get_kernel_names(kernel_names);
+    }
+
+    auto names = RegexKernel::names();
+    names.push_back("generic");
+    names.push_back("ignored");
+
+    const size_t name_width = 20;
+    vector<string> result;
+
+    for (const auto& name : names)
+    {
+        const auto num_regexes = count(kernel_names.cbegin(),
+                                       kernel_names.cend(),
+                                       name);
+        result.push_back(name + string(name_width - name.size(), ' ') +
+                         Utils::to_string(num_regexes));
+    }
+
+    return result;
+}
+
+// Return the statistics of the last call to solve(): the numbers of
+// nodes of its search tree (see SearchStatistics), followed by the
+// statistics of its transposition table (see TranspositionTable).
+vector<string>
+Grid::print_search_statistics() const
+{
+    if (m_search_statistics == nullptr)
+    {
+        return {};
+    }
+
+    auto result = m_search_statistics->print();
+    const auto table_statistics = m_transposition_table->print_statistics();
+    result.insert(result.end(),
+                  table_statistics.cbegin(),
+                  table_statistics.cend());
+    return result;
+}
+
 vector<string>
 Grid::print_verbose() const
 {
@@ -570,10 +1041,130 @@ Grid::constrain()
     return result;
 }
 
+// Same as constrain_no_log(), except that the lines are constrained in
+// rounds, with up to 'num_threads' threads.
+//
+// In each round, all the lines which need constraining (see
+// GridLine::needs_constraining()) compute their new constraints from
+// the same state of the cells, concurrently. Then, the new constraints
+// are applied to the cells, one line at a time, in a fixed order, so
+// that the result does not depend on the threads. The rounds go on
+// until no line needs constraining.
+//
+// Constraining a line with its regexes is much costlier than applying
+// the result, so that the rounds of large grids, with many lines to
+// constrain, take less time with several threads.
+bool
+Grid::constrain_in_rounds(size_t num_threads)
+{
+    // A thread is started only for this many lines to constrain or
+    // more, so that it pays off.
+    const size_t min_num_lines_per_thread = 8;
+
+    const auto lines = all_lines();
+
+    for (;;)
+    {
+        vector<GridLine*> lines_to_constrain;
+
+        copy_if(lines.cbegin(),
+                lines.cend(),
+                back_inserter(lines_to_constrain),
+                [](const GridLine* line)
+                {
+                    return line->needs_constraining();
+                });
+
+        const auto num_lines_to_constrain = lines_to_constrain.size();
+
+        if (num_lines_to_constrain == 0)
+        {
+            return true;
+        }
+
+        vector<uint64_t> hashes_of_cells;
+
+        for (const auto line : lines_to_constrain)
+        {
+            hashes_of_cells.push_back(line->hash());
+        }
+
+        const auto num_threads_ =
+            max<size_t>(1, min(num_threads,
+                               num_lines_to_constrain /
+                               min_num_lines_per_thread));
+        vector<Constraint> new_constraints(num_lines_to_constrain);
+        vector<exception_ptr> exceptions(num_threads_);
+
+        // The thread with index 'thread_index' constrains every
+        // 'num_threads_'th line, starting from the one with that index.
+        const auto compute_constraints =
+            [&lines_to_constrain, &new_constraints, &exceptions,
+             num_lines_to_constrain, num_threads_](size_t thread_index)
+            {
+                try
+                {
+                    for (auto i = thread_index;
+                         i < num_lines_to_constrain;
+                         i += num_threads_)
+                    {
+                        new_constraints[i] =
+                            lines_to_constrain[i]->compute_constraint();
+                    }
+                }
+                catch (...)
+                {
+                    exceptions[thread_index] = current_exception();
+                }
+            };
+
+        vector<thread> threads;
+
+        for (size_t thread_index = 1;
+             thread_index != num_threads_;
+             ++thread_index)
+        {
+            threads.emplace_back(compute_constraints, thread_index);
+        }
+
+        compute_constraints(0);
+
+        for (auto& thread_ : threads)
+        {
+            thread_.join();
+        }
+
+        for (const auto& exception : exceptions)
+        {
+            if (exception != nullptr)
+            {
+                rethrow_exception(exception);
+            }
+        }
+
+        for (size_t i = 0; i != num_lines_to_constrain; ++i)
+        {
+            const auto line = lines_to_constrain[i];
+
+            line->apply_constraint(new_constraints[i], hashes_of_cells[i]);
+
+            if (line->has_impossible_constraint())
+            {
+                return false;
+            }
+        }
+    }
+}
+
 // Same as constrain(), except that this version does not (directly) log.
 bool
 Grid::constrain_no_log()
 {
+    if (m_search_options->num_threads() > 1)
+    {
+        return constrain_in_rounds(m_search_options->num_threads());
+    }
+
     const auto lines = all_lines();
     const auto num_lines = lines.size();
     size_t num_consecutive_lines_constrained_without_changes = 0;
@@ -607,6 +1198,62 @@ Grid::constrain_no_log()
     return true;
 }
 
+// Estimate the cost of searching this grid exhaustively with 'options'
+// (see SearchCostEstimate), by probing its search tree at random for
+// about 'time_budget_ms' milliseconds, and at least twice - unless the
+// constrained grid is solved or inconsistent, in which case its search
+// tree is its root alone, which is probed only once.
+//
+// The probes branch like the search does (see search_grid()), but
+// they cannot know which nodes the transposition table would prune, so
+// the estimate is that of the search without it - an upper bound.
+SearchCostEstimate
+Grid::estimate_search_cost(double               time_budget_ms,
+                           const SearchOptions& options)
+{
+    using Clock = chrono::steady_clock;
+
+    const auto elapsed_ms = [](Clock::time_point start)
+                            {
+                                return chrono::duration<double, milli>(
+                                         Clock::now() - start).count();
+                            };
+
+    const auto start = Clock::now();
+
+    m_search_options = make_shared<const SearchOptions>(options);
+    m_search_statistics = make_shared<SearchStatistics>();
+    m_search_run = make_shared<SearchRun>();
+    m_search_run->random_engine.seed(options.seed());
+
+    // The probes all start from the constrained root, which is thus
+    // constrained only once.
+    const auto root_is_consistent = constrain_no_log();
+    const auto time_constraining_root_ms = elapsed_ms(start);
+
+    SearchCostEstimate result;
+
+    if (!root_is_consistent || is_solved())
+    {
+        result.add_probe(1.0, 1, time_constraining_root_ms);
+        return result;
+    }
+
+    while (result.num_probes() < 2 || elapsed_ms(start) < time_budget_ms)
+    {
+        const auto probe_start = Clock::now();
+        size_t num_nodes_probed = 0;
+        const auto num_nodes_estimate =
+            clone()->probe_search_tree(num_nodes_probed);
+
+        result.add_probe(num_nodes_estimate,
+                         num_nodes_probed,
+                         elapsed_ms(probe_start));
+    }
+
+    return result;
+}
+
 // Optimize the regexes of this grid according to 'optimizations'.
 void
 Grid::optimize(const RegexOptimizations& optimizations)
@@ -617,6 +1264,88 @@ Grid::optimize(const RegexOptimizations& optimizations)
     }
 }
 
+// Same as optimize(const RegexOptimizations&), except that the effect
+// of each optimization pass is added to 'statistics'.
+void
+Grid::optimize(const RegexOptimizations&    optimizations,
+               RegexOptimizationStatistics& statistics)
+{
+    for (auto line : all_lines())
+    {
+        line->optimize(optimizations, statistics);
+    }
+}
+
+// Follow a random path from this grid down its search tree, to a leaf,
+// and return the estimated number of nodes of its search tree (see
+// SearchCostEstimate). Add to 'num_nodes_probed' the number of nodes on
+// the path.
+//
+// A node with several independent components is searched component by
+// component (see search_components()), so its tree is estimated as the
+// sum of the trees of its components, each of them probed once.
+double
+Grid::probe_search_tree(size_t& num_nodes_probed)
+{
+    ++num_nodes_probed;
+
+    if (!constrain() || is_solved())
+    {
+        return 1.0;
+    }
+
+    const auto components = independent_components();
+
+    if (components.size() > 1)
+    {
+        auto result = 1.0;
+
+        for (const auto& component : components)
+        {
+            auto copy_of_this_grid = clone();
+            copy_of_this_grid->m_component =
+                make_shared<const vector<vector<size_t>>>(component);
+            result += copy_of_this_grid->probe_search_tree(num_nodes_probed);
+        }
+
+        return result;
+    }
+
+    auto copy_of_this_grid = clone();
+    size_t num_branches = 0;
+    vector<string> candidates;
+
+    if (const auto line = line_to_search(candidates))
+    {
+        num_branches = candidates.size();
+        const auto& candidate =
+            candidates[uniform_int_distribution<size_t>(
+                         0, num_branches - 1)(m_search_run->random_engine)];
+        const auto& cells = line->cells();
+
+        for (size_t i = 0; i != cells.size(); ++i)
+        {
+            copy_of_this_grid->cell(cells[i]->coordinates())
+                             ->set_possible_characters(candidate[i]);
+        }
+    }
+    else
+    {
+        const auto cell = cell_to_search();
+        const auto branches_ = branches(*cell);
+        num_branches = branches_.size();
+        const auto& characters =
+            branches_[uniform_int_distribution<size_t>(
+                        0, num_branches - 1)(m_search_run->random_engine)];
+
+        copy_of_this_grid->cell(cell->coordinates())
+                         ->set_possible_characters(characters);
+    }
+
+    return 1.0 + static_cast<double>(num_branches) *
+                 copy_of_this_grid->probe_search_tree(num_nodes_probed);
+}
+
 // Return the solved grid(s) obtained from this grid by searching
 // 'cell'.
 vector<unique_ptr<Grid>>
@@ -624,17 +1353,19 @@ Grid::search_cell(const GridCell& cell,
                   unsigned int&   num_remaining_solutions_to_find)
 {
     vector<unique_ptr<Grid>> solutions;
+    const auto branches_ = branches(cell);
 
-    for (auto possible_character : cell.possible_characters())
+    for (size_t i = 0; i != branches_.size(); ++i)
     {
-        auto solutions_for_character =
+        auto solutions_for_branch =
             search_cell(cell,
-                        possible_character,
+                        branches_[i],
+                        i,
                         num_remaining_solutions_to_find);
 
         solutions.insert(end(solutions),
-                         make_move_iterator(solutions_for_character.begin()),
-                         make_move_iterator(solutions_for_character.end()));
+                         make_move_iterator(solutions_for_branch.begin()),
+                         make_move_iterator(solutions_for_branch.end()));
 
         if (num_remaining_solutions_to_find == 0)
         {
@@ -646,23 +1377,32 @@ Grid::search_cell(const GridCell& cell,
 }
 
 // Return the solved grid(s) obtained from this grid by constraining
-// 'cell' to contain 'c'.
+// 'cell' to contain one of 'characters', which is the branch with index
+// 'branch_index' of 'cell' (see branches()).
 vector<unique_ptr<Grid>>
-Grid::search_cell(const GridCell& cell,
-                  char            c,
-                  unsigned int&   num_remaining_solutions_to_find)
+Grid::search_cell(const GridCell&        cell,
+                  const SetOfCharacters& characters,
+                  size_t                 branch_index,
+                  unsigned int&          num_remaining_solutions_to_find)
 {
+    auto copy_of_this_grid = clone_for_branch(branch_index);
+
+    if (copy_of_this_grid == nullptr)
+    {
+        return {};
+    }
+
     LOG_BLANK_LINE();
     LOG("searching cell:");
     INCREMENT_LOGGING_INDENTATION_LEVEL();
 
-    auto copy_of_this_grid = clone();
     auto cell_in_copy = copy_of_this_grid->cell(cell.coordinates());
 
     LOG(cell_in_copy->to_string() + ": " +
-        cell_in_copy->possible_characters_as_string() + " => " + c);
+        cell_in_copy->possible_characters_as_string() + " => " +
+        characters.to_string());
 
-    cell_in_copy->set_possible_characters(c);
+    cell_in_copy->set_possible_characters(characters);
     auto result =
         copy_of_this_grid->solve_no_log(num_remaining_solutions_to_find);
 
@@ -670,6 +1410,118 @@ Grid::search_cell(const GridCell& cell,
     return result;
 }
 
+// Return the solved grid(s) obtained from this grid by solving each of
+// 'components' (see independent_components()) separately, and by
+// combining their solutions.
+//
+// Searching the components jointly would explore the product of their
+// search trees, whereas searching them separately explores their sum.
+vector<unique_ptr<Grid>>
+Grid::search_components(const vector<vector<vector<size_t>>>& components,
+                        unsigned int& num_remaining_solutions_to_find)
+{
+    assert(num_remaining_solutions_to_find != 0);
+
+    // The combinations of solutions of the components are enumerated
+    // like an odometer whose rightmost digit turns fastest (see below),
+    // so the first 'n' combinations only use the first ceil(n / p)
+    // solutions of a component, where 'p' is the number of
+    // combinations of the components after it. The components are thus
+    // solved from the last one, each for no more solutions than
+    // needed. When the search restarts, the combinations which an
+    // earlier run reported are skipped, so there are that many more to
+    // find.
+    const size_t num_combinations_to_find =
+        num_remaining_solutions_to_find +
+        (m_component == nullptr ? m_search_run->solution_hashes.size() : 0);
+    vector<vector<unique_ptr<Grid>>> component_solutions(components.size());
+    size_t num_later_combinations = 1;
+
+    for (auto i = components.size(); i != 0; --i)
+    {
+        const auto& component = components[i - 1];
+
+        LOG("searching component of " + Utils::to_string(component.size()) +
+            " cell(s)");
+
+        auto copy_of_this_grid = clone();
+        copy_of_this_grid->m_component =
+            make_shared<const vector<vector<size_t>>>(component);
+        copy_of_this_grid->m_num_discrepancies_left =
+            unlimited_num_discrepancies;
+        auto num_solutions_to_find = static_cast<unsigned int>(
+            min<size_t>((num_combinations_to_find +
+                         num_later_combinations - 1) /
+                        num_later_combinations,
+                        numeric_limits<unsigned int>::max()));
+        auto solutions =
+            copy_of_this_grid->solve_no_log(num_solutions_to_find);
+
+        if (solutions.empty())
+        {
+            return {};
+        }
+
+        num_later_combinations = min(num_combinations_to_find,
+                                     num_later_combinations *
+                                     solutions.size());
+        component_solutions[i - 1] = move(solutions);
+    }
+
+    // Combine the solutions of the components, like an odometer whose
+    // rightmost digit turns fastest.
+    vector<unique_ptr<Grid>> result;
+    vector<size_t> indices(components.size(), 0);
+
+    while (num_remaining_solutions_to_find != 0)
+    {
+        auto solution = clone();
+
+        for (size_t i = 0; i != components.size(); ++i)
+        {
+            const auto& component_solution =
+                *component_solutions[i][indices[i]];
+
+            for (const auto& coordinates : components[i])
+            {
+                solution->cell(coordinates)->set_possible_characters(
+                    component_solution.cell(coordinates)
+                                      ->possible_characters());
+            }
+        }
+
+        if (m_component == nullptr && solution_was_reported(*solution))
+        {
+            ++m_search_run->num_skipped_solutions;
+        }
+        else
+        {
+            if (m_component == nullptr)
+            {
+                Utils::print_verbose_message(cout, "found a solution");
+            }
+
+            result.push_back(move(solution));
+            --num_remaining_solutions_to_find;
+        }
+
+        auto i = components.size();
+
+        while (i != 0 && ++indices[i - 1] == component_solutions[i - 1].size())
+        {
+            indices[i - 1] = 0;
+            --i;
+        }
+
+        if (i == 0)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
 vector<unique_ptr<Grid>>
 Grid::search_grid(unsigned int& num_remaining_solutions_to_find)
 {
@@ -678,20 +1530,126 @@ Grid::search_grid(unsigned int& num_remaining_solutions_to_find)
     INCREMENT_LOGGING_INDENTATION_LEVEL();
     LOG(print_verbose());
 
-    auto result = search_cell(*cell_to_search(),
-                              num_remaining_solutions_to_find);
+    const auto components = independent_components();
+
+    vector<string> candidates;
+    vector<unique_ptr<Grid>> result;
+
+    if (components.size() > 1)
+    {
+        // The components are searched without limiting their
+        // discrepancies (see search_components()), so they are searched
+        // only by the run which reaches this grid with no discrepancies
+        // left (see SearchOptions::Strategy); the earlier runs already
+        // did.
+        if (m_num_discrepancies_left != 0 &&
+            m_num_discrepancies_left != unlimited_num_discrepancies)
+        {
+            ++m_search_run->num_skipped_solutions;
+        }
+        else
+        {
+            result = search_components(components,
+                                       num_remaining_solutions_to_find);
+        }
+    }
+    else if (const auto line = line_to_search(candidates))
+    {
+        result = search_line(*line,
+                             candidates,
+                             num_remaining_solutions_to_find);
+    }
+    else
+    {
+        result = search_cell(*cell_to_search(),
+                             num_remaining_solutions_to_find);
+    }
 
     DECREMENT_LOGGING_INDENTATION_LEVEL();
     return result;
 }
 
+// Return the solved grid(s) obtained from this grid by constraining
+// 'line' to contain each of 'candidates' in turn.
+vector<unique_ptr<Grid>>
+Grid::search_line(const GridLine&       line,
+                  const vector<string>& candidates,
+                  unsigned int&         num_remaining_solutions_to_find)
+{
+    vector<unique_ptr<Grid>> solutions;
+
+    for (size_t j = 0; j != candidates.size(); ++j)
+    {
+        auto copy_of_this_grid = clone_for_branch(j);
+
+        if (copy_of_this_grid == nullptr)
+        {
+            continue;
+        }
+
+        LOG_BLANK_LINE();
+        LOG("searching line:");
+        INCREMENT_LOGGING_INDENTATION_LEVEL();
+
+        const auto& candidate = candidates[j];
+        const auto& cells = line.cells();
+
+        LOG(line.regexes_as_string() + ": " + candidate);
+
+        for (size_t i = 0; i != cells.size(); ++i)
+        {
+            copy_of_this_grid->cell(cells[i]->coordinates())
+                             ->set_possible_characters(candidate[i]);
+        }
+
+        auto solutions_for_candidate =
+            copy_of_this_grid->solve_no_log(num_remaining_solutions_to_find);
+
+        DECREMENT_LOGGING_INDENTATION_LEVEL();
+
+        solutions.insert(end(solutions),
+                         make_move_iterator(solutions_for_candidate.begin()),
+                         make_move_iterator(solutions_for_candidate.end()));
+
+        if (num_remaining_solutions_to_find == 0)
+        {
+            return solutions;
+        }
+    }
+
+    return solutions;
+}
+
+// Return whether an earlier run of the search (see
+// SearchOptions::Strategy) reported 'solution'. If not, remember that
+// 'solution' is reported, so that later runs skip it.
+//
+// Only restarts may reach a solution which an earlier run reported: the
+// limited discrepancy search skips these by itself.
+bool
+Grid::solution_was_reported(const Grid& solution)
+{
+    if (!m_search_options->restarts())
+    {
+        return false;
+    }
+
+    return !m_search_run->solution_hashes.insert(solution.hash()).second;
+}
+
 // Solve this grid. Return no more than 'num_solutions_to_find'
 // solutions.
 //
+// If 'is_cancelled' is not nullptr, the search stops as soon as another
+// thread sets '*is_cancelled', and then returns the solutions found so
+// far, which may be incomplete.
+//
 // Precondition:
 // * num_solutions_to_find != 0
 vector<unique_ptr<Grid>>
-Grid::solve(unsigned int num_solutions_to_find)
+Grid::solve(unsigned int         num_solutions_to_find,
+            const SearchOptions& options,
+            const atomic<bool>*  is_cancelled)
 {
     assert(num_solutions_to_find != 0);
 
@@ -701,8 +1659,35 @@ Grid::solve(unsigned int num_solutions_to_find)
     LOG(print_verbose());
     DECREMENT_LOGGING_INDENTATION_LEVEL();
 
+    m_transposition_table = make_shared<TranspositionTable>();
+    m_search_options = make_shared<const SearchOptions>(options);
+    m_search_statistics = make_shared<SearchStatistics>();
+    m_search_run = make_shared<SearchRun>();
+    m_search_run->random_engine.seed(options.seed());
+    m_search_run->is_cancelled = is_cancelled;
+
     auto num_remaining_solutions_to_find = num_solutions_to_find;
-    auto solutions = solve_no_log(num_remaining_solutions_to_find);
+    vector<unique_ptr<Grid>> solutions;
+
+    // Each run but the last one is cut off by its limits (see
+    // start_run()), and the last one searches the whole tree, unless
+    // enough solutions are found before.
+    for (size_t run_index = 0; ; ++run_index)
+    {
+        start_run(run_index);
+        auto solutions_of_run = solve_no_log(num_remaining_solutions_to_find);
+
+        solutions.insert(end(solutions),
+                         make_move_iterator(solutions_of_run.begin()),
+                         make_move_iterator(solutions_of_run.end()));
+
+        if (num_remaining_solutions_to_find == 0 ||
+            m_search_run->num_cut_off_nodes == 0 ||
+            search_is_cancelled())
+        {
+            break;
+        }
+    }
 
     log_solutions(solutions, num_solutions_to_find);
 
@@ -713,15 +1698,40 @@ Grid::solve(unsigned int num_solutions_to_find)
 vector<unique_ptr<Grid>>
 Grid::solve_no_log(unsigned int& num_remaining_solutions_to_find)
 {
+    if (m_search_run->num_nodes == m_search_run->max_num_nodes ||
+        search_is_cancelled())
+    {
+        ++m_search_run->num_cut_off_nodes;
+        return {};
+    }
+
+    ++m_search_run->num_nodes;
+    m_search_statistics->count_node();
+
     if (!constrain())
     {
         // No solutions.
+        m_search_statistics->count_dead_end();
         return {};
     }
 
     if (is_solved())
     {
-        Utils::print_verbose_message(cout, "found a solution");
+        // A solution which this run reaches with discrepancies left was
+        // reached by an earlier run, with fewer discrepancies (see
+        // SearchOptions::Strategy).
+        if ((m_num_discrepancies_left != 0 &&
+             m_num_discrepancies_left != unlimited_num_discrepancies) ||
+            (m_component == nullptr && solution_was_reported(*this)))
+        {
+            ++m_search_run->num_skipped_solutions;
+            return {};
+        }
+
+        Utils::print_verbose_message(cout,
+                                     m_component == nullptr
+                                     ? "found a solution"
+                                     : "found a solution of a component");
 
         vector<unique_ptr<Grid>> result;
 
@@ -733,5 +1743,74 @@ Grid::solve_no_log(unsigned int& num_remaining_solutions_to_find)
         return result;
     }
 
-    return search_grid(num_remaining_solutions_to_find);
+    // Different branches of the search may lead to the same state
+    // after constraining. A state whose search found no solutions was
+    // searched exhaustively (the search only stops early once enough
+    // solutions are found), so it need not be searched again - unless
+    // the limits of the current run (see SearchRun) cut off part of it,
+    // or it had solutions which an earlier run reported.
+    const auto hash_ = hash();
+
+    if (m_transposition_table != nullptr &&
+        m_transposition_table->is_known_failure(hash_))
+    {
+        return {};
+    }
+
+    const auto num_cut_off_nodes = m_search_run->num_cut_off_nodes;
+    const auto num_skipped_solutions = m_search_run->num_skipped_solutions;
+    auto result = search_grid(num_remaining_solutions_to_find);
+
+    if (result.empty() && m_transposition_table != nullptr &&
+        m_search_run->num_cut_off_nodes == num_cut_off_nodes &&
+        m_search_run->num_skipped_solutions == num_skipped_solutions)
+    {
+        m_transposition_table->record_failure(hash_);
+    }
+
+    return result;
+}
+
+// Prepare the run with index 'run_index' (counting from 0) of the search
+// of this grid, by setting its limits (see SearchOptions::Strategy).
+void
+Grid::start_run(size_t run_index)
+{
+    // The number of nodes which the first run of restarts may explore.
+    const size_t num_nodes_per_restart_unit = 64;
+
+    m_search_run->num_nodes = 0;
+    m_search_run->num_cut_off_nodes = 0;
+    m_search_statistics->count_run();
+
+    switch (m_search_options->strategy())
+    {
+    case SearchOptions::Strategy::DEPTH_FIRST:
+        break;
+
+    case SearchOptions::Strategy::LIMITED_DISCREPANCY:
+        m_num_discrepancies_left = run_index;
+        break;
+
+    case SearchOptions::Strategy::GEOMETRIC_RESTARTS:
+    {
+        const auto max_num_nodes =
+            num_nodes_per_restart_unit * pow(1.5, run_index);
+
+        m_search_run->max_num_nodes =
+            max_num_nodes < static_cast<double>(numeric_limits<size_t>::max())
+            ? static_cast<size_t>(max_num_nodes)
+            : numeric_limits<size_t>::max();
+        break;
+    }
+
+    case SearchOptions::Strategy::LUBY_RESTARTS:
+        m_search_run->max_num_nodes =
+            num_nodes_per_restart_unit * luby(run_index + 1);
+        break;
+
+    default:
+        assert(false);
+        break;
+    }
 }
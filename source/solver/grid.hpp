@@ -27,7 +27,12 @@
 #ifndef GRID_HPP
 #define GRID_HPP
 
+#include "search_cost_estimate.hpp"
+#include "search_options.hpp"
+
 #include <gtest/gtest_prod.h>
+#include <atomic>
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -35,7 +40,11 @@
 
 class GridCell;
 class GridLine;
+class RegexOptimizationStatistics;
 class RegexOptimizations;
+class SearchStatistics;
+class SetOfCharacters;
+class TranspositionTable;
 
 
 // An abstract class (the superclass of concrete classes
@@ -51,19 +60,29 @@ public:
     virtual ~Grid() = 0;
 
     // accessing
+    std::uint64_t hash() const;
     GridLine* row_at(size_t row_index) const;
 
     // printing
     std::vector<std::string> print() const;
+    std::vector<std::string> print_kernel_statistics() const;
+    std::vector<std::string> print_search_statistics() const;
     std::vector<std::string> print_verbose() const;
     static void report_solutions(
         const std::vector<std::unique_ptr<Grid>>& solutions,
         unsigned int                              num_solutions_to_find);
 
     // modifying
+    SearchCostEstimate estimate_search_cost(
+                         double               time_budget_ms,
+                         const SearchOptions& options = SearchOptions());
     void optimize(const RegexOptimizations& optimizations);
+    void optimize(const RegexOptimizations&    optimizations,
+                  RegexOptimizationStatistics& statistics);
     std::vector<std::unique_ptr<Grid>> solve(
-                                         unsigned int num_solutions_to_find);
+                       unsigned int             num_solutions_to_find,
+                       const SearchOptions&     options = SearchOptions(),
+                       const std::atomic<bool>* is_cancelled = nullptr);
 
 protected:
     // instance creation and deletion
@@ -84,6 +103,13 @@ protected:
     const std::vector<std::unique_ptr<GridLine>>& rows() const;
 
 private:
+    struct SearchRun;
+
+    // GridEditor constrains grids as their cells are edited, and
+    // RegexEditor as their regexes are.
+    friend class GridEditor;
+    friend class RegexEditor;
+
     FRIEND_TEST(GridReaderTest, hexagonal);
     FRIEND_TEST(GridReaderTest, rectangular);
     FRIEND_TEST(GridReaderTest, dos_format);
@@ -97,6 +123,7 @@ private:
     void build_lines();
     void build_regexes(
            const std::vector<std::vector<std::string>>& regex_groups) const;
+    void ignore_universal_regexes() const;
     void initialize_cells();
     std::shared_ptr<GridCell>
         make_cell(const std::vector<size_t>& coordinates);
@@ -106,9 +133,11 @@ private:
                     const std::vector<size_t>& coordinates,
                     size_t                     line_direction);
     void set_alphabet() const;
+    void specialize_regexes() const;
 
     // copying
     virtual std::unique_ptr<Grid> clone() const = 0;
+    std::unique_ptr<Grid> clone_for_branch(size_t branch_index);
     void copy_cell(const Grid& source_grid, size_t x, size_t y);
     void copy_cells(const Grid& source_grid);
     void copy_lines(const Grid& source_grid);
@@ -117,14 +146,20 @@ private:
 
     // accessing
     std::vector<std::shared_ptr<GridCell>> all_cells() const;
+    std::vector<SetOfCharacters> branches(const GridCell& cell) const;
+    std::vector<std::shared_ptr<GridCell>> cells_to_solve() const;
     std::vector<GridLine*> all_lines() const;
     virtual size_t begin_y(size_t x) const = 0;
     std::shared_ptr<GridCell>
         cell(const std::vector<size_t>& coordinates) const;
     std::shared_ptr<GridCell> cell_to_search() const;
     virtual std::vector<size_t> coordinates(size_t x, size_t y) const = 0;
+    std::vector<std::vector<std::vector<size_t>>>
+        independent_components() const;
     virtual size_t end_y(size_t x) const = 0;
     std::string explicit_regex_characters() const;
+    std::vector<SetOfCharacters> halves(const GridCell& cell) const;
+    GridLine* line_to_search(std::vector<std::string>& candidates) const;
     virtual size_t index_of_cell_on_line(size_t coordinate,
                                          size_t next_coordinate) const = 0;
     std::vector<GridLine*> lines_through(
@@ -134,6 +169,7 @@ private:
 
     // querying
     bool is_solved() const;
+    bool search_is_cancelled() const;
 
     // printing
     virtual std::vector<std::string> do_print(bool verbose) const = 0;
@@ -141,18 +177,31 @@ private:
 
     // modifying
     bool constrain();
+    bool constrain_in_rounds(size_t num_threads);
     bool constrain_no_log();
+    double probe_search_tree(size_t& num_nodes_probed);
     std::vector<std::unique_ptr<Grid>>
          search_cell(const GridCell& cell,
                      unsigned int&   num_remaining_solutions_to_find);
     std::vector<std::unique_ptr<Grid>>
-         search_cell(const GridCell& cell,
-                     char            c,
-                     unsigned int&   num_remaining_solutions_to_find);
+         search_cell(const GridCell&        cell,
+                     const SetOfCharacters& characters,
+                     size_t                 branch_index,
+                     unsigned int&          num_remaining_solutions_to_find);
+    std::vector<std::unique_ptr<Grid>>
+         search_components(
+           const std::vector<std::vector<std::vector<size_t>>>& components,
+           unsigned int& num_remaining_solutions_to_find);
     std::vector<std::unique_ptr<Grid>>
          search_grid(unsigned int& num_remaining_solutions_to_find);
+    std::vector<std::unique_ptr<Grid>>
+         search_line(const GridLine&                 line,
+                     const std::vector<std::string>& candidates,
+                     unsigned int& num_remaining_solutions_to_find);
+    bool solution_was_reported(const Grid& solution);
     std::vector<std::unique_ptr<Grid>>
          solve_no_log(unsigned int& num_remaining_solutions_to_find);
+    void start_run(size_t run_index);
 
     // data members
 
@@ -163,6 +212,32 @@ private:
     // hexagonal grid), and each of these elements contains the lines of
     // that direction.
     std::vector<std::vector<std::unique_ptr<GridLine>>> m_lines_per_direction;
+
+    // The states known to have no solutions, which this grid and the
+    // grids copied from it while searching share (see solve_no_log()),
+    // or nullptr if this grid has not been solved yet.
+    std::shared_ptr<TranspositionTable> m_transposition_table;
+
+    // The options of the search, and its statistics, which this grid
+    // and the grids copied from it while searching share, or nullptr
+    // if this grid has not been solved yet.
+    std::shared_ptr<const SearchOptions> m_search_options;
+    std::shared_ptr<SearchStatistics> m_search_statistics;
+
+    // The current run of the search (see SearchRun), which this grid
+    // and the grids copied from it while searching share, or nullptr if
+    // this grid has not been solved yet.
+    std::shared_ptr<SearchRun> m_search_run;
+
+    // The number of discrepancies (see SearchOptions::Strategy) which
+    // the search of this grid may still make, or the maximum value of
+    // 'size_t' if they are not limited.
+    size_t m_num_discrepancies_left;
+
+    // The coordinates of the cells which solving this grid is
+    // restricted to (see search_components()), or nullptr if all the
+    // cells are to be solved.
+    std::shared_ptr<const std::vector<std::vector<size_t>>> m_component;
 };
 
 std::ostream& operator<<(std::ostream& os, const Grid& grid);
@@ -27,7 +27,9 @@
 #include "grid_cell.hpp"
 
 #include "alphabet.hpp"
+#include "grid_line.hpp"
 #include "utils.hpp"
+#include "zobrist_hash.hpp"
 
 using namespace std;
 
@@ -35,10 +37,26 @@ using namespace std;
 // instance creation and deletion
 
 GridCell::GridCell(const vector<size_t>& coordinates) :
-  m_coordinates(coordinates)
+  m_coordinates(coordinates),
+  m_hash_seed(ZobristHash::cell_seed(coordinates))
 {
 }
 
+GridCell::GridCell(const GridCell& rhs) :
+  m_coordinates(rhs.m_coordinates),
+  m_possible_characters(rhs.m_possible_characters),
+  m_hash_seed(rhs.m_hash_seed),
+  m_hash(rhs.m_hash)
+{
+}
+
+// Add 'line' to the lines which go through this cell.
+void
+GridCell::add_line(GridLine* line)
+{
+    m_lines.push_back(line);
+}
+
 // accessing
 
 const vector<size_t>&
@@ -47,6 +65,12 @@ GridCell::coordinates() const
     return m_coordinates;
 }
 
+uint64_t
+GridCell::hash() const
+{
+    return m_hash;
+}
+
 size_t
 GridCell::num_possible_characters() const
 {
@@ -102,10 +126,25 @@ GridCell::to_string() const
 
 // modifying
 
+// Set the characters that this cell may contain, and update the hashes
+// of this cell and of its lines accordingly.
 void
 GridCell::set_possible_characters(const SetOfCharacters& possible_characters)
 {
+    const auto hash_change = ZobristHash::hash_change(m_hash_seed,
+                                                      m_possible_characters,
+                                                      possible_characters);
     m_possible_characters = possible_characters;
+
+    if (hash_change != 0)
+    {
+        m_hash ^= hash_change;
+
+        for (const auto line : m_lines)
+        {
+            line->update_hash(hash_change);
+        }
+    }
 }
 
 void
@@ -29,8 +29,11 @@
 
 #include "set_of_characters.hpp"
 
+#include <cstdint>
 #include <vector>
 
+class GridLine;
+
 
 // An instance of this class represents a cell in a grid.
 //
@@ -44,10 +47,12 @@ class GridCell final
 public:
     // instance creation and deletion
     explicit GridCell(const std::vector<size_t>& coordinates);
-    GridCell(const GridCell& /*rhs*/) = default;
+    GridCell(const GridCell& rhs);
+    void add_line(GridLine* line);
 
     // accessing
     const std::vector<size_t>& coordinates() const;
+    std::uint64_t hash() const;
     size_t num_possible_characters() const;
     SetOfCharacters possible_characters() const;
     std::string possible_characters_as_string() const;
@@ -73,6 +78,18 @@ private:
 
     // The characters that this cell may contain.
     SetOfCharacters m_possible_characters;
+
+    // The seed of the Zobrist keys of this cell (see
+    // ZobristHash::cell_seed()).
+    std::uint64_t m_hash_seed;
+
+    // The Zobrist hash of 'm_possible_characters' (see ZobristHash).
+    std::uint64_t m_hash = 0;
+
+    // The lines which go through this cell, whose hashes are updated
+    // when the possible characters of this cell change. A copy of a
+    // cell does not belong to any line until it is added to some.
+    std::vector<GridLine*> m_lines;
 };
 
 
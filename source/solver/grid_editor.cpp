@@ -0,0 +1,243 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "grid_editor.hpp"
+
+#include "alphabet.hpp"
+#include "grid.hpp"
+#include "grid_cell.hpp"
+
+#include <cassert>
+#include <utility>
+
+using namespace std;
+
+
+// instance creation and deletion
+
+// Constrain 'grid', whose regexes should already be optimized (see
+// Grid::optimize()), with 'options' (see SearchOptions::num_threads()).
+GridEditor::GridEditor(unique_ptr<Grid> grid, const SearchOptions& options) :
+  m_root(move(grid)),
+  m_root_is_consistent(false),
+  m_is_consistent(false)
+{
+    assert(m_root != nullptr);
+
+    m_root->m_search_options = make_shared<const SearchOptions>(options);
+    m_root_is_consistent = m_root->constrain();
+    m_grid = m_root->clone();
+    m_is_consistent = m_root_is_consistent;
+}
+
+GridEditor::~GridEditor() = default;
+
+// accessing
+
+// Return the possible characters of all the cells of the current grid,
+// in the order of Grid::all_cells().
+vector<SetOfCharacters>
+GridEditor::all_possible_characters() const
+{
+    vector<SetOfCharacters> result;
+
+    for (const auto& cell : m_grid->all_cells())
+    {
+        result.push_back(cell->possible_characters());
+    }
+
+    return result;
+}
+
+// Return the coordinates of the cells whose possible characters the
+// last edit changed - including the edited cell itself, unless it was
+// already narrowed down to the assigned character. Return nothing if
+// the grid is not consistent.
+const vector<vector<size_t>>&
+GridEditor::changed_cells() const
+{
+    return m_changed_cells;
+}
+
+// Return the grid as constrained with the current assignments.
+const Grid&
+GridEditor::grid() const
+{
+    return *m_grid;
+}
+
+// Return the characters which the cell at 'coordinates' may still
+// contain.
+SetOfCharacters
+GridEditor::possible_characters(const vector<size_t>& coordinates) const
+{
+    return m_grid->cell(coordinates)->possible_characters();
+}
+
+// querying
+
+// Return whether the grid may still be solved with the current
+// assignments, as far as constraining can tell. A consistent grid may
+// still have no solutions, which only a search (see Grid::solve()) can
+// tell.
+bool
+GridEditor::is_consistent() const
+{
+    return m_is_consistent;
+}
+
+// Return whether each cell of the grid contains a single possible
+// character, which constraining proved to be compatible with all the
+// regexes.
+bool
+GridEditor::is_solved() const
+{
+    return m_is_consistent && m_grid->is_solved();
+}
+
+// modifying
+
+// Assign 'c' to the cell at 'coordinates', replacing the character
+// assigned to it before, if any. Return whether the grid is consistent
+// (see is_consistent()) afterwards.
+bool
+GridEditor::assign(const vector<size_t>& coordinates, char c)
+{
+    const auto it = m_assignments.find(coordinates);
+
+    if (it != m_assignments.end() && it->second == c)
+    {
+        m_changed_cells.clear();
+        return m_is_consistent;
+    }
+
+    const auto is_reassignment = (it != m_assignments.end());
+    m_assignments[coordinates] = c;
+
+    if (is_reassignment)
+    {
+        return reconstrain_from_root();
+    }
+
+    // Assigning more cells to an inconsistent grid cannot make it
+    // consistent.
+    if (!m_is_consistent)
+    {
+        return false;
+    }
+
+    const auto previous_possible_characters = all_possible_characters();
+
+    m_is_consistent = narrow(*m_grid, coordinates, c) && m_grid->constrain();
+    record_changed_cells(previous_possible_characters);
+
+    return m_is_consistent;
+}
+
+// Narrow the cell of 'grid' at 'coordinates' down to 'c'. Return false
+// if that cell may not contain 'c'.
+bool
+GridEditor::narrow(Grid& grid, const vector<size_t>& coordinates, char c)
+{
+    const auto cell = grid.cell(coordinates);
+
+    if (!Alphabet::has_character(c) ||
+        !cell->possible_characters().contains(c))
+    {
+        return false;
+    }
+
+    cell->set_possible_characters(c);
+    return true;
+}
+
+// Record the cells whose possible characters differ from
+// 'previous_possible_characters' (see all_possible_characters()).
+void
+GridEditor::record_changed_cells(
+              const vector<SetOfCharacters>& previous_possible_characters)
+{
+    m_changed_cells.clear();
+
+    if (!m_is_consistent)
+    {
+        return;
+    }
+
+    const auto cells = m_grid->all_cells();
+    assert(cells.size() == previous_possible_characters.size());
+
+    for (size_t i = 0; i != cells.size(); ++i)
+    {
+        const auto& cell = cells[i];
+
+        if (cell->possible_characters() != previous_possible_characters[i])
+        {
+            m_changed_cells.push_back(cell->coordinates());
+        }
+    }
+}
+
+// Constrain a copy of the root with the current assignments, and make
+// it the current grid. Return whether it is consistent.
+bool
+GridEditor::reconstrain_from_root()
+{
+    const auto previous_possible_characters = all_possible_characters();
+
+    m_grid = m_root->clone();
+    m_is_consistent = m_root_is_consistent;
+
+    for (const auto& assignment : m_assignments)
+    {
+        if (!m_is_consistent)
+        {
+            break;
+        }
+
+        m_is_consistent = narrow(*m_grid, assignment.first, assignment.second);
+    }
+
+    m_is_consistent = m_is_consistent && m_grid->constrain();
+    record_changed_cells(previous_possible_characters);
+
+    return m_is_consistent;
+}
+
+// Retract the character assigned to the cell at 'coordinates', if any.
+// Return whether the grid is consistent (see is_consistent())
+// afterwards.
+bool
+GridEditor::retract(const vector<size_t>& coordinates)
+{
+    if (m_assignments.erase(coordinates) == 0)
+    {
+        m_changed_cells.clear();
+        return m_is_consistent;
+    }
+
+    return reconstrain_from_root();
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef GRID_EDITOR_HPP
+#define GRID_EDITOR_HPP
+
+#include "search_options.hpp"
+#include "set_of_characters.hpp"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class Grid;
+
+
+// An instance of this class keeps a grid constrained while a player
+// fills it in, one cell at a time, as in an interactive frontend. After
+// each edit - assigning a character to a cell, or retracting that
+// assignment - it tells whether the grid may still be solved, and which
+// characters each cell may still contain.
+//
+// An edit does not constrain the grid from scratch:
+// * An assignment only narrows a cell, so that the current grid is
+//   constrained further, in place.
+// * A retraction (or a change of an assigned character) widens a cell,
+//   which constraining cannot undo. The grid is then copied again from
+//   the root - the grid constrained before any assignment, which is
+//   kept - and the remaining assignments are applied to the copy.
+// In both cases, each line keeps its last constraint, and the hash of
+// its cells when it was computed (see GridLine::needs_constraining()),
+// so that only the lines through the cells which changed, and those
+// which their changes reach, are constrained again.
+//
+// The cells are designated by their coordinates (see
+// GridCell::coordinates()).
+class GridEditor final
+{
+public:
+    // instance creation and deletion
+    explicit GridEditor(std::unique_ptr<Grid>  grid,
+                        const SearchOptions&   options = SearchOptions());
+    ~GridEditor();
+
+    // accessing
+    const std::vector<std::vector<size_t>>& changed_cells() const;
+    const Grid& grid() const;
+    SetOfCharacters possible_characters(
+                      const std::vector<size_t>& coordinates) const;
+
+    // querying
+    bool is_consistent() const;
+    bool is_solved() const;
+
+    // modifying
+    bool assign(const std::vector<size_t>& coordinates, char c);
+    bool retract(const std::vector<size_t>& coordinates);
+
+private:
+    // accessing
+    std::vector<SetOfCharacters> all_possible_characters() const;
+
+    // modifying
+    static bool narrow(Grid&                      grid,
+                       const std::vector<size_t>& coordinates,
+                       char                       c);
+    void record_changed_cells(
+           const std::vector<SetOfCharacters>& previous_possible_characters);
+    bool reconstrain_from_root();
+
+    // data members
+
+    // The grid as constrained before any assignment, and whether it
+    // may be solved.
+    std::unique_ptr<Grid> m_root;
+    bool m_root_is_consistent;
+
+    // The grid as constrained with the current assignments, and whether
+    // it may still be solved. If it may not, the possible characters of
+    // its cells are those at the time the contradiction was found.
+    std::unique_ptr<Grid> m_grid;
+    bool m_is_consistent;
+
+    // The character assigned to each assigned cell, by coordinates.
+    std::map<std::vector<size_t>, char> m_assignments;
+
+    // The coordinates of the cells whose possible characters the last
+    // edit changed, if the grid is consistent.
+    std::vector<std::vector<size_t>> m_changed_cells;
+};
+
+
+#endif // GRID_EDITOR_HPP
@@ -26,16 +26,19 @@
 
 #include "grid_line.hpp"
 
+#include "compact_table.hpp"
 #include "grid.hpp"
 #include "grid_cell.hpp"
 #include "grid_line_regex.hpp"
 #include "logger.hpp"
 #include "regex.hpp"
+#include "regular_constraint.hpp"
 #include "utils.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <limits>
 #include <numeric>
 
 using namespace std;
@@ -73,6 +76,10 @@ GridLine::build_regexes(const vector<string>& regexes_as_strings)
 void
 GridLine::set_cell(shared_ptr<GridCell> cell, size_t index_of_cell_on_line)
 {
+    assert(m_cells[index_of_cell_on_line] == nullptr);
+
+    cell->add_line(this);
+    m_hash ^= cell->hash();
     m_cells[index_of_cell_on_line] = cell;
 }
 
@@ -83,6 +90,15 @@ GridLine::copy_regexes(const GridLine& rhs)
 {
     m_grid_line_regexes = rhs.m_grid_line_regexes;
     m_saved_constraint = rhs.m_saved_constraint;
+    m_saved_hash = rhs.m_saved_hash;
+    m_table = (rhs.m_table != nullptr)                         ?
+                  Utils::make_unique<CompactTable>(*rhs.m_table) :
+                  nullptr;
+    m_regular_constraint =
+        (rhs.m_regular_constraint != nullptr)                          ?
+            Utils::make_unique<RegularConstraint>(*rhs.m_regular_constraint) :
+            nullptr;
+    m_regular_constraint_is_attempted = rhs.m_regular_constraint_is_attempted;
 }
 
 // accessing
@@ -115,6 +131,73 @@ GridLine::constraint_from_cells() const
     return Constraint(constraint);
 }
 
+// Return the number of strings which fit in 'constraint', or
+// 'max_num_strings' + 1 if there are more than 'max_num_strings' of
+// them.
+size_t
+GridLine::num_strings_which_fit(const Constraint& constraint,
+                                size_t            max_num_strings)
+{
+    size_t result = 1;
+
+    for (size_t i = 0; i != constraint.size(); ++i)
+    {
+        const auto num_characters = constraint[i].size();
+
+        if (num_characters == 0)
+        {
+            return 0;
+        }
+
+        if (num_characters > max_num_strings / result)
+        {
+            return max_num_strings + 1;
+        }
+
+        result *= num_characters;
+    }
+
+    return result;
+}
+
+// Return the regular constraint which constrains this line on behalf
+// of all its regexes at once, or nullptr if this line has fewer than
+// two regexes which are not ignored, or if one of them cannot be
+// represented as an automaton (see RegularConstraint::create()). It is
+// created when it is first needed, because it depends on the alphabet.
+RegularConstraint*
+GridLine::regular_constraint()
+{
+    if (!m_regular_constraint_is_attempted)
+    {
+        vector<const Regex*> regexes;
+
+        for (const auto& grid_line_regex : m_grid_line_regexes)
+        {
+            if (grid_line_regex.regex() != nullptr)
+            {
+                regexes.push_back(grid_line_regex.regex());
+            }
+        }
+
+        if (regexes.size() >= 2 &&
+            all_of(regexes.cbegin(),
+                   regexes.cend(),
+                   [](const Regex* regex)
+                   {
+                       return regex->has_exact_values();
+                   }))
+        {
+            m_regular_constraint = RegularConstraint::create(regexes,
+                                                             num_cells());
+        }
+
+        m_regular_constraint_is_attempted = true;
+    }
+
+    return m_regular_constraint.get();
+}
+
 // Return the characters which appear explicitly in the regexes of this
 // line.
 string
@@ -130,12 +213,147 @@ GridLine::explicit_regex_characters() const
                       });
 }
 
+// Set 'candidates' to the strings which this line may still contain,
+// i.e., which fit in the possible characters of its cells and which its
+// regex(es) match, and return true, unless there are more than
+// 'max_num_candidates' of them.
+//
+// The candidates are listed by the table of this line (see
+// CompactTable) or by its regular constraint(s) (see RegularConstraint)
+// if it has them, and otherwise by matching each string which fits in
+// the possible characters of its cells, if there are few enough of
+// them. Return false too if none of this is possible.
+bool
+GridLine::get_candidates(vector<string>& candidates,
+                         size_t          max_num_candidates)
+{
+    // Above this number of strings which fit in the possible characters
+    // of the cells, matching each of them would cost too much.
+    const size_t max_num_strings_to_match = 64;
+
+    const auto constraint = constraint_from_cells();
+    vector<const GridLineRegex*> regexes;
+
+    for (const auto& grid_line_regex : m_grid_line_regexes)
+    {
+        if (grid_line_regex.regex() != nullptr)
+        {
+            regexes.push_back(&grid_line_regex);
+        }
+    }
+
+    if (m_table != nullptr)
+    {
+        if (m_table->num_valid_strings() > max_num_candidates)
+        {
+            return false;
+        }
+
+        candidates = m_table->valid_strings();
+    }
+    else if (const auto regular_constraint_ = regular_constraint())
+    {
+        if (!regular_constraint_->get_strings(candidates,
+                                              max_num_candidates))
+        {
+            return false;
+        }
+    }
+    else if (regexes.size() != 1 ||
+             !regexes.front()->get_strings(candidates, max_num_candidates))
+    {
+        if (num_strings_which_fit(constraint, max_num_strings_to_match) >
+            max_num_strings_to_match)
+        {
+            return false;
+        }
+
+        candidates = strings_which_match(constraint);
+    }
+
+    // The table and the regular constraints were given the constraint
+    // of this line when it was last constrained, which the possible
+    // characters of its cells may have narrowed since.
+    candidates.erase(remove_if(candidates.begin(),
+                               candidates.end(),
+                               [&constraint](const string& candidate)
+                               {
+                                   return !constraint.is_satisfied_by(
+                                                        candidate);
+                               }),
+                     candidates.end());
+
+    return candidates.size() <= max_num_candidates;
+}
+
+// Add to 'kernel_names' the kernel name (see
+// GridLineRegex::kernel_name()) of each regex of this line.
+void
+GridLine::get_kernel_names(vector<string>& kernel_names) const
+{
+    for (const auto& grid_line_regex : m_grid_line_regexes)
+    {
+        kernel_names.push_back(grid_line_regex.kernel_name());
+    }
+}
+
+GridLineRegex&
+GridLine::grid_line_regex(size_t regex_index)
+{
+    return m_grid_line_regexes[regex_index];
+}
+
+// Return the Zobrist hash (see ZobristHash) of the possible characters
+// of the cells of this line.
+uint64_t
+GridLine::hash() const
+{
+    return m_hash;
+}
+
 size_t
 GridLine::num_cells() const
 {
     return m_cells.size();
 }
 
+size_t
+GridLine::num_regexes() const
+{
+    return m_grid_line_regexes.size();
+}
+
+// Return the number of supports of 'c' in 'cell' (which is one of the
+// cells of this line) in the regular constraints of this line (see
+// RegularConstraint::num_supports()), or 0 if this line has none. This
+// estimates how many of the strings that this line may still contain
+// have 'c' in 'cell'.
+size_t
+GridLine::num_supports(const GridCell& cell, char c) const
+{
+    const auto it = find_if(m_cells.cbegin(),
+                            m_cells.cend(),
+                            [&cell](const shared_ptr<GridCell>& cell_)
+                            {
+                                return cell_.get() == &cell;
+                            });
+    assert(it != m_cells.cend());
+    const auto pos = static_cast<size_t>(it - m_cells.cbegin());
+
+    if (m_regular_constraint != nullptr)
+    {
+        return m_regular_constraint->num_supports(pos, c);
+    }
+
+    return accumulate(m_grid_line_regexes.cbegin(),
+                      m_grid_line_regexes.cend(),
+                      size_t(0),
+                      [pos, c](size_t sum, const GridLineRegex& regex)
+                      {
+                          return sum + regex.num_supports(pos, c);
+                      });
+}
+
 string
 GridLine::regexes_as_string() const
 {
@@ -167,6 +385,17 @@ GridLine::has_impossible_constraint() const
     return m_saved_constraint.is_impossible();
 }
 
+// Return whether the cells of this line have changed since it was last
+// constrained.
+bool
+GridLine::needs_constraining() const
+{
+    // The cells have not changed since 'm_saved_constraint' was
+    // computed iff their hash has not changed (barring a collision of
+    // 64-bit hashes).
+    return m_saved_constraint.empty() || m_saved_hash != m_hash;
+}
+
 // printing
 
 vector<string>
@@ -187,34 +416,27 @@ GridLine::to_string() const
 
 // modifying
 
-// Constrain this line with the contents of its cells, and return
-// whether the constraint was changed.
+// Update the cells of this line with 'new_constraint', which
+// compute_constraint() returned when the hash of this line was
+// 'hash_of_cells', and return whether the constraint was changed.
 //
-// For example, suppose this line contains three cells, has the single
-// regex '(A|C)*B', and the current cell contents is { "ABC", "ABC",
-// "ABC" } (i.e., the possible characters for each cell are A, B and C).
-// Then, this function would:
-// * update the possible characters of the cells to { "AC", "AC", "B" }
-// * return true
+// The cells may have changed since then, when several lines compute
+// their constraints from the same state of the cells (see
+// Grid::constrain_in_rounds()). 'new_constraint' is then intersected
+// with the current cells, and this line still needs constraining
+// afterwards (see needs_constraining()).
 bool
-GridLine::constrain()
+GridLine::apply_constraint(const Constraint& new_constraint,
+                           uint64_t          hash_of_cells)
 {
-    assert(m_saved_constraint.is_possible());
-
-    if (m_saved_constraint == constraint_from_cells())
-    {
-        LOG_BLANK_LINE();
-        LOG("not constraining " + to_string() +
-            ", because line constraints have not changed since last time");
-        return false;
-    }
-
-    const auto new_constraint = constrain_regexes();
+    const auto cells_are_unchanged = (m_hash == hash_of_cells);
+    const auto constraint_from_cells_ = constraint_from_cells();
+    const auto new_constraint_ = new_constraint & constraint_from_cells_;
     const auto constraint_was_changed =
-        (new_constraint != constraint_from_cells());
-    m_saved_constraint = new_constraint;
+        (new_constraint_ != constraint_from_cells_);
+    m_saved_constraint = new_constraint_;
 
-    if (new_constraint.is_impossible())
+    if (new_constraint_.is_impossible())
     {
         LOG_BLANK_LINE();
         LOG("impossible constraint for " + to_string());
@@ -226,7 +448,7 @@ GridLine::constrain()
         LOG_BLANK_LINE();
         LOG("updating cells for " + to_string());
 
-        update_cells(new_constraint);
+        update_cells(new_constraint_);
 
         LOG("new grid:");
         INCREMENT_LOGGING_INDENTATION_LEVEL();
@@ -239,27 +461,274 @@ GridLine::constrain()
         LOG("no cells were updated for " + to_string());
     }
 
+    if (cells_are_unchanged)
+    {
+        m_saved_hash = m_hash;
+    }
+
     return constraint_was_changed;
 }
 
+// Return the constraint which the regex(es) of this line impose on its
+// cells, without updating them (see apply_constraint()).
+//
+// This function modifies only the state of this line, not its cells,
+// so that several lines can compute their constraints concurrently.
+Constraint
+GridLine::compute_constraint()
+{
+    assert(m_saved_constraint.is_possible());
+
+    return constrain_regexes();
+}
+
+// Constrain this line with the contents of its cells, and return
+// whether the constraint was changed.
+//
+// For example, suppose this line contains three cells, has the single
+// regex '(A|C)*B', and the current cell contents is { "ABC", "ABC",
+// "ABC" } (i.e., the possible characters for each cell are A, B and C).
+// Then, this function would:
+// * update the possible characters of the cells to { "AC", "AC", "B" }
+// * return true
+bool
+GridLine::constrain()
+{
+    if (!needs_constraining())
+    {
+        LOG_BLANK_LINE();
+        LOG("not constraining " + to_string() +
+            ", because line constraints have not changed since last time");
+        return false;
+    }
+
+    const auto hash_of_cells = m_hash;
+    return apply_constraint(compute_constraint(), hash_of_cells);
+}
+
 // Constrain this line with its regex(es), and return the new
 // constraint.
+//
+// When few enough strings fit in the constraint of this line, they are
+// matched once and for all against the regex(es) of this line, and the
+// ones which match are kept in a table. From then on, this line is
+// constrained with the table rather than with its regex(es). See
+// CompactTable.
 Constraint
 GridLine::constrain_regexes()
 {
-    auto constraint = constraint_from_cells();
+    const auto constraint = constraint_from_cells();
+
+    if (m_table == nullptr)
+    {
+        create_table_if_few_strings_fit(constraint);
+    }
+
+    if (m_table != nullptr)
+    {
+        return m_table->constrain(constraint);
+    }
+
+    return constrain_with_regexes(constraint);
+}
+
+// Constrain 'constraint' with the regex(es) of this line, and return
+// the result.
+//
+// The result is consistent with each regex: when this line has several
+// regexes, they are constrained with jointly (see regular_constraint())
+// if possible, and otherwise in turn until none of them changes the
+// result any more.
+Constraint
+GridLine::constrain_with_regexes(const Constraint& constraint)
+{
+    if (const auto regular_constraint_ = regular_constraint())
+    {
+        return regular_constraint_->constrain(constraint);
+    }
+
+    const auto num_regexes = m_grid_line_regexes.size();
+    auto result = constraint;
+
+    // The number of regexes in a row, ending with the current one,
+    // which left 'result' unchanged (the regex which changed it last
+    // counts, since it is consistent with it).
+    size_t num_regexes_consistent = 0;
+
+    for (size_t i = 0; num_regexes_consistent != num_regexes; ++i)
+    {
+        auto& grid_line_regex = m_grid_line_regexes[i % num_regexes];
+        auto new_result = grid_line_regex.constrain(result);
+
+        if (new_result.is_impossible())
+        {
+            return new_result;
+        }
+
+        if (new_result == result)
+        {
+            ++num_regexes_consistent;
+        }
+        else
+        {
+            result = move(new_result);
+            num_regexes_consistent = 1;
+        }
+    }
+
+    return result;
+}
+
+// Create the table of this line if few enough strings fit in
+// 'constraint', and if one of the regexes of this line is enumerated
+// (the other ones constrain lines in linear time anyway) and they are
+// not constrained with jointly (the regular constraint is already
+// exact and incremental).
+void
+GridLine::create_table_if_few_strings_fit(const Constraint& constraint)
+{
+    // Matching a single string against a regex can cost almost as much
+    // as constraining the line with it, so above this number of
+    // strings, creating the table would cost more than it would save.
+    const size_t max_num_strings = 8;
+
+    if (regular_constraint() != nullptr ||
+        none_of(m_grid_line_regexes.cbegin(),
+                m_grid_line_regexes.cend(),
+                [](const GridLineRegex& grid_line_regex)
+                {
+                    return grid_line_regex.is_enumerated();
+                }))
+    {
+        return;
+    }
+
+    const auto num_strings = num_strings_which_fit(constraint,
+                                                   max_num_strings);
+
+    if (num_strings == 0 || num_strings > max_num_strings)
+    {
+        return;
+    }
 
+    const auto strings_which_match_ = strings_which_match(constraint);
+
+    LOG_BLANK_LINE();
+    LOG("creating table for " + to_string() + " with " +
+        Utils::to_string(strings_which_match_.size()) + " string(s) out of " +
+        Utils::to_string(num_strings));
+
+    m_table = Utils::make_unique<CompactTable>(strings_which_match_,
+                                               num_cells());
+}
+
+// Return the strings which fit in 'constraint' and which the regex(es)
+// of this line match. There should be few strings which fit in
+// 'constraint' (see num_strings_which_fit()), since each of them is
+// matched in turn.
+vector<string>
+GridLine::strings_which_match(const Constraint& constraint)
+{
+    const auto num_cells_ = num_cells();
+    const auto num_strings = num_strings_which_fit(
+                               constraint,
+                               numeric_limits<size_t>::max() - 1);
+
+    // Enumerate the strings which fit in 'constraint', like an odometer
+    // whose rightmost digit turns fastest, and keep those which match
+    // the regex(es) of this line.
+    vector<vector<char>> characters(num_cells_);
+    for (size_t i = 0; i != num_cells_; ++i)
+    {
+        for (const auto c : constraint[i])
+        {
+            characters[i].push_back(c);
+        }
+    }
+
+    vector<size_t> indices(num_cells_, 0);
+    string candidate(num_cells_, ' ');
+    vector<string> result;
+
+    for (size_t n = 0; n != num_strings; ++n)
+    {
+        for (size_t i = 0; i != num_cells_; ++i)
+        {
+            candidate[i] = characters[i][indices[i]];
+        }
+
+        const auto candidate_as_constraint = Constraint(
+            vector<SetOfCharacters>(candidate.cbegin(), candidate.cend()));
+
+        if (constrain_with_regexes(candidate_as_constraint).is_possible())
+        {
+            result.push_back(candidate);
+        }
+
+        for (auto i = num_cells_; i != 0; --i)
+        {
+            if (++indices[i - 1] != characters[i - 1].size())
+            {
+                break;
+            }
+
+            indices[i - 1] = 0;
+        }
+    }
+
+    return result;
+}
+
+// Ignore the regex(es) of this line which match all the strings of
+// the length of this line.
+void
+GridLine::ignore_universal_regexes()
+{
     for (auto& grid_line_regex : m_grid_line_regexes)
     {
-        constraint = grid_line_regex.constrain(constraint);
+        grid_line_regex.ignore_if_universal(num_cells());
+    }
+}
 
-        if (constraint.is_impossible())
+// Narrow the possible characters of the cells of this line to those
+// which its regexes allow, each considered alone (see
+// GridLineRegex::profile()), or all of them at once if they are
+// constrained with jointly (see regular_constraint()). A cell which
+// would be left without possible characters is not narrowed: the first
+// call to constrain() finds that the grid has no solution anyway.
+void
+GridLine::narrow_cells_with_profiles()
+{
+    const auto num_cells_ = num_cells();
+    vector<Constraint> profiles;
+
+    if (const auto regular_constraint_ = regular_constraint())
+    {
+        profiles.push_back(
+          regular_constraint_->constrain(Constraint::all(num_cells_)));
+    }
+    else
+    {
+        for (auto& grid_line_regex : m_grid_line_regexes)
         {
-            break;
+            profiles.push_back(grid_line_regex.profile(num_cells_));
         }
     }
 
-    return constraint;
+    for (const auto& profile : profiles)
+    {
+        for (size_t cell_index = 0; cell_index != num_cells_; ++cell_index)
+        {
+            const auto cell_ = cell(cell_index);
+            const auto new_possible_characters =
+                cell_->possible_characters() & profile[cell_index];
+
+            if (!new_possible_characters.empty())
+            {
+                cell_->set_possible_characters(new_possible_characters);
+            }
+        }
+    }
 }
 
 // Optimize the regex(es) of this line according to 'optimizations'.
@@ -272,6 +741,55 @@ GridLine::optimize(const RegexOptimizations& optimizations)
     }
 }
 
+// Same as optimize(const RegexOptimizations&), except that the effect
+// of each pass is added to 'statistics'.
+void
+GridLine::optimize(const RegexOptimizations&    optimizations,
+                   RegexOptimizationStatistics& statistics)
+{
+    for (auto& grid_line_regex : m_grid_line_regexes)
+    {
+        grid_line_regex.optimize(optimizations, num_cells(), statistics);
+    }
+}
+
+// Replace the regex of this line with index 'regex_index' with
+// 'grid_line_regex', which should already be specialized and optimized
+// like the other regexes of this line.
+//
+// The table, the regular constraint and the saved constraint of this
+// line were derived from the replaced regex, so they are dropped, and
+// this line needs constraining again (see needs_constraining()).
+void
+GridLine::replace_regex(size_t               regex_index,
+                        const GridLineRegex& grid_line_regex)
+{
+    m_grid_line_regexes[regex_index] = grid_line_regex;
+    m_saved_constraint = Constraint();
+    m_table = nullptr;
+    m_regular_constraint = nullptr;
+    m_regular_constraint_is_attempted = false;
+}
+
+// Specialize the regex(es) of this line for the length of this line.
+void
+GridLine::specialize_regexes()
+{
+    for (auto& grid_line_regex : m_grid_line_regexes)
+    {
+        grid_line_regex.specialize(num_cells());
+    }
+}
+
+// Update the hash of this line after the possible characters of one
+// of its cells changed. 'hash_change' is the change of the hash of that
+// cell (see ZobristHash::hash_change()).
+void
+GridLine::update_hash(uint64_t hash_change)
+{
+    m_hash ^= hash_change;
+}
+
 // Update the cells of this line with 'new_constraint'.
 void
 GridLine::update_cells(const Constraint& new_constraint)
@@ -29,15 +29,19 @@
 
 #include "constraint.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+class CompactTable;
 class Grid;
 class GridCell;
 class GridLineRegex;
 class Regex;
+class RegexOptimizationStatistics;
 class RegexOptimizations;
+class RegularConstraint;
 
 
 // An instance of this class represents a line of cells in a grid.
@@ -66,19 +70,41 @@ public:
     std::shared_ptr<GridCell> cell(size_t cell_index);
     const std::vector<std::shared_ptr<GridCell>>& cells() const;
     std::string explicit_regex_characters() const;
+    bool get_candidates(std::vector<std::string>& candidates,
+                        size_t                    max_num_candidates);
+    void get_kernel_names(std::vector<std::string>& kernel_names) const;
+    GridLineRegex& grid_line_regex(size_t regex_index);
+    std::uint64_t hash() const;
     size_t num_cells() const;
+    size_t num_regexes() const;
+    size_t num_supports(const GridCell& cell, char c) const;
     std::string regexes_as_string() const;
 
     // querying
     bool has_impossible_constraint() const;
+    bool needs_constraining() const;
 
     // modifying
+    bool apply_constraint(const Constraint& new_constraint,
+                          std::uint64_t     hash_of_cells);
+    Constraint compute_constraint();
     bool constrain();
+    void ignore_universal_regexes();
+    void narrow_cells_with_profiles();
     void optimize(const RegexOptimizations& optimizations);
+    void optimize(const RegexOptimizations&    optimizations,
+                  RegexOptimizationStatistics& statistics);
+    void replace_regex(size_t               regex_index,
+                       const GridLineRegex& grid_line_regex);
+    void specialize_regexes();
+    void update_hash(std::uint64_t hash_change);
 
 private:
     // accessing
     Constraint constraint_from_cells() const;
+    static size_t num_strings_which_fit(const Constraint& constraint,
+                                        size_t            max_num_strings);
+    RegularConstraint* regular_constraint();
 
     // printing
     std::vector<std::string> print_verbose_grid() const;
@@ -88,6 +114,9 @@ private:
 
     // modifying
     Constraint constrain_regexes();
+    Constraint constrain_with_regexes(const Constraint& constraint);
+    void create_table_if_few_strings_fit(const Constraint& constraint);
+    std::vector<std::string> strings_which_match(const Constraint& constraint);
     void update_cells(const Constraint& new_constraint);
 
     // data members
@@ -130,6 +159,28 @@ private:
 
     // The constraint of this line the last time it was computed.
     Constraint m_saved_constraint;
+
+    // The Zobrist hash (see ZobristHash) of the possible characters of
+    // the cells of this line, which the cells update when they change.
+    std::uint64_t m_hash = 0;
+
+    // The value of 'm_hash' when 'm_saved_constraint' was computed.
+    std::uint64_t m_saved_hash = 0;
+
+    // The strings which fitted in the constraint of this line and
+    // matched its regex(es) when the table was created, or nullptr if
+    // the table has not been created (see constrain_regexes()). Once it
+    // exists, this line is constrained with this table rather than with
+    // its regex(es).
+    std::unique_ptr<CompactTable> m_table;
+
+    // The regular constraint which constrains this line on behalf of
+    // all its regexes at once, or nullptr if there is none (see
+    // regular_constraint()).
+    std::unique_ptr<RegularConstraint> m_regular_constraint;
+
+    // Whether creating 'm_regular_constraint' has been attempted yet.
+    bool m_regular_constraint_is_attempted = false;
 };
 
 
@@ -26,25 +26,62 @@
 
 #include "grid_line_regex.hpp"
 
+#include "alphabet.hpp"
 #include "constraint.hpp"
 #include "regex.hpp"
+#include "regex_kernel.hpp"
+#include "regex_optimization_statistics.hpp"
+#include "regex_optimizations.hpp"
+#include "regular_constraint.hpp"
+#include "required_literals.hpp"
+#include "utils.hpp"
+
+#include <map>
+#include <tuple>
 
 using namespace std;
 
 
+namespace
+{
+
+// The profiles (see GridLineRegex::profile()) which have been computed
+// so far, by alphabet, regex (as a string) and line length.
+map<tuple<string, string, size_t>, Constraint>&
+profiles()
+{
+    static map<tuple<string, string, size_t>, Constraint> result;
+    return result;
+}
+
+} // unnamed namespace
+
+
 // instance creation and deletion
 
 GridLineRegex::GridLineRegex(const string& regex_as_string) :
   m_regex_as_string(regex_as_string),
   m_regex(is_universal_regex(regex_as_string) ?
           nullptr                             :
-          Regex::parse(regex_as_string))
+          Regex::parse(regex_as_string)),
+  m_kernel(m_regex ? RegexKernel::create(*m_regex) : nullptr)
 {
 }
 
 GridLineRegex::GridLineRegex(const GridLineRegex& rhs) :
   m_regex_as_string(rhs.m_regex_as_string),
-  m_regex(rhs.m_regex ? rhs.m_regex->clone() : nullptr)
+  m_regex(rhs.m_regex ? rhs.m_regex->clone() : nullptr),
+  m_kernel(rhs.m_kernel ? rhs.m_kernel->clone() : nullptr),
+  m_required_literals(
+    rhs.m_required_literals                                         ?
+    Utils::make_unique<RequiredLiterals>(*rhs.m_required_literals) :
+    nullptr),
+  m_residual_supports(rhs.m_residual_supports),
+  m_regular_constraint(
+    rhs.m_regular_constraint                                          ?
+    Utils::make_unique<RegularConstraint>(*rhs.m_regular_constraint) :
+    nullptr),
+  m_regular_constraint_is_attempted(rhs.m_regular_constraint_is_attempted)
 {
 }
 
@@ -65,10 +102,18 @@ void swap(GridLineRegex& lhs, GridLineRegex& rhs) noexcept
 {
     using std::swap;
 
-    swap(lhs.m_regex_as_string, rhs.m_regex_as_string);
-    swap(lhs.m_regex,           rhs.m_regex);
+    swap(lhs.m_regex_as_string,    rhs.m_regex_as_string);
+    swap(lhs.m_regex,              rhs.m_regex);
+    swap(lhs.m_kernel,             rhs.m_kernel);
+    swap(lhs.m_required_literals,  rhs.m_required_literals);
+    swap(lhs.m_residual_supports,  rhs.m_residual_supports);
+    swap(lhs.m_regular_constraint, rhs.m_regular_constraint);
+    swap(lhs.m_regular_constraint_is_attempted,
+         rhs.m_regular_constraint_is_attempted);
 }
 
+GridLineRegex::~GridLineRegex() = default;
+
 // accessing
 
 string
@@ -88,8 +133,237 @@ GridLineRegex::explicit_characters() const
     return m_regex->explicit_characters();
 }
 
+// Set 'strings' to the strings which lines may still contain according
+// to the regular constraint of this regex, and return true, unless
+// there are more than 'max_num_strings' of them (see
+// RegularConstraint::get_strings()). Return false too if this regex has
+// no regular constraint, or if it has not been created yet.
+bool
+GridLineRegex::get_strings(vector<string>& strings,
+                           size_t          max_num_strings) const
+{
+    return m_regular_constraint != nullptr &&
+           m_regular_constraint->get_strings(strings, max_num_strings);
+}
+
+// Return the name of the kernel which constrains lines on behalf of
+// this regex, "generic" if lines are constrained by enumerating the
+// values of this regex, or "ignored" if this regex is ignored.
+string
+GridLineRegex::kernel_name() const
+{
+    if (is_universal_regex())
+    {
+        return "ignored";
+    }
+
+    if (m_kernel == nullptr)
+    {
+        return "generic";
+    }
+
+    return m_kernel->name();
+}
+
+// Return the number of supports of 'c' at position 'pos' in the regular
+// constraint of this regex (see RegularConstraint::num_supports()), or
+// 0 if this regex has no regular constraint, or if it has not been
+// created yet.
+size_t
+GridLineRegex::num_supports(size_t pos, char c) const
+{
+    return m_regular_constraint == nullptr
+           ? 0
+           : m_regular_constraint->num_supports(pos, c);
+}
+
+// Return the characters which are possible at each position of a line
+// of 'line_length' cells when this regex alone constrains it, if this
+// regex has a kernel or a regular constraint. Otherwise, return all the
+// characters at each position: enumerating the values of this regex
+// over the full alphabet would cost more than it would save, and would
+// not be exact anyway.
+//
+// Profiles are cached by alphabet, regex and line length, so that a
+// regex which appears in several grids with the same alphabet is
+// constrained only once.
+//
+// Precondition:
+// * the alphabet is set
+Constraint
+GridLineRegex::profile(size_t line_length)
+{
+    const auto all_characters = Constraint::all(line_length);
+
+    if (is_universal_regex() ||
+        (m_kernel == nullptr && regular_constraint(line_length) == nullptr))
+    {
+        return all_characters;
+    }
+
+    auto& profiles_ = profiles();
+    const auto key = make_tuple(Alphabet::characters_as_string(),
+                                m_regex_as_string,
+                                line_length);
+    auto it = profiles_.find(key);
+
+    if (it == profiles_.end())
+    {
+        it = profiles_.emplace(key, constrain(all_characters)).first;
+    }
+
+    return it->second;
+}
+
+// Return the parsed regex, or nullptr if this regex is to be ignored.
+const Regex*
+GridLineRegex::regex() const
+{
+    return m_regex.get();
+}
+
+// Return the regular constraint which constrains lines of
+// 'line_length' cells on behalf of this regex, or nullptr if its values
+// are not exact (see Regex::has_exact_values()) or if it cannot be
+// represented as a small enough automaton. It is created when it is
+// first needed, because it depends on the alphabet.
+RegularConstraint*
+GridLineRegex::regular_constraint(size_t line_length)
+{
+    if (!m_regular_constraint_is_attempted)
+    {
+        if (m_regex->has_exact_values())
+        {
+            m_regular_constraint = RegularConstraint::create(*m_regex,
+                                                             line_length);
+        }
+        m_regular_constraint_is_attempted = true;
+    }
+
+    return m_regular_constraint.get();
+}
+
+const RequiredLiterals&
+GridLineRegex::required_literals()
+{
+    if (m_required_literals == nullptr)
+    {
+        m_required_literals =
+            Utils::make_unique<RequiredLiterals>(m_regex->required_literals());
+    }
+
+    return *m_required_literals;
+}
+
 // querying
 
+// Return whether each possible character of 'constraint' is possible in
+// one of the residual supports, once narrowed to 'constraint'. If so,
+// constraining 'constraint' with this regex would return 'constraint'
+// unchanged, since the values of this regex are exact (see
+// Regex::has_exact_values()): a string which fits in a narrowed support
+// is matched by this regex.
+bool
+GridLineRegex::residual_supports_hold(const Constraint& constraint) const
+{
+    if (m_residual_supports == nullptr)
+    {
+        return false;
+    }
+
+    auto supported = Constraint::none(constraint.size());
+
+    for (const auto& support : *m_residual_supports)
+    {
+        const auto narrowed_support = support & constraint;
+
+        if (narrowed_support.is_possible())
+        {
+            supported |= narrowed_support;
+        }
+    }
+
+    return supported == constraint;
+}
+
+// Return whether lines are constrained by enumerating the values of
+// this regex, i.e., whether its kernel name is "generic".
+bool
+GridLineRegex::is_enumerated() const
+{
+    return !is_universal_regex() && m_kernel == nullptr;
+}
+
+// Return whether each string of 'line_length' characters which this
+// regex matches is matched by 'rhs' too, provided that this can be
+// proved by enumerating these strings in no more than 'max_num_steps'
+// steps. Return false otherwise.
+//
+// The strings are enumerated one character at a time, with the
+// constraint of each prefix narrowed by this regex, so that only the
+// branches which lead to one of its strings are followed.
+bool
+GridLineRegex::is_included_in(GridLineRegex& rhs,
+                              size_t         line_length,
+                              size_t         max_num_steps)
+{
+    if (rhs.is_universal_regex() || m_regex_as_string == rhs.m_regex_as_string)
+    {
+        return true;
+    }
+
+    auto num_steps_left = max_num_steps;
+
+    return is_included_in(rhs,
+                          constrain(Constraint::all(line_length)),
+                          0,
+                          num_steps_left);
+}
+
+// Same as is_included_in(GridLineRegex&, size_t, size_t), except that
+// only the strings which fit in 'constraint' are considered. The
+// characters of 'constraint' before 'position' are already fixed.
+bool
+GridLineRegex::is_included_in(GridLineRegex&    rhs,
+                              const Constraint& constraint,
+                              size_t            position,
+                              size_t&           num_steps_left)
+{
+    if (constraint.is_impossible())
+    {
+        return true;
+    }
+
+    if (num_steps_left == 0)
+    {
+        return false;
+    }
+
+    --num_steps_left;
+
+    if (position == constraint.size())
+    {
+        // 'constraint' is a single string, which this regex matches.
+        return rhs.constrain(constraint).is_possible();
+    }
+
+    for (const auto c : constraint[position])
+    {
+        auto narrowed_constraint = constraint;
+        narrowed_constraint[position] = SetOfCharacters(c);
+
+        if (!is_included_in(rhs,
+                            constrain(narrowed_constraint),
+                            position + 1,
+                            num_steps_left))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 GridLineRegex::is_universal_regex(const string& regex_as_string)
 {
@@ -113,7 +387,59 @@ GridLineRegex::constrain(const Constraint& constraint)
         return constraint;
     }
 
-    return m_regex->constrain(constraint);
+    if (m_kernel != nullptr)
+    {
+        return m_kernel->constrain(constraint);
+    }
+
+    if (const auto regular_constraint_ = regular_constraint(constraint.size()))
+    {
+        return regular_constraint_->constrain(constraint);
+    }
+
+    if (residual_supports_hold(constraint))
+    {
+        return constraint;
+    }
+
+    // Narrowing 'constraint' with the required literals does not
+    // change the result of the enumeration, since every value of
+    // 'm_regex' which fits 'constraint' also fits the narrowed
+    // constraint. But it spares the enumeration altogether if the
+    // literals cannot be placed.
+    const auto narrowed_constraint =
+        required_literals().constrain(constraint);
+
+    if (narrowed_constraint.is_impossible())
+    {
+        return narrowed_constraint;
+    }
+
+    if (!m_regex->has_exact_values())
+    {
+        return m_regex->constrain(narrowed_constraint);
+    }
+
+    auto supports = make_shared<vector<Constraint>>();
+    const auto new_constraint = m_regex->constrain(narrowed_constraint,
+                                                   *supports);
+    m_residual_supports = move(supports);
+    return new_constraint;
+}
+
+// Ignore this regex if it matches all the strings of 'line_length'
+// characters, e.g., '[CR]*' or '(.)*' over the alphabet { C, R }.
+//
+// Precondition:
+// * the alphabet is set
+void
+GridLineRegex::ignore_if_universal(size_t line_length)
+{
+    if (!is_universal_regex() && m_regex->is_universal(line_length))
+    {
+        m_regex = nullptr;
+        m_kernel = nullptr;
+    }
 }
 
 void
@@ -124,3 +450,49 @@ GridLineRegex::optimize(const RegexOptimizations& optimizations)
         m_regex = Regex::optimize(move(m_regex), optimizations);
     }
 }
+
+// Same as optimize(const RegexOptimizations&), except that the effect
+// of each pass on this regex, which is to be applied to lines of
+// 'line_length' cells, is added to 'statistics'.
+void
+GridLineRegex::optimize(const RegexOptimizations&    optimizations,
+                        size_t                       line_length,
+                        RegexOptimizationStatistics& statistics)
+{
+    if (is_universal_regex())
+    {
+        return;
+    }
+
+    for (const auto type : optimizations.enabled_passes())
+    {
+        const auto num_nodes_before = m_regex->num_nodes();
+        const auto num_steps_before = m_regex->num_enumeration_steps(
+                                                 line_length);
+
+        m_regex = Regex::optimize(move(m_regex),
+                                  RegexOptimizations::only(type));
+
+        const auto num_nodes_after = m_regex->num_nodes();
+        const auto num_steps_after = m_regex->num_enumeration_steps(
+                                                line_length);
+
+        statistics.add(type,
+                       num_nodes_before,
+                       num_nodes_after,
+                       num_steps_before,
+                       num_steps_after);
+    }
+}
+
+// Specialize this regex for lines of 'line_length' cells, so that
+// constraining such lines enumerates fewer values (see
+// Regex::specialize()).
+void
+GridLineRegex::specialize(size_t line_length)
+{
+    if (!is_universal_regex())
+    {
+        m_regex = Regex::specialize(move(m_regex), line_length);
+    }
+}
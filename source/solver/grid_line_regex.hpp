@@ -29,10 +29,15 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 class Constraint;
 class Regex;
+class RegexKernel;
+class RegexOptimizationStatistics;
 class RegexOptimizations;
+class RegularConstraint;
+class RequiredLiterals;
 
 
 // An instance of this class represents a regex in a grid line.
@@ -44,14 +49,32 @@ public:
     GridLineRegex(const GridLineRegex& rhs);
     GridLineRegex(GridLineRegex&& rhs) noexcept;
     GridLineRegex& operator=(GridLineRegex rhs);
+    ~GridLineRegex();
 
     // accessing
     std::string as_string() const;
     std::string explicit_characters() const;
+    bool get_strings(std::vector<std::string>& strings,
+                     size_t                    max_num_strings) const;
+    std::string kernel_name() const;
+    size_t num_supports(size_t pos, char c) const;
+    Constraint profile(size_t line_length);
+    const Regex* regex() const;
+
+    // querying
+    bool is_enumerated() const;
+    bool is_included_in(GridLineRegex& rhs,
+                        size_t         line_length,
+                        size_t         max_num_steps);
 
     // modifying
     Constraint constrain(const Constraint& constraint);
+    void ignore_if_universal(size_t line_length);
     void optimize(const RegexOptimizations& optimizations);
+    void optimize(const RegexOptimizations&    optimizations,
+                  size_t                       line_length,
+                  RegexOptimizationStatistics& statistics);
+    void specialize(size_t line_length);
 
 private:
     friend void swap(GridLineRegex& lhs, GridLineRegex& rhs) noexcept;
@@ -59,7 +82,16 @@ private:
     // instance creation and deletion
     GridLineRegex() = default;
 
+    // accessing
+    RegularConstraint* regular_constraint(size_t line_length);
+    const RequiredLiterals& required_literals();
+
     // querying
+    bool is_included_in(GridLineRegex&    rhs,
+                        const Constraint& constraint,
+                        size_t            position,
+                        size_t&           num_steps_left);
+    bool residual_supports_hold(const Constraint& constraint) const;
     static bool is_universal_regex(const std::string& regex_as_string);
     bool is_universal_regex() const;
 
@@ -70,6 +102,33 @@ private:
 
     // The parsed regex, or nullptr if this regex is to be ignored.
     std::unique_ptr<Regex> m_regex;
+
+    // The kernel which constrains lines on behalf of 'm_regex', or
+    // nullptr if 'm_regex' has none of the shapes which the kernels
+    // support (see RegexKernel), or if this regex is to be ignored.
+    std::unique_ptr<RegexKernel> m_kernel;
+
+    // The literals required by 'm_regex', or nullptr if they have not
+    // been computed yet. They are computed when they are first needed,
+    // because they depend on the alphabet.
+    std::unique_ptr<RequiredLiterals> m_required_literals;
+
+    // The supports (see Regex::constrain()) which the last enumeration
+    // of the values of 'm_regex' yielded, if these values are exact
+    // (see Regex::has_exact_values()), or nullptr otherwise. As long as
+    // they still support each possible character of the constraint of
+    // the line (see residual_supports_hold()), constraining the line
+    // would not change it, so the enumeration is skipped. Copies of
+    // this regex share their supports, which are replaced rather than
+    // modified.
+    std::shared_ptr<const std::vector<Constraint>> m_residual_supports;
+
+    // The regular constraint which constrains lines on behalf of
+    // 'm_regex', or nullptr if there is none (see regular_constraint()).
+    std::unique_ptr<RegularConstraint> m_regular_constraint;
+
+    // Whether creating 'm_regular_constraint' has been attempted yet.
+    bool m_regular_constraint_is_attempted = false;
 };
 
 
@@ -28,12 +28,18 @@
 #include "grid.hpp"
 #include "grid_reader.hpp"
 #include "logger.hpp"
+#include "portfolio.hpp"
+#include "regex_optimization_statistics.hpp"
+#include "regex_editor.hpp"
 #include "regex_optimizations.hpp"
+#include "search_options.hpp"
 #include "utils.hpp"
 
 #include <cassert>
 #include <chrono>
 #include <cstdlib>
+#include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -67,6 +73,92 @@ read_grid()
     return GridReader::read(input_filepath);
 }
 
+// Instead of solving the grid, replace each of its regexes with '.*',
+// then restore it, as a puzzle author editing the grid would (see
+// RegexEditor), and report the times from the edits to their answers.
+void
+report_edit_benchmark()
+{
+    RegexEditor editor(read_grid(),
+                       CommandLine::regex_optimizations(),
+                       CommandLine::search_options());
+
+    for (size_t i = 0; i != editor.num_lines(); ++i)
+    {
+        for (size_t j = 0; j != editor.num_regexes(i); ++j)
+        {
+            const auto regex = editor.regex(i, j);
+
+            editor.replace_regex(i, j, ".*");
+            editor.replace_regex(i, j, regex);
+        }
+    }
+
+    cout << "regex edit statistics:" << endl;
+
+    for (const auto& line : editor.print_statistics())
+    {
+        cout << line << endl;
+    }
+}
+
+void
+report_kernel_statistics(const Grid& grid)
+{
+    cout << endl;
+    cout << "regex kernel statistics:" << endl;
+
+    for (const auto& line : grid.print_kernel_statistics())
+    {
+        cout << line << endl;
+    }
+}
+
+void
+report_optimization_statistics(const RegexOptimizationStatistics& statistics)
+{
+    cout << endl;
+    cout << "regex optimization statistics:" << endl;
+
+    for (const auto& line : statistics.print())
+    {
+        cout << line << endl;
+    }
+}
+
+// Instead of solving the grid, estimate the cost of searching it (see
+// SearchCostEstimate), and report that estimate.
+void
+report_search_cost_estimate()
+{
+    auto grid = read_grid();
+    grid->optimize(CommandLine::regex_optimizations());
+
+    const auto estimate =
+        grid->estimate_search_cost(
+                CommandLine::search_cost_estimate_time_budget_ms(),
+                CommandLine::search_options());
+
+    cout << "search cost estimate:" << endl;
+
+    for (const auto& line : estimate.print())
+    {
+        cout << line << endl;
+    }
+}
+
+void
+report_search_statistics(const Grid& grid)
+{
+    cout << endl;
+    cout << "search statistics:" << endl;
+
+    for (const auto& line : grid.print_search_statistics())
+    {
+        cout << line << endl;
+    }
+}
+
 void
 report_time_to_solve(double time_to_solve_ms)
 {
@@ -94,17 +186,87 @@ throwing_main(int argc, const char* const* argv)
         return;
     }
 
+    if (CommandLine::edit_benchmark_is_requested())
+    {
+        report_edit_benchmark();
+        return;
+    }
+
+    if (CommandLine::search_cost_estimate_is_requested())
+    {
+        report_search_cost_estimate();
+        return;
+    }
+
     const auto num_solutions_to_find = CommandLine::num_solutions_to_find();
 
     const auto time_at_start = chrono::high_resolution_clock::now();
 
-    const auto grid = read_grid();
-    grid->optimize(CommandLine::regex_optimizations());
-    const auto solutions = grid->solve(num_solutions_to_find);
+    const Portfolio::Configuration configuration =
+        { CommandLine::regex_optimizations(), CommandLine::search_options() };
+    const auto configurations =
+        Portfolio::configurations(configuration,
+                                  CommandLine::portfolio_size());
+
+    // Each worker of the portfolio solves its own grid (see Portfolio).
+    vector<unique_ptr<Grid>> grids;
+    vector<RegexOptimizationStatistics>
+        optimization_statistics(configurations.size());
+
+    for (size_t i = 0; i != configurations.size(); ++i)
+    {
+        auto grid = read_grid();
+
+        if (CommandLine::optimization_statistics_are_requested())
+        {
+            grid->optimize(configurations[i].optimizations,
+                           optimization_statistics[i]);
+        }
+        else
+        {
+            grid->optimize(configurations[i].optimizations);
+        }
+
+        grids.push_back(move(grid));
+    }
+
+    Portfolio portfolio(configurations, move(grids));
+    const auto solutions = portfolio.solve(num_solutions_to_find);
 
     const auto time_at_end = chrono::high_resolution_clock::now();
 
+    const auto winning_worker = portfolio.winning_worker();
+    const auto& grid = portfolio.winning_grid();
+
+    if (configurations.size() > 1)
+    {
+        Utils::print_verbose_message(
+          cout,
+          "solved by worker " + Utils::to_string(winning_worker) +
+          " of the portfolio (strategy '" +
+          SearchOptions::name(
+            configurations[winning_worker].search_options.strategy()) +
+          "')");
+    }
+
     Grid::report_solutions(solutions, num_solutions_to_find);
+
+    if (CommandLine::kernel_statistics_are_requested())
+    {
+        report_kernel_statistics(grid);
+    }
+
+    if (CommandLine::optimization_statistics_are_requested())
+    {
+        report_optimization_statistics(
+          optimization_statistics[winning_worker]);
+    }
+
+    if (CommandLine::search_statistics_are_requested())
+    {
+        report_search_statistics(grid);
+    }
+
     report_time_to_solve(duration_ms(time_at_start, time_at_end));
 }
 
@@ -0,0 +1,241 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "portfolio.hpp"
+
+#include "grid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+
+namespace
+{
+
+// The strategies which the workers of a portfolio cycle through, in
+// that order (see Portfolio::configurations()).
+const SearchOptions::Strategy g_strategies[] =
+{
+    SearchOptions::Strategy::DEPTH_FIRST,
+    SearchOptions::Strategy::LUBY_RESTARTS,
+    SearchOptions::Strategy::LIMITED_DISCREPANCY,
+    SearchOptions::Strategy::GEOMETRIC_RESTARTS
+};
+
+const size_t g_num_strategies = sizeof(g_strategies) / sizeof(g_strategies[0]);
+
+} // unnamed namespace
+
+
+// instance creation and deletion
+
+// Create a portfolio whose workers solve 'grids', each with the
+// configuration at the same index in 'configurations'.
+//
+// Precondition:
+// * 'grids' and 'configurations' have the same, non-zero, size
+// * the regexes of each grid are optimized with the optimizations of
+//   its configuration
+Portfolio::Portfolio(const vector<Configuration>& configurations,
+                     vector<unique_ptr<Grid>>     grids) :
+  m_configurations(configurations),
+  m_grids(move(grids)),
+  m_winning_worker(m_grids.size())
+{
+    assert(!m_grids.empty());
+    assert(m_grids.size() == m_configurations.size());
+}
+
+Portfolio::~Portfolio() = default;
+
+// accessing
+
+// Return the configurations of 'num_workers' workers, diversified from
+// 'base_configuration', which is the first of them. The configuration
+// with index 'i':
+// * uses the strategy (see SearchOptions::Strategy) which comes 'i'
+//   places after that of 'base_configuration' in 'g_strategies'
+// * toggles the regex optimizations of 'base_configuration' (all or
+//   none) if 'i' / 4 is odd
+// * toggles the branching (see SearchOptions::Branching) of
+//   'base_configuration' if 'i' / 8 is odd
+// * toggles whether 'base_configuration' branches on lines if 'i' / 16
+//   is odd
+// * seeds the random order of its branches with the seed of
+//   'base_configuration' plus 'i'
+//
+// Precondition:
+// * num_workers != 0
+vector<Portfolio::Configuration>
+Portfolio::configurations(const Configuration& base_configuration,
+                          size_t               num_workers)
+{
+    assert(num_workers != 0);
+
+    const auto& base_options = base_configuration.search_options;
+    const auto base_strategy_index =
+        static_cast<size_t>(find(begin(g_strategies),
+                                 end(g_strategies),
+                                 base_options.strategy()) -
+                            begin(g_strategies));
+    const auto toggled_optimizations =
+        base_configuration.optimizations.enabled_passes().empty() ?
+        RegexOptimizations::all()                                 :
+        RegexOptimizations::none();
+    const auto toggled_branching =
+        base_options.branching() == SearchOptions::Branching::CHARACTERS ?
+        SearchOptions::Branching::HALVES                                 :
+        SearchOptions::Branching::CHARACTERS;
+
+    vector<Configuration> result;
+
+    for (size_t i = 0; i != num_workers; ++i)
+    {
+        auto configuration = base_configuration;
+        auto& options = configuration.search_options;
+
+        options.set_strategy(
+          g_strategies[(base_strategy_index + i) % g_num_strategies]);
+
+        if ((i / 4) % 2 == 1)
+        {
+            configuration.optimizations = toggled_optimizations;
+        }
+
+        if ((i / 8) % 2 == 1)
+        {
+            options.set_branching(toggled_branching);
+        }
+
+        if ((i / 16) % 2 == 1)
+        {
+            options.set_branches_on_lines(!base_options.branches_on_lines());
+        }
+
+        options.set_seed(base_options.seed() + static_cast<unsigned int>(i));
+        result.push_back(configuration);
+    }
+
+    return result;
+}
+
+// Return the grid of the worker which finished first, whose search
+// statistics (see Grid::print_search_statistics()) are those of the
+// solutions returned by solve().
+//
+// Precondition:
+// * solve() was called
+const Grid&
+Portfolio::winning_grid() const
+{
+    return *m_grids[winning_worker()];
+}
+
+// Return the index of the worker which finished first.
+//
+// Precondition:
+// * solve() was called
+size_t
+Portfolio::winning_worker() const
+{
+    assert(m_winning_worker < m_grids.size());
+    return m_winning_worker;
+}
+
+// modifying
+
+// Solve the grid with all the workers, and return the solutions found
+// by the worker which finishes first (see Grid::solve()).
+//
+// Precondition:
+// * num_solutions_to_find != 0
+vector<unique_ptr<Grid>>
+Portfolio::solve(unsigned int num_solutions_to_find)
+{
+    assert(num_solutions_to_find != 0);
+
+    const auto num_workers = m_grids.size();
+
+    if (num_workers == 1)
+    {
+        m_winning_worker = 0;
+        return m_grids[0]->solve(num_solutions_to_find,
+                                 m_configurations[0].search_options);
+    }
+
+    // Set by the first worker which finishes, which cancels the others.
+    atomic<bool> is_finished(false);
+
+    vector<vector<unique_ptr<Grid>>> solutions(num_workers);
+    vector<exception_ptr> exceptions(num_workers);
+    vector<thread> threads;
+
+    for (size_t i = 0; i != num_workers; ++i)
+    {
+        threads.emplace_back(
+          [this, i, num_solutions_to_find,
+           &is_finished, &solutions, &exceptions]()
+          {
+              try
+              {
+                  solutions[i] =
+                      m_grids[i]->solve(num_solutions_to_find,
+                                        m_configurations[i].search_options,
+                                        &is_finished);
+
+                  // A worker which returns after 'is_finished' was set
+                  // was cancelled, and its solutions may be incomplete.
+                  if (!is_finished.exchange(true))
+                  {
+                      m_winning_worker = i;
+                  }
+              }
+              catch (...)
+              {
+                  exceptions[i] = current_exception();
+              }
+          });
+    }
+
+    for (auto& thread_ : threads)
+    {
+        thread_.join();
+    }
+
+    // If no worker finished, all of them threw an exception.
+    if (m_winning_worker == num_workers)
+    {
+        rethrow_exception(exceptions.front());
+    }
+
+    return move(solutions[m_winning_worker]);
+}
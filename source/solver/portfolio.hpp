@@ -0,0 +1,94 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef PORTFOLIO_HPP
+#define PORTFOLIO_HPP
+
+#include "regex_optimizations.hpp"
+#include "search_options.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class Grid;
+
+
+// An instance of this class solves a grid with several configurations
+// of the solver (see Configuration) at once, each in its own thread (a
+// "worker"), and keeps the result of the first worker which finishes.
+// The other workers are then cancelled.
+//
+// Different grids are solved fastest by different configurations, and
+// which one is not known in advance. A portfolio is seldom much slower
+// than its fastest configuration for a given grid, which makes the time
+// to solve grids more predictable.
+//
+// Each worker solves its own copy of the grid, because solving a grid
+// modifies it. These copies are read, and their regexes optimized, in
+// the calling thread, before the portfolio is created: reading a grid
+// sets the alphabet (see Alphabet) and fills a cache of profiles (see
+// GridLineRegex::profile()), which are shared by all the grids.
+class Portfolio final
+{
+public:
+    // How a worker optimizes the regexes of its grid, and searches it.
+    struct Configuration
+    {
+        RegexOptimizations optimizations;
+        SearchOptions      search_options;
+    };
+
+    // instance creation and deletion
+    Portfolio(const std::vector<Configuration>& configurations,
+              std::vector<std::unique_ptr<Grid>> grids);
+    ~Portfolio();
+
+    // accessing
+    static std::vector<Configuration>
+        configurations(const Configuration& base_configuration,
+                       size_t               num_workers);
+    const Grid& winning_grid() const;
+    size_t winning_worker() const;
+
+    // modifying
+    std::vector<std::unique_ptr<Grid>>
+        solve(unsigned int num_solutions_to_find);
+
+private:
+    // data members
+
+    // The configuration of each worker, and the grid which it solves.
+    std::vector<Configuration> m_configurations;
+    std::vector<std::unique_ptr<Grid>> m_grids;
+
+    // The index of the worker which finished first, or the number of
+    // workers if solve() was not called yet.
+    size_t m_winning_worker;
+};
+
+
+#endif // PORTFOLIO_HPP
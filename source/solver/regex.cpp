@@ -26,6 +26,8 @@
 
 #include "regex.hpp"
 
+#include "alphabet.hpp"
+#include "automaton.hpp"
 #include "backreference_numbers.hpp"
 #include "character_block.hpp"
 #include "constraint.hpp"
@@ -43,6 +45,85 @@
 using namespace std;
 
 
+namespace
+{
+
+// Return the lengths which are the sum of a length of 'lengths_1' and
+// of a length of 'lengths_2', ignoring the sums greater than
+// 'max_length'. Each argument and the result contain, for each length
+// from 0 to 'max_length', whether that length belongs to the set.
+vector<bool>
+sum_of_lengths(const vector<bool>& lengths_1,
+               const vector<bool>& lengths_2,
+               size_t              max_length)
+{
+    assert(lengths_1.size() == max_length + 1);
+    assert(lengths_2.size() == max_length + 1);
+
+    vector<bool> result(max_length + 1, false);
+
+    for (size_t i = 0; i <= max_length; ++i)
+    {
+        if (!lengths_1[i])
+        {
+            continue;
+        }
+
+        for (size_t j = 0; i + j <= max_length; ++j)
+        {
+            if (lengths_2[j])
+            {
+                result[i + j] = true;
+            }
+        }
+    }
+
+    return result;
+}
+
+// Return whether 'constraint' certainly prevents a word boundary (if
+// 'at_word_boundary' is true) or certainly requires one (otherwise) at
+// position 'pos'. This is the case when the characters around 'pos'
+// are known to be only word characters or only non-word characters.
+//
+// For example, '\b' is impossible between positions which allow only
+// word characters, such as in { "AB", "C" } at position 1.
+bool
+word_boundary_is_impossible(const Constraint& constraint,
+                            size_t            pos,
+                            bool              at_word_boundary)
+{
+    const auto size = constraint.size();
+
+    if (size == 0)
+    {
+        return true;
+    }
+
+    // outside of the constraint, there are only non-word characters
+    const auto only_word_characters_before =
+        pos != 0 && constraint[pos - 1].has_only_word_characters();
+    const auto only_non_word_characters_before =
+        pos == 0 || constraint[pos - 1].has_only_non_word_characters();
+    const auto only_word_characters_after =
+        pos != size && constraint[pos].has_only_word_characters();
+    const auto only_non_word_characters_after =
+        pos == size || constraint[pos].has_only_non_word_characters();
+
+    const auto same_kinds =
+        (only_word_characters_before && only_word_characters_after) ||
+        (only_non_word_characters_before && only_non_word_characters_after);
+
+    const auto different_kinds =
+        (only_word_characters_before && only_non_word_characters_after) ||
+        (only_non_word_characters_before && only_word_characters_after);
+
+    return at_word_boundary ? same_kinds : different_kinds;
+}
+
+} // unnamed namespace
+
+
 // Regex
 // -----
 
@@ -51,12 +132,102 @@ using namespace std;
 Regex::Regex() :
   m_parent(nullptr),
   m_constraint_size(0),
+  m_constraint_being_constrained(nullptr),
+  m_root(nullptr),
   m_begin_pos(0)
 {
 }
 
 Regex::~Regex() = default;
 
+// Return the concatenation of 'regexes', as a right-leaning tree of
+// ConcatenationRegex'es.
+//
+// If 'regexes' is empty, return an EpsilonRegex. If 'regexes' contains
+// a single regex, return it.
+unique_ptr<Regex>
+Regex::concatenation_of(vector<unique_ptr<Regex>> regexes)
+{
+    if (regexes.empty())
+    {
+        return Utils::make_unique<EpsilonRegex>();
+    }
+
+    auto result = move(regexes.back());
+    regexes.pop_back();
+
+    while (!regexes.empty())
+    {
+        result = Utils::make_unique<ConcatenationRegex>(move(regexes.back()),
+                                                        move(result));
+        regexes.pop_back();
+    }
+
+    return result;
+}
+
+// Return a regex which repeats 'child' from 'min_count' to 'max_count'
+// times, using the most specific subclass of RepetitionRegex.
+unique_ptr<Regex>
+Regex::repetition_of(unique_ptr<Regex>      child,
+                     const RepetitionCount& min_count,
+                     const RepetitionCount& max_count)
+{
+    const auto infinite = RepetitionCount::infinite();
+
+    if (min_count == 0 && max_count == infinite)
+    {
+        return Utils::make_unique<KleeneStarRegex>(move(child));
+    }
+    else if (min_count == 1 && max_count == infinite)
+    {
+        return Utils::make_unique<PlusRegex>(move(child));
+    }
+    else if (min_count == 0 && max_count == 1)
+    {
+        return Utils::make_unique<QuestionMarkRegex>(move(child));
+    }
+    else if (min_count == max_count)
+    {
+        return Utils::make_unique<FixedRepetitionRegex>(move(child),
+                                                        min_count);
+    }
+    else if (max_count == infinite)
+    {
+        return Utils::make_unique<RangeRepetitionToInfinityRegex>(
+                        move(child), min_count);
+    }
+    else
+    {
+        return Utils::make_unique<RangeRepetitionRegex>(move(child),
+                                                        min_count,
+                                                        max_count);
+    }
+}
+
+// Return the union of 'regexes', as a right-leaning tree of
+// UnionRegex'es.
+//
+// Precondition:
+// * 'regexes' is not empty
+unique_ptr<Regex>
+Regex::union_of(vector<unique_ptr<Regex>> regexes)
+{
+    assert(!regexes.empty());
+
+    auto result = move(regexes.back());
+    regexes.pop_back();
+
+    while (!regexes.empty())
+    {
+        result = Utils::make_unique<UnionRegex>(move(regexes.back()),
+                                                move(result));
+        regexes.pop_back();
+    }
+
+    return result;
+}
+
 // Return a 'unique_ptr' to 'optimized_regex', which is an optimized
 // version of 'regex'. 'parent' is to be the parent of
 // 'optimized_regex'.
@@ -95,6 +266,24 @@ Regex::clone() const
 
 // accessing
 
+// Add to 'automaton' the states and transitions which recognize the
+// strings of 'regex' from state 'from' to state 'to', and return true.
+// Return false if 'regex' cannot be represented as an automaton (see
+// get_automaton()), in which case 'automaton' is unspecified.
+//
+// Repetitions of more than 'max_length' + 1 copies are represented by
+// 'max_length' + 1 copies, which match the same strings of up to
+// 'max_length' characters.
+bool
+Regex::add_to_automaton(const Regex& regex,
+                        Automaton&   automaton,
+                        size_t       from,
+                        size_t       to,
+                        size_t       max_length)
+{
+    return regex.do_add_to_automaton(automaton, from, to, max_length);
+}
+
 // Return the backreferences which are equal to 'regex' or descent from
 // 'regex', and which reference 'group_number'.
 vector<const BackreferenceRegex*>
@@ -117,6 +306,27 @@ Regex::begin_pos() const
     return m_begin_pos;
 }
 
+// Return the regexes which are concatenated in 'regex':
+// * if 'regex' is a ConcatenationRegex, its operands
+// * if 'regex' is an EpsilonRegex, nothing
+// * otherwise, 'regex' itself
+vector<const Regex*>
+Regex::concatenated_regexes(const Regex& regex)
+{
+    if (is_concatenation(regex))
+    {
+        return static_cast<const ConcatenationRegex&>(regex).operands();
+    }
+    else if (is_epsilon(regex))
+    {
+        return {};
+    }
+    else
+    {
+        return { &regex };
+    }
+}
+
 // Return the constraint that results from all possible values of this
 // regex applied to 'constraint'.
 //
@@ -137,10 +347,42 @@ Regex::begin_pos() const
 Constraint
 Regex::constrain(const Constraint& constraint)
 {
-    set_constraint_size(constraint.size());
+    vector<Constraint>* const supports = nullptr;
+    return constrain(constraint, supports);
+}
+
+// Same as constrain(const Constraint&), except that 'supports' is set
+// to the constraints yielded by some of the values of this regex, such
+// that each possible character of the returned constraint is possible
+// in at least one of them.
+//
+// In the example of constrain(const Constraint&), 'supports' would be
+// set to { { "A", "B", "BC" }, { "B", "BC", "A" }, { "B", "BC", "D" } }
+// (each of these constraints adds a character to the ones before it).
+Constraint
+Regex::constrain(const Constraint& constraint, vector<Constraint>& supports)
+{
+    supports.clear();
+    return constrain(constraint, &supports);
+}
+
+// Implement the public constrain() methods: 'supports' is nullptr if
+// the caller does not need the supports.
+Constraint
+Regex::constrain(const Constraint& constraint, vector<Constraint>* supports)
+{
+    // Setting the constraint size walks the whole tree, so it is only
+    // done when the size changes: a regex of a grid line is always
+    // applied to constraints of the same size.
+    if (constraint_size_is_not_set() || constraint.size() != m_constraint_size)
+    {
+        set_constraint_size(constraint.size());
+    }
 
     auto new_constraint = Constraint::none(constraint.size());
 
+    m_constraint_being_constrained = &constraint;
+
     rewind();
 
     while (not_at_end())
@@ -151,6 +393,13 @@ Regex::constrain(const Constraint& constraint)
 
             if (constrain_with_current_value(constraint_copy))
             {
+                if (supports != nullptr &&
+                    !constraint_copy.is_tighter_than_or_equal_to(
+                                                        new_constraint))
+                {
+                    supports->push_back(constraint_copy);
+                }
+
                 new_constraint |= constraint_copy;
             }
         }
@@ -158,6 +407,8 @@ Regex::constrain(const Constraint& constraint)
         increment();
     }
 
+    m_constraint_being_constrained = nullptr;
+
     assert(new_constraint.is_tighter_than_or_equal_to(constraint));
     return new_constraint;
 }
@@ -198,6 +449,44 @@ Regex::constrain_as_positive_lookahead(Constraint& constraint, size_t begin_pos)
     return constraint.is_possible();
 }
 
+vector<Constraint>
+Regex::constraints_as_positive_lookahead(Regex&            regex,
+                                         const Constraint& constraint,
+                                         size_t            begin_pos)
+{
+    return regex.constraints_as_positive_lookahead(constraint, begin_pos);
+}
+
+// Return the constraints which the values of this regex allow when it
+// is applied as a positive lookahead to 'constraint', from
+// 'begin_pos'. constrain_as_positive_lookahead() would return the OR of
+// these constraints.
+vector<Constraint>
+Regex::constraints_as_positive_lookahead(const Constraint& constraint,
+                                         size_t            begin_pos)
+{
+    vector<Constraint> result;
+
+    rewind(begin_pos);
+
+    while (not_at_end())
+    {
+        if (value_fits())
+        {
+            auto constraint_copy = constraint;
+
+            if (constrain_with_current_value(constraint_copy))
+            {
+                result.push_back(constraint_copy);
+            }
+        }
+
+        increment();
+    }
+
+    return result;
+}
+
 bool
 Regex::constrain_once_with_current_value(Regex&      regex,
                                          Constraint& constraint,
@@ -330,6 +619,23 @@ Regex::constrain_word_boundaries_with_current_value(Constraint& constraint)
     return do_constrain_word_boundaries_with_current_value(constraint);
 }
 
+// Return the constraint which the root of this regex is constraining,
+// if constrain() or constraints() is running on that root, or 'nullptr'
+// otherwise.
+//
+// Sub-regexes may use this constraint to skip values which cannot
+// possibly satisfy it, see UnionRegex::child_can_be_skipped().
+const Constraint*
+Regex::constraint_being_constrained() const
+{
+    if (m_root == nullptr)
+    {
+        m_root = &root();
+    }
+
+    return m_root->m_constraint_being_constrained;
+}
+
 size_t
 Regex::constraint_size() const
 {
@@ -353,6 +659,8 @@ Regex::constraints(const Constraint& constraint, size_t begin_pos)
 
     set_constraint_size(constraint.size());
 
+    m_constraint_being_constrained = &constraint;
+
     rewind(begin_pos);
 
     while (not_at_end())
@@ -367,6 +675,8 @@ Regex::constraints(const Constraint& constraint, size_t begin_pos)
         increment();
     }
 
+    m_constraint_being_constrained = nullptr;
+
     return result;
 }
 
@@ -424,6 +734,15 @@ Regex::end_pos() const
     return m_begin_pos + length_of_current_value();
 }
 
+// Return the characters which the non-empty values of 'regex' may
+// start with. This is a superset of the actual first characters: it
+// ignores the constraints that backreferences put on groups.
+SetOfCharacters
+Regex::first_characters(const Regex& regex)
+{
+    return regex.do_first_characters();
+}
+
 // Return the characters which appear explicitly in this regex.
 string
 Regex::explicit_characters() const
@@ -431,6 +750,51 @@ Regex::explicit_characters() const
     return do_explicit_characters();
 }
 
+// If this regex can be represented as an automaton, set 'automaton' to
+// an automaton which recognizes the same strings of 'length'
+// characters, and return true. Otherwise, return false, in which case
+// 'automaton' is unspecified.
+//
+// Only regexes with exact values (see has_exact_values()) can be
+// represented as automata, and only if the automaton is not too large.
+bool
+Regex::get_automaton(Automaton& automaton, size_t length) const
+{
+    automaton = Automaton();
+    return add_to_automaton(*this,
+                            automaton,
+                            Automaton::initial_state(),
+                            Automaton::final_state(),
+                            length);
+}
+
+// If 'regex' is made of pieces which the regex kernels support (see
+// RegexKernel), add them to 'pieces' and return true. Otherwise,
+// return false, in which case 'pieces' is unspecified.
+bool
+Regex::get_kernel_pieces(const Regex&              regex,
+                         vector<RegexKernelPiece>& pieces)
+{
+    return regex.do_get_kernel_pieces(pieces);
+}
+
+bool
+Regex::get_kernel_pieces(vector<RegexKernelPiece>& pieces) const
+{
+    return get_kernel_pieces(*this, pieces);
+}
+
+// If 'regex' matches a finite set of strings of character blocks (for
+// example, 'D[IS]|N(S|T)' matches 'D[IS]', 'NS' and 'NT'), add them to
+// 'strings' and return true. Otherwise, return false, in which case
+// 'strings' is unspecified.
+bool
+Regex::get_kernel_strings(const Regex&               regex,
+                          vector<RegexKernelString>& strings)
+{
+    return regex.do_get_kernel_strings(strings);
+}
+
 // Add to 'used_backreference_numbers' the backreference numbers used
 // in 'regex'.
 //
@@ -470,6 +834,145 @@ Regex::length_of_current_value() const
     return do_length_of_current_value();
 }
 
+// Return the maximum number of times 'regex' repeats the regex returned
+// by repeated_regex().
+RepetitionCount
+Regex::max_repetition_count(const Regex& regex)
+{
+    return regex.do_max_repetition_count();
+}
+
+// Return a lower bound of the length of the values of 'regex'.
+size_t
+Regex::min_length(const Regex& regex)
+{
+    return regex.do_min_length();
+}
+
+// Return the minimum number of times 'regex' repeats the regex returned
+// by repeated_regex().
+RepetitionCount
+Regex::min_repetition_count(const Regex& regex)
+{
+    return regex.do_min_repetition_count();
+}
+
+RepetitionCount
+Regex::do_max_repetition_count() const
+{
+    return 1;
+}
+
+// By default, a regex is assumed to possibly have an empty value.
+size_t
+Regex::do_min_length() const
+{
+    return 0;
+}
+
+RepetitionCount
+Regex::do_min_repetition_count() const
+{
+    return 1;
+}
+
+// By default, a regex cannot be represented as an automaton (e.g., a
+// backreference).
+bool
+Regex::do_add_to_automaton(Automaton& /*automaton*/,
+                           size_t     /*from*/,
+                           size_t     /*to*/,
+                           size_t     /*max_length*/) const
+{
+    return false;
+}
+
+const Regex&
+Regex::do_repeated_regex() const
+{
+    return *this;
+}
+
+// By default, a regex has no non-empty value (e.g., an epsilon).
+SetOfCharacters
+Regex::do_first_characters() const
+{
+    return SetOfCharacters();
+}
+
+// By default, a regex is a single piece which matches its strings once.
+bool
+Regex::do_get_kernel_pieces(vector<RegexKernelPiece>& pieces) const
+{
+    vector<RegexKernelString> strings;
+
+    if (!get_kernel_strings(*this, strings))
+    {
+        return false;
+    }
+
+    pieces.push_back(RegexKernelPiece(move(strings), 1, 1));
+    return true;
+}
+
+bool
+Regex::do_get_kernel_strings(vector<RegexKernelString>& /*strings*/) const
+{
+    return false;
+}
+
+RequiredLiterals
+Regex::do_required_literals() const
+{
+    return RequiredLiterals::none();
+}
+
+SetOfCharacters
+Regex::do_single_characters() const
+{
+    return SetOfCharacters();
+}
+
+vector<bool>
+Regex::do_universal_lengths(size_t max_length) const
+{
+    return vector<bool>(max_length + 1, false);
+}
+
+// Return the number of values of this regex which fit within
+// 'constraint_size' characters, i.e., the number of iterations which
+// Regex::constrain() does on a constraint of that size.
+size_t
+Regex::num_enumeration_steps(size_t constraint_size)
+{
+    set_constraint_size(constraint_size);
+
+    size_t result = 0;
+
+    rewind();
+
+    while (not_at_end())
+    {
+        ++result;
+        increment();
+    }
+
+    return result;
+}
+
+size_t
+Regex::num_nodes(const Regex& regex)
+{
+    return regex.num_nodes();
+}
+
+// Return the number of nodes of the parse tree of this regex.
+size_t
+Regex::num_nodes() const
+{
+    return do_num_nodes();
+}
+
 Regex*
 Regex::parent(const Regex& regex)
 {
@@ -492,6 +995,17 @@ Regex::parse(const string& regex_as_string)
     return regex;
 }
 
+// Return the literals which appear in every string matched by this
+// regex (see RequiredLiterals).
+//
+// Precondition:
+// * the alphabet is set
+RequiredLiterals
+Regex::required_literals() const
+{
+    return do_required_literals();
+}
+
 // Return the rightmost active GroupRegex numbered 'group_number' which
 // is, in the parse tree, to the left of the path which goes from the
 // root to 'from_child', knowing that 'from_child' is a child of
@@ -594,6 +1108,14 @@ Regex::rightmost_group_from_parent(const GroupNumber& group_number) const
     return m_parent->do_rightmost_group(group_number, this);
 }
 
+// If 'regex' is a RepetitionRegex, return the regex which it repeats.
+// Otherwise, return 'regex' itself (which is then repeated once).
+const Regex&
+Regex::repeated_regex(const Regex& regex)
+{
+    return regex.do_repeated_regex();
+}
+
 // Return the root of the parse tree of this regex.
 const Regex&
 Regex::root() const
@@ -606,6 +1128,57 @@ Regex::root() const
     return parent()->root();
 }
 
+// Return the characters c such that 'regex' is known to match the
+// single-character string c. The result may be a subset of the actual
+// characters (for example, the characters matched through a
+// backreference are ignored).
+SetOfCharacters
+Regex::single_characters(const Regex& regex)
+{
+    return regex.do_single_characters();
+}
+
+// Same as concatenated_regexes(), except that 'regex' is consumed and
+// its concatenated regexes are returned.
+vector<unique_ptr<Regex>>
+Regex::split_concatenation(unique_ptr<Regex> regex)
+{
+    if (is_concatenation(*regex))
+    {
+        return downcast<ConcatenationRegex>(*regex).steal_operands();
+    }
+
+    vector<unique_ptr<Regex>> result;
+
+    if (!is_epsilon(*regex))
+    {
+        result.push_back(move(regex));
+    }
+
+    return result;
+}
+
+// Return, for each length from 0 to 'max_length', whether 'regex' is
+// known to match all the strings of that length over the alphabet.
+// A false element means that 'regex' is not known to be universal for
+// that length, not that it is known not to be.
+//
+// Precondition:
+// * the alphabet is set
+vector<bool>
+Regex::universal_lengths(const Regex& regex, size_t max_length)
+{
+    auto result = regex.do_universal_lengths(max_length);
+
+    if (max_length >= 1 &&
+        single_characters(regex) == Alphabet::characters())
+    {
+        result[1] = true;
+    }
+
+    return result;
+}
+
 // If this regex is a group regex, return it. Otherwise, return the
 // group regex that encloses this regex, or 'nullptr' if there is no
 // such group regex.
@@ -626,6 +1199,23 @@ Regex::yourself_or_enclosing_lookahead() const
 
 // querying
 
+// Return whether 'regex_1' and 'regex_2' are CharacterBlockRegex'es or
+// StringRegex'es which match the same characters.
+//
+// The explicit characters are compared too, because to_string() does
+// not tell apart, e.g., '.' (any character) from '\.' (a dot).
+bool
+Regex::are_identical_blocks(const Regex& regex_1, const Regex& regex_2)
+{
+    const auto both_are_character_blocks =
+        is_character_block(regex_1) && is_character_block(regex_2);
+    const auto both_are_strings = is_string(regex_1) && is_string(regex_2);
+
+    return (both_are_character_blocks || both_are_strings) &&
+           regex_1.to_string() == regex_2.to_string() &&
+           regex_1.explicit_characters() == regex_2.explicit_characters();
+}
+
 bool
 Regex::at_end(const Regex& regex)
 {
@@ -699,6 +1289,14 @@ Regex::do_has_a_value() const
     return not_at_end();
 }
 
+// By default, a regex constrains each position independently of the
+// other positions.
+bool
+Regex::do_has_exact_values() const
+{
+    return true;
+}
+
 bool
 Regex::do_is_character_block() const
 {
@@ -717,6 +1315,18 @@ Regex::do_is_empty() const
     return false;
 }
 
+bool
+Regex::do_is_epsilon() const
+{
+    return false;
+}
+
+bool
+Regex::do_is_repetition() const
+{
+    return false;
+}
+
 bool
 Regex::do_is_string() const
 {
@@ -753,6 +1363,26 @@ Regex::has_a_value_which_fits() const
     return has_a_value() && value_fits();
 }
 
+bool
+Regex::has_exact_values(const Regex& regex)
+{
+    return regex.has_exact_values();
+}
+
+// Return whether each value of this regex matches all the strings which
+// fit in the constraint that it yields (see constrain()), i.e., whether
+// this regex has no backreferences, lookaheads or word boundaries.
+//
+// For example, the value '[AB]C' of '[AB]C|D' yields constraint
+// { "AB", "C" } from constraint { "ABCD", "ABCD" }, and both "AC" and
+// "BC" match. But the value of '(.)\1' yields constraint { "AB", "AB" }
+// from constraint { "AB", "AB" }, and neither "AB" nor "BA" matches.
+bool
+Regex::has_exact_values() const
+{
+    return do_has_exact_values();
+}
+
 // Return whether 'regex' is an ancestor of this regex.
 bool
 Regex::has_ancestor(const Regex* regex) const
@@ -784,6 +1414,22 @@ Regex::has_parent() const
     return m_parent != nullptr;
 }
 
+// Return whether this regex is known to match all the strings of
+// length 'length' over the alphabet. If so, a grid line of that length
+// is not constrained at all by this regex.
+//
+// For example, over the alphabet { C, R }, '[CR]*', '(.)*' and '.*.*'
+// are universal for any length, '[^X]{3}' is universal for length 3
+// only, and '(.)\1' is never known to be universal.
+//
+// Precondition:
+// * the alphabet is set
+bool
+Regex::is_universal(size_t length) const
+{
+    return universal_lengths(*this, length)[length];
+}
+
 bool
 Regex::is_character_block(const Regex& regex)
 {
@@ -802,6 +1448,18 @@ Regex::is_empty(const Regex& regex)
     return regex.do_is_empty();
 }
 
+bool
+Regex::is_epsilon(const Regex& regex)
+{
+    return regex.do_is_epsilon();
+}
+
+bool
+Regex::is_repetition(const Regex& regex)
+{
+    return regex.do_is_repetition();
+}
+
 bool
 Regex::is_root() const
 {
@@ -861,6 +1519,16 @@ Regex::value_fits_exactly() const
     return end_pos() == m_constraint_size;
 }
 
+// Return whether 'regex_1' followed by 'regex_2' can be replaced with a
+// single RepetitionRegex, as in 'A*A?' => 'A{0,}' or 'A+A' => 'A{2,}'.
+bool
+Regex::repetitions_can_be_merged(const Regex& regex_1, const Regex& regex_2)
+{
+    return (is_repetition(regex_1) || is_repetition(regex_2)) &&
+           are_identical_blocks(repeated_regex(regex_1),
+                                repeated_regex(regex_2));
+}
+
 // Return whether the current value of 'regex' is epsilon.
 bool
 Regex::value_is_epsilon(const Regex& regex)
@@ -921,6 +1589,7 @@ void
 Regex::do_set_constraint_size(size_t constraint_size)
 {
     m_constraint_size = constraint_size;
+    m_root = nullptr;
     m_begin_pos = invalid_begin_pos(constraint_size);
 
     set_constraint_size_of_children(constraint_size);
@@ -961,30 +1630,66 @@ Regex::increment()
     assert(at_end() || has_a_value_which_fits());
 }
 
+// Return the RepetitionRegex which is equivalent to 'regex_1' followed
+// by 'regex_2'.
+//
+// Precondition:
+// * repetitions_can_be_merged(*regex_1, *regex_2)
+unique_ptr<Regex>
+Regex::merge_repetitions(unique_ptr<Regex> regex_1, unique_ptr<Regex> regex_2)
+{
+    assert(repetitions_can_be_merged(*regex_1, *regex_2));
+
+    return repetition_of(repeated_regex(*regex_1).clone(),
+                         min_repetition_count(*regex_1) +
+                         min_repetition_count(*regex_2),
+                         max_repetition_count(*regex_1) +
+                         max_repetition_count(*regex_2));
+}
+
 // Optimize 'root' according to 'optimizations'.
 unique_ptr<Regex>
 Regex::optimize(unique_ptr<Regex>         root,
                 const RegexOptimizations& optimizations)
 {
     // The order of optimizations is important in order to get the best
-    // results.
-
-    if (optimizations.optimize_groups())
+    // results. 'optimizations' knows that order.
+    for (const auto type : optimizations.enabled_passes())
     {
-        root = optimize_groups_of_root(move(root));
+        root = optimize(move(root), type);
     }
 
-    if (optimizations.optimize_unions())
-    {
-        root = optimize_unions_of_root(move(root));
-    }
+    // The passes may have replaced some sub-regexes, so the next call
+    // to constrain() must set the constraint size of the whole tree.
+    root->unset_constraint_size();
+    return root;
+}
 
-    if (optimizations.optimize_concatenations())
+// Apply the optimization pass 'type' to 'root'.
+unique_ptr<Regex>
+Regex::optimize(unique_ptr<Regex> root, RegexOptimizations::Type type)
+{
+    switch (type)
     {
-        root = optimize_concatenations_of_root(move(root));
-    }
+    case RegexOptimizations::Type::CONCATENATIONS:
+        return optimize_concatenations_of_root(move(root));
 
-    return root;
+    case RegexOptimizations::Type::FACTORIZATIONS:
+        return optimize_factorizations_of_root(move(root));
+
+    case RegexOptimizations::Type::GROUPS:
+        return optimize_groups_of_root(move(root));
+
+    case RegexOptimizations::Type::REPETITIONS:
+        return optimize_repetitions_of_root(move(root));
+
+    case RegexOptimizations::Type::UNIONS:
+        return optimize_unions_of_root(move(root));
+
+    default:
+        assert(false);
+        return root;
+    }
 }
 
 unique_ptr<Regex>
@@ -1022,6 +1727,26 @@ Regex::optimize_concatenations_on_right(unique_ptr<Regex> regex)
     return optimized(move(regex), optimized_regex, parent);
 }
 
+unique_ptr<Regex>
+Regex::optimize_factorizations(unique_ptr<Regex> regex)
+{
+    const auto parent = regex->parent();
+    const auto optimized_regex = regex->do_optimize_factorizations();
+    return optimized(move(regex), optimized_regex, parent);
+}
+
+// Factor the common prefixes and suffixes out of the UnionRegex'es of
+// 'root'.
+unique_ptr<Regex>
+Regex::optimize_factorizations_of_root(unique_ptr<Regex> root)
+{
+    assert(root->is_root());
+
+    root = optimize_factorizations(move(root));
+    assert(root->parents_are_correctly_setup());
+    return root;
+}
+
 unique_ptr<Regex>
 Regex::optimize_groups(unique_ptr<Regex>           regex,
                        const BackreferenceNumbers& used_backreference_numbers)
@@ -1046,6 +1771,26 @@ Regex::optimize_groups_of_root(unique_ptr<Regex> root)
     return root;
 }
 
+unique_ptr<Regex>
+Regex::optimize_repetitions(unique_ptr<Regex> regex)
+{
+    const auto parent = regex->parent();
+    const auto optimized_regex = regex->do_optimize_repetitions();
+    return optimized(move(regex), optimized_regex, parent);
+}
+
+// Merge the adjacent RepetitionRegex'es of 'root' which repeat the same
+// character block.
+unique_ptr<Regex>
+Regex::optimize_repetitions_of_root(unique_ptr<Regex> root)
+{
+    assert(root->is_root());
+
+    root = optimize_repetitions(move(root));
+    assert(root->parents_are_correctly_setup());
+    return root;
+}
+
 unique_ptr<Regex>
 Regex::optimize_unions(unique_ptr<Regex> regex)
 {
@@ -1129,6 +1874,37 @@ Regex::set_constraint_size(size_t constraint_size)
     do_set_constraint_size(constraint_size);
 }
 
+// Specialize 'root' for values of exactly 'length' characters, i.e.,
+// for a grid line of 'length' cells:
+// * the maximum counts of the repetitions are clamped to the number of
+//   times their child fits in 'length' characters (e.g., 'A*' becomes
+//   'A{0,5}' for 5 cells)
+// * the branches of the unions which cannot fit in 'length' characters
+//   are removed (e.g., 'A|BBB' becomes 'A' for 2 cells), unless they
+//   contain groups
+//
+// The specialized regex has the same values of 'length' characters as
+// 'root', but enumerating them explores fewer values that cannot fit.
+unique_ptr<Regex>
+Regex::specialize(unique_ptr<Regex> root, size_t length)
+{
+    assert(root->is_root());
+
+    root = specialize_for_length(move(root), length);
+    assert(root->parents_are_correctly_setup());
+
+    root->unset_constraint_size();
+    return root;
+}
+
+unique_ptr<Regex>
+Regex::specialize_for_length(unique_ptr<Regex> regex, size_t length)
+{
+    const auto parent = regex->parent();
+    const auto specialized_regex = regex->do_specialize_for_length(length);
+    return optimized(move(regex), specialized_regex, parent);
+}
+
 void
 Regex::set_parent(Regex& regex, Regex* parent)
 {
@@ -1141,6 +1917,17 @@ Regex::set_parent(Regex* parent)
     m_parent = parent;
 }
 
+// Forget the constraint size of this regex and of its sub-regexes, so
+// that the next call to constrain() sets the constraint size of the
+// whole tree again. This also lets sub-regexes forget what they had
+// computed about their children, such as the first characters of the
+// children of a UnionRegex.
+void
+Regex::unset_constraint_size()
+{
+    set_constraint_size(0);
+}
+
 // error handling
 
 // Check that the lookaheads of this regex, if any, do not contain
@@ -1252,6 +2039,12 @@ NullaryRegex::do_get_used_backreference_numbers(
 {
 }
 
+size_t
+NullaryRegex::do_num_nodes() const
+{
+    return 1;
+}
+
 size_t
 NullaryRegex::do_length_of_current_value() const
 {
@@ -1298,6 +2091,16 @@ NullaryRegex::do_characters_were_constrained_by_backreference() const
     return false;
 }
 
+// Return whether the constraint being constrained, if any, certainly
+// makes the value of this regex fail from begin_pos(). Such a regex is
+// at its end as soon as it is rewound, so the values which contain it
+// are not enumerated.
+bool
+NullaryRegex::do_is_impossible_at_begin_pos() const
+{
+    return false;
+}
+
 // modifying
 
 void
@@ -1312,6 +2115,12 @@ NullaryRegex::do_optimize_concatenations()
     return this;
 }
 
+Regex*
+NullaryRegex::do_optimize_factorizations()
+{
+    return this;
+}
+
 Regex*
 NullaryRegex::do_optimize_groups(
                 const BackreferenceNumbers& /*used_backreference_numbers*/)
@@ -1319,6 +2128,12 @@ NullaryRegex::do_optimize_groups(
     return this;
 }
 
+Regex*
+NullaryRegex::do_optimize_repetitions()
+{
+    return this;
+}
+
 Regex*
 NullaryRegex::do_optimize_unions()
 {
@@ -1346,12 +2161,18 @@ NullaryRegex::do_rewind()
 {
     m_at_end = false;
 
-    if (!has_a_value_which_fits(*this))
+    if (!has_a_value_which_fits(*this) || do_is_impossible_at_begin_pos())
     {
         m_at_end = true;
     }
 }
 
+Regex*
+NullaryRegex::do_specialize_for_length(size_t /*length*/)
+{
+    return this;
+}
+
 void
 NullaryRegex::set_constraint_size_of_children(size_t /*constraint_size*/)
 {
@@ -1383,6 +2204,18 @@ EmptyRegex::do_clone() const
     return Utils::make_unique<EmptyRegex>();
 }
 
+// accessing
+
+// An empty regex matches no strings, so it adds no transitions.
+bool
+EmptyRegex::do_add_to_automaton(Automaton& /*automaton*/,
+                                size_t     /*from*/,
+                                size_t     /*to*/,
+                                size_t     /*max_length*/) const
+{
+    return true;
+}
+
 // querying
 
 bool
@@ -1417,17 +2250,50 @@ EmptyRegex::do_to_string() const
 
 // instance creation and deletion
 
-EpsilonRegex::EpsilonRegex()
+EpsilonRegex::EpsilonRegex()
+{
+    assert(class_invariant());
+}
+
+// copying
+
+unique_ptr<Regex>
+EpsilonRegex::do_clone() const
+{
+    return Utils::make_unique<EpsilonRegex>();
+}
+
+// accessing
+
+bool
+EpsilonRegex::do_add_to_automaton(Automaton& automaton,
+                                  size_t     from,
+                                  size_t     to,
+                                  size_t     /*max_length*/) const
+{
+    automaton.add_epsilon_transition(from, to);
+    return true;
+}
+
+bool
+EpsilonRegex::do_get_kernel_strings(vector<RegexKernelString>& strings) const
+{
+    strings.push_back(RegexKernelString());
+    return true;
+}
+
+RequiredLiterals
+EpsilonRegex::do_required_literals() const
 {
-    assert(class_invariant());
+    return RequiredLiterals::epsilon();
 }
 
-// copying
-
-unique_ptr<Regex>
-EpsilonRegex::do_clone() const
+vector<bool>
+EpsilonRegex::do_universal_lengths(size_t max_length) const
 {
-    return Utils::make_unique<EpsilonRegex>();
+    vector<bool> result(max_length + 1, false);
+    result[0] = true;
+    return result;
 }
 
 // querying
@@ -1438,6 +2304,12 @@ EpsilonRegex::do_can_be_concatenated() const
     return true;
 }
 
+bool
+EpsilonRegex::do_is_epsilon() const
+{
+    return true;
+}
+
 // converting
 
 string
@@ -1467,6 +2339,16 @@ EpsilonAtStartRegex::do_clone() const
 
 // accessing
 
+bool
+EpsilonAtStartRegex::do_add_to_automaton(Automaton& automaton,
+                                         size_t     from,
+                                         size_t     to,
+                                         size_t     /*max_length*/) const
+{
+    automaton.add_epsilon_transition(from, to, Automaton::Anchor::start);
+    return true;
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 EpsilonAtStartRegex::do_constrain_once_with_current_value(
@@ -1504,6 +2386,16 @@ EpsilonAtEndRegex::do_clone() const
 
 // accessing
 
+bool
+EpsilonAtEndRegex::do_add_to_automaton(Automaton& automaton,
+                                       size_t     from,
+                                       size_t     to,
+                                       size_t     /*max_length*/) const
+{
+    automaton.add_epsilon_transition(from, to, Automaton::Anchor::end);
+    return true;
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 EpsilonAtEndRegex::do_constrain_once_with_current_value(
@@ -1614,6 +2506,33 @@ EpsilonAtWordBoundaryRegex::do_to_string() const
     return "\\b";
 }
 
+// querying
+
+bool
+EpsilonAtWordBoundaryRegex::do_has_exact_values() const
+{
+    return false;
+}
+
+// The word boundary check of do_constrain_word_boundaries_with_current_value()
+// is done on the constraint being constrained as soon as this regex is
+// rewound, so that the values which would fail it are pruned.
+bool
+EpsilonAtWordBoundaryRegex::do_is_impossible_at_begin_pos() const
+{
+    const auto constraint = constraint_being_constrained();
+
+    if (constraint == nullptr)
+    {
+        return false;
+    }
+
+    const auto at_word_boundary = true;
+    return word_boundary_is_impossible(*constraint,
+                                       begin_pos(),
+                                       at_word_boundary);
+}
+
 
 // EpsilonNotAtWordBoundaryRegex
 // -----------------------------
@@ -1709,6 +2628,33 @@ EpsilonNotAtWordBoundaryRegex::do_to_string() const
     return "\\B";
 }
 
+// querying
+
+bool
+EpsilonNotAtWordBoundaryRegex::do_has_exact_values() const
+{
+    return false;
+}
+
+// The word boundary check of do_constrain_word_boundaries_with_current_value()
+// is done on the constraint being constrained as soon as this regex is
+// rewound, so that the values which would fail it are pruned.
+bool
+EpsilonNotAtWordBoundaryRegex::do_is_impossible_at_begin_pos() const
+{
+    const auto constraint = constraint_being_constrained();
+
+    if (constraint == nullptr)
+    {
+        return false;
+    }
+
+    const auto at_word_boundary = false;
+    return word_boundary_is_impossible(*constraint,
+                                       begin_pos(),
+                                       at_word_boundary);
+}
+
 
 // PositiveLookaheadRegex
 // ----------------------
@@ -1716,7 +2662,9 @@ EpsilonNotAtWordBoundaryRegex::do_to_string() const
 // instance creation and deletion
 
 PositiveLookaheadRegex::PositiveLookaheadRegex(unique_ptr<Regex> regex) :
-  m_regex(move(regex))
+  m_regex(move(regex)),
+  m_regex_is_positional(false),
+  m_regex_is_positional_is_initialized(false)
 {
     set_parent(*m_regex, this);
     assert(class_invariant());
@@ -1738,6 +2686,36 @@ PositiveLookaheadRegex::backreferences_to(const GroupNumber& group_number) const
     return Regex::backreferences_to(*m_regex, group_number);
 }
 
+// Return the constraints which m_regex allows from begin_pos(),
+// when the root of this lookahead constrains 'root_constraint'.
+//
+// They are computed once per begin position and per root constraint.
+const vector<Constraint>&
+PositiveLookaheadRegex::allowed_constraints(const Constraint& root_constraint)
+{
+    if (m_root_constraint != root_constraint)
+    {
+        m_root_constraint = root_constraint;
+        m_allowed_constraints.assign(root_constraint.size() + 1,
+                                     vector<Constraint>());
+        m_allowed_constraints_are_computed.assign(root_constraint.size() + 1,
+                                                  false);
+    }
+
+    const auto begin_pos_ = begin_pos();
+
+    if (!m_allowed_constraints_are_computed[begin_pos_])
+    {
+        m_allowed_constraints[begin_pos_] =
+            constraints_as_positive_lookahead(*m_regex,
+                                              root_constraint,
+                                              begin_pos_);
+        m_allowed_constraints_are_computed[begin_pos_] = true;
+    }
+
+    return m_allowed_constraints[begin_pos_];
+}
+
 // See Regex::constrain_word_boundaries_with_current_value().
 bool
 PositiveLookaheadRegex::do_constrain_once_with_current_value(
@@ -1755,7 +2733,45 @@ PositiveLookaheadRegex::do_constrain_once_with_current_value(
     }
 
     assert(offset == 0);
-    return constrain_as_positive_lookahead(*m_regex, constraint, begin_pos());
+
+    if (!m_regex_is_positional_is_initialized)
+    {
+        vector<RegexKernelPiece> pieces;
+        m_regex_is_positional = get_kernel_pieces(*m_regex, pieces);
+        m_regex_is_positional_is_initialized = true;
+    }
+
+    const auto root_constraint = constraint_being_constrained();
+
+    if (!m_regex_is_positional || root_constraint == nullptr)
+    {
+        return constrain_as_positive_lookahead(*m_regex,
+                                               constraint,
+                                               begin_pos());
+    }
+
+    // Since m_regex constrains each position independently, and since
+    // 'constraint' is tighter than the root constraint, constraining
+    // 'constraint' with a value of m_regex is the same as ANDing it
+    // with the constraint which that value allows from the root
+    // constraint. So the values of m_regex need not be enumerated
+    // again each time that this lookahead is reached.
+    auto new_constraint = Constraint::none(constraint.size());
+
+    for (const auto& allowed_constraint : allowed_constraints(*root_constraint))
+    {
+        const auto constraint_copy = constraint & allowed_constraint;
+
+        if (constraint_copy.is_possible())
+        {
+            new_constraint |= constraint_copy;
+        }
+    }
+
+    assert(new_constraint.is_tighter_than_or_equal_to(constraint));
+    constraint = new_constraint;
+
+    return constraint.is_possible();
 }
 
 string
@@ -1771,6 +2787,12 @@ PositiveLookaheadRegex::do_get_used_backreference_numbers(
     get_used_backreference_numbers(*m_regex, used_backreference_numbers);
 }
 
+size_t
+PositiveLookaheadRegex::do_num_nodes() const
+{
+    return 1 + num_nodes(*m_regex);
+}
+
 vector<const GroupRegex*>
 PositiveLookaheadRegex::groups() const
 {
@@ -1783,6 +2805,14 @@ PositiveLookaheadRegex::yourself_or_enclosing_lookahead() const
     return this;
 }
 
+// querying
+
+bool
+PositiveLookaheadRegex::do_has_exact_values() const
+{
+    return false;
+}
+
 // converting
 
 string
@@ -1800,6 +2830,13 @@ PositiveLookaheadRegex::do_optimize_concatenations()
     return this;
 }
 
+Regex*
+PositiveLookaheadRegex::do_optimize_factorizations()
+{
+    m_regex = optimize_factorizations(move(m_regex));
+    return this;
+}
+
 Regex*
 PositiveLookaheadRegex::do_optimize_groups(
     const BackreferenceNumbers& used_backreference_numbers)
@@ -1808,6 +2845,13 @@ PositiveLookaheadRegex::do_optimize_groups(
     return this;
 }
 
+Regex*
+PositiveLookaheadRegex::do_optimize_repetitions()
+{
+    m_regex = optimize_repetitions(move(m_regex));
+    return this;
+}
+
 Regex*
 PositiveLookaheadRegex::do_optimize_unions()
 {
@@ -1815,6 +2859,24 @@ PositiveLookaheadRegex::do_optimize_unions()
     return this;
 }
 
+// m_regex may have changed since the constraint size was last set (e.g.,
+// by optimizations), so what was computed about it is forgotten.
+void
+PositiveLookaheadRegex::do_set_constraint_size(size_t constraint_size)
+{
+    m_regex_is_positional_is_initialized = false;
+    m_root_constraint = Constraint();
+
+    Regex::do_set_constraint_size(constraint_size);
+}
+
+Regex*
+PositiveLookaheadRegex::do_specialize_for_length(size_t length)
+{
+    m_regex = specialize_for_length(move(m_regex), length);
+    return this;
+}
+
 void
 PositiveLookaheadRegex::set_constraint_size_of_children(size_t constraint_size)
 {
@@ -1913,6 +2975,16 @@ CharacterBlockRegex::compute_characters() const
     return m_character_block->characters();
 }
 
+bool
+CharacterBlockRegex::do_add_to_automaton(Automaton& automaton,
+                                         size_t     from,
+                                         size_t     to,
+                                         size_t     /*max_length*/) const
+{
+    automaton.add_transition(from, characters(), to);
+    return true;
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 CharacterBlockRegex::do_constrain_once_with_current_value(
@@ -1983,12 +3055,44 @@ CharacterBlockRegex::do_explicit_characters() const
     return m_character_block->explicit_characters();
 }
 
+SetOfCharacters
+CharacterBlockRegex::do_first_characters() const
+{
+    return characters();
+}
+
+bool
+CharacterBlockRegex::do_get_kernel_strings(
+                       vector<RegexKernelString>& strings) const
+{
+    strings.push_back(RegexKernelString{ m_character_block->clone() });
+    return true;
+}
+
 size_t
 CharacterBlockRegex::do_length_of_current_value() const
 {
     return 1;
 }
 
+size_t
+CharacterBlockRegex::do_min_length() const
+{
+    return 1;
+}
+
+RequiredLiterals
+CharacterBlockRegex::do_required_literals() const
+{
+    return RequiredLiterals::exact({ characters() });
+}
+
+SetOfCharacters
+CharacterBlockRegex::do_single_characters() const
+{
+    return characters();
+}
+
 unique_ptr<CharacterBlock>
 CharacterBlockRegex::steal_character_block()
 {
@@ -2129,6 +3233,28 @@ StringRegex::characters() const
     return m_characters;
 }
 
+// Add a chain of states, one per character block.
+bool
+StringRegex::do_add_to_automaton(Automaton& automaton,
+                                 size_t     from,
+                                 size_t     to,
+                                 size_t     /*max_length*/) const
+{
+    const auto& string_characters = characters();
+    auto state = from;
+
+    for (size_t i = 0; i != string_characters.size(); ++i)
+    {
+        const auto next_state = i + 1 == string_characters.size()
+                                ? to
+                                : automaton.add_state();
+        automaton.add_transition(state, string_characters[i], next_state);
+        state = next_state;
+    }
+
+    return true;
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 StringRegex::do_constrain_once_with_current_value(Constraint& constraint,
@@ -2183,6 +3309,26 @@ StringRegex::do_explicit_characters() const
                       });
 }
 
+SetOfCharacters
+StringRegex::do_first_characters() const
+{
+    return characters().front();
+}
+
+bool
+StringRegex::do_get_kernel_strings(vector<RegexKernelString>& strings) const
+{
+    RegexKernelString string;
+
+    for (const auto& character_block : m_character_blocks)
+    {
+        string.push_back(character_block->clone());
+    }
+
+    strings.push_back(string);
+    return true;
+}
+
 size_t
 StringRegex::do_length_of_current_value() const
 {
@@ -2207,6 +3353,48 @@ StringRegex::initialize_constrained_characters()
     m_constrained_characters = characters();
 }
 
+size_t
+StringRegex::do_min_length() const
+{
+    return m_character_blocks.size();
+}
+
+RequiredLiterals
+StringRegex::do_required_literals() const
+{
+    return RequiredLiterals::exact(characters());
+}
+
+SetOfCharacters
+StringRegex::do_single_characters() const
+{
+    if (characters().size() == 1)
+    {
+        return characters()[0];
+    }
+
+    return SetOfCharacters();
+}
+
+vector<bool>
+StringRegex::do_universal_lengths(size_t max_length) const
+{
+    vector<bool> result(max_length + 1, false);
+    const auto length = characters().size();
+
+    if (length <= max_length &&
+        all_of(characters().cbegin(), characters().cend(),
+               [](const SetOfCharacters& characters)
+               {
+                   return characters == Alphabet::characters();
+               }))
+    {
+        result[length] = true;
+    }
+
+    return result;
+}
+
 // querying
 
 bool
@@ -2312,6 +3500,14 @@ BackreferenceRegex::do_constrain_once_with_current_value(
                                              offset_from_referenced_group);
 }
 
+// A backreference may start with any character of the alphabet, since
+// its value depends on the value of the group that it references.
+SetOfCharacters
+BackreferenceRegex::do_first_characters() const
+{
+    return Alphabet::characters();
+}
+
 void
 BackreferenceRegex::do_get_used_backreference_numbers(
                       BackreferenceNumbers& used_backreference_numbers) const
@@ -2352,6 +3548,12 @@ BackreferenceRegex::do_has_a_value() const
     return has_a_value(*referenced_group_);
 }
 
+bool
+BackreferenceRegex::do_has_exact_values() const
+{
+    return false;
+}
+
 // converting
 
 string
@@ -2411,6 +3613,15 @@ AbstractGroupRegex::child() const
     return *m_child;
 }
 
+bool
+AbstractGroupRegex::do_add_to_automaton(Automaton& automaton,
+                                        size_t     from,
+                                        size_t     to,
+                                        size_t     max_length) const
+{
+    return add_to_automaton(*m_child, automaton, from, to, max_length);
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 AbstractGroupRegex::do_constrain_once_with_current_value(Constraint& constraint,
@@ -2433,6 +3644,26 @@ AbstractGroupRegex::do_explicit_characters() const
     return m_child->explicit_characters();
 }
 
+SetOfCharacters
+AbstractGroupRegex::do_first_characters() const
+{
+    return first_characters(*m_child);
+}
+
+bool
+AbstractGroupRegex::do_get_kernel_pieces(
+                      vector<RegexKernelPiece>& pieces) const
+{
+    return get_kernel_pieces(*m_child, pieces);
+}
+
+bool
+AbstractGroupRegex::do_get_kernel_strings(
+                      vector<RegexKernelString>& strings) const
+{
+    return get_kernel_strings(*m_child, strings);
+}
+
 void
 AbstractGroupRegex::do_get_used_backreference_numbers(
                       BackreferenceNumbers& used_backreference_numbers) const
@@ -2440,6 +3671,12 @@ AbstractGroupRegex::do_get_used_backreference_numbers(
     get_used_backreference_numbers(*m_child, used_backreference_numbers);
 }
 
+size_t
+AbstractGroupRegex::do_num_nodes() const
+{
+    return 1 + num_nodes(*m_child);
+}
+
 size_t
 AbstractGroupRegex::do_length_of_current_value() const
 {
@@ -2457,6 +3694,30 @@ AbstractGroupRegex::do_rightmost_group(const GroupNumber& group_number,
     return rightmost_group_from_parent(group_number);
 }
 
+size_t
+AbstractGroupRegex::do_min_length() const
+{
+    return min_length(*m_child);
+}
+
+RequiredLiterals
+AbstractGroupRegex::do_required_literals() const
+{
+    return m_child->required_literals();
+}
+
+SetOfCharacters
+AbstractGroupRegex::do_single_characters() const
+{
+    return single_characters(*m_child);
+}
+
+vector<bool>
+AbstractGroupRegex::do_universal_lengths(size_t max_length) const
+{
+    return universal_lengths(*m_child, max_length);
+}
+
 // querying
 
 bool
@@ -2471,6 +3732,12 @@ AbstractGroupRegex::do_characters_were_constrained_by_backreference() const
     return characters_were_constrained_by_backreference(*m_child);
 }
 
+bool
+AbstractGroupRegex::do_has_exact_values() const
+{
+    return has_exact_values(*m_child);
+}
+
 bool
 AbstractGroupRegex::do_parents_are_correctly_setup() const
 {
@@ -2497,6 +3764,13 @@ AbstractGroupRegex::do_optimize_concatenations()
     return this;
 }
 
+Regex*
+AbstractGroupRegex::do_optimize_factorizations()
+{
+    m_child = optimize_factorizations(move(m_child));
+    return this;
+}
+
 Regex*
 AbstractGroupRegex::do_optimize_groups(
                       const BackreferenceNumbers& used_backreference_numbers)
@@ -2515,6 +3789,13 @@ AbstractGroupRegex::do_optimize_groups(
     }
 }
 
+Regex*
+AbstractGroupRegex::do_optimize_repetitions()
+{
+    m_child = optimize_repetitions(move(m_child));
+    return this;
+}
+
 Regex*
 AbstractGroupRegex::do_optimize_unions()
 {
@@ -2540,6 +3821,13 @@ AbstractGroupRegex::do_rewind()
     rewind(*m_child, begin_pos());
 }
 
+Regex*
+AbstractGroupRegex::do_specialize_for_length(size_t length)
+{
+    m_child = specialize_for_length(move(m_child), length);
+    return this;
+}
+
 void
 AbstractGroupRegex::set_constraint_size_of_children(size_t constraint_size)
 {
@@ -2740,6 +4028,12 @@ BinaryRegex::groups() const
     return result;
 }
 
+size_t
+BinaryRegex::do_num_nodes() const
+{
+    return 1 + num_nodes(*m_left_child) + num_nodes(*m_right_child);
+}
+
 Regex&
 BinaryRegex::left_child() const
 {
@@ -2766,6 +4060,12 @@ BinaryRegex::steal_right_child()
 
 // querying
 
+bool
+BinaryRegex::do_has_exact_values() const
+{
+    return has_exact_values(*m_left_child) && has_exact_values(*m_right_child);
+}
+
 bool
 BinaryRegex::do_parents_are_correctly_setup() const
 {
@@ -2802,6 +4102,14 @@ BinaryRegex::do_optimize_concatenations()
     return this;
 }
 
+Regex*
+BinaryRegex::do_optimize_factorizations()
+{
+    m_left_child = optimize_factorizations(move(m_left_child));
+    m_right_child = optimize_factorizations(move(m_right_child));
+    return this;
+}
+
 Regex*
 BinaryRegex::do_optimize_groups(
                const BackreferenceNumbers& used_backreference_numbers)
@@ -2813,6 +4121,14 @@ BinaryRegex::do_optimize_groups(
     return this;
 }
 
+Regex*
+BinaryRegex::do_optimize_repetitions()
+{
+    m_left_child = optimize_repetitions(move(m_left_child));
+    m_right_child = optimize_repetitions(move(m_right_child));
+    return this;
+}
+
 Regex*
 BinaryRegex::do_optimize_unions()
 {
@@ -2903,6 +4219,14 @@ BinaryRegex::set_children(unique_ptr<Regex> left_child,
     set_right_child(move(right_child));
 }
 
+Regex*
+BinaryRegex::do_specialize_for_length(size_t length)
+{
+    m_left_child = specialize_for_length(move(m_left_child), length);
+    m_right_child = specialize_for_length(move(m_right_child), length);
+    return this;
+}
+
 void
 BinaryRegex::set_constraint_size_of_children(size_t constraint_size)
 {
@@ -2983,6 +4307,26 @@ ConcatenationRegex::do_clone() const
 
 // accessing
 
+bool
+ConcatenationRegex::do_add_to_automaton(Automaton& automaton,
+                                        size_t     from,
+                                        size_t     to,
+                                        size_t     max_length) const
+{
+    const auto middle_state = automaton.add_state();
+
+    return add_to_automaton(left_child(),
+                            automaton,
+                            from,
+                            middle_state,
+                            max_length)
+           && add_to_automaton(right_child(),
+                               automaton,
+                               middle_state,
+                               to,
+                               max_length);
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 ConcatenationRegex::do_constrain_once_with_current_value(
@@ -3014,6 +4358,64 @@ ConcatenationRegex::do_constrain_word_boundaries_with_current_value(
              right_child(), constraint);
 }
 
+// A non-empty value starts with a character of the left child, unless
+// the value of the left child is empty.
+SetOfCharacters
+ConcatenationRegex::do_first_characters() const
+{
+    auto result = first_characters(left_child());
+
+    if (min_length(left_child()) == 0)
+    {
+        result |= first_characters(right_child());
+    }
+
+    return result;
+}
+
+bool
+ConcatenationRegex::do_get_kernel_pieces(
+                      vector<RegexKernelPiece>& pieces) const
+{
+    return get_kernel_pieces(left_child(), pieces) &&
+           get_kernel_pieces(right_child(), pieces);
+}
+
+// The strings of a concatenation are all the concatenations of a
+// string of the left child with a string of the right child. We give
+// up beyond 'max_num_strings' strings, because a kernel would then be
+// slower than the regex itself.
+bool
+ConcatenationRegex::do_get_kernel_strings(
+                      vector<RegexKernelString>& strings) const
+{
+    const size_t max_num_strings = 64;
+
+    vector<RegexKernelString> left_strings;
+    vector<RegexKernelString> right_strings;
+
+    if (!get_kernel_strings(left_child(), left_strings) ||
+        !get_kernel_strings(right_child(), right_strings) ||
+        left_strings.size() * right_strings.size() > max_num_strings)
+    {
+        return false;
+    }
+
+    for (const auto& left_string : left_strings)
+    {
+        for (const auto& right_string : right_strings)
+        {
+            auto string = left_string;
+            string.insert(string.end(),
+                          right_string.cbegin(),
+                          right_string.cend());
+            strings.push_back(string);
+        }
+    }
+
+    return true;
+}
+
 size_t
 ConcatenationRegex::do_length_of_current_value() const
 {
@@ -3059,6 +4461,20 @@ ConcatenationRegex::do_rightmost_group(const GroupNumber& group_number)
     return nullptr;
 }
 
+// Return the operands of this ConcatenationRegex, i.e., the regexes
+// which are concatenated through this ConcatenationRegex and its
+// descendant ConcatenationRegex'es.
+//
+// For example, the operands of 'AB(C)' are 'A', 'B' and '(C)'.
+vector<const Regex*>
+ConcatenationRegex::operands() const
+{
+    auto result = concatenated_regexes(left_child());
+    const auto right_operands = concatenated_regexes(right_child());
+    result.insert(end(result), begin(right_operands), end(right_operands));
+    return result;
+}
+
 string
 ConcatenationRegex::operator_string() const
 {
@@ -3066,6 +4482,48 @@ ConcatenationRegex::operator_string() const
     return "";
 }
 
+size_t
+ConcatenationRegex::do_min_length() const
+{
+    return min_length(left_child()) + min_length(right_child());
+}
+
+RequiredLiterals
+ConcatenationRegex::do_required_literals() const
+{
+    return RequiredLiterals::concatenation(left_child().required_literals(),
+                                           right_child().required_literals());
+}
+
+// A single character is matched either by the left child followed by
+// an epsilon right child, or by an epsilon left child followed by the
+// right child.
+SetOfCharacters
+ConcatenationRegex::do_single_characters() const
+{
+    SetOfCharacters result;
+
+    if (universal_lengths(right_child(), 0)[0])
+    {
+        result |= single_characters(left_child());
+    }
+
+    if (universal_lengths(left_child(), 0)[0])
+    {
+        result |= single_characters(right_child());
+    }
+
+    return result;
+}
+
+vector<bool>
+ConcatenationRegex::do_universal_lengths(size_t max_length) const
+{
+    return sum_of_lengths(universal_lengths(left_child(), max_length),
+                          universal_lengths(right_child(), max_length),
+                          max_length);
+}
+
 // querying
 
 bool
@@ -3209,6 +4667,50 @@ ConcatenationRegex::do_optimize_concatenations_on_right()
     return this;
 }
 
+// Postcondition:
+// * the returned regex has no adjacent operands which can be merged
+//   into a single RepetitionRegex
+Regex*
+ConcatenationRegex::do_optimize_repetitions()
+{
+    set_left_child(optimize_repetitions(steal_left_child()));
+    set_right_child(optimize_repetitions(steal_right_child()));
+
+    const auto operands_ = operands();
+    const auto mergeable = adjacent_find(operands_.cbegin(),
+                                         operands_.cend(),
+                                         [](const Regex* regex_1,
+                                            const Regex* regex_2)
+                                         {
+                                             return repetitions_can_be_merged(
+                                                      *regex_1, *regex_2);
+                                         });
+
+    if (mergeable == operands_.cend())
+    {
+        return this;
+    }
+
+    vector<unique_ptr<Regex>> merged_operands;
+
+    for (auto& operand : steal_operands())
+    {
+        if (!merged_operands.empty() &&
+            repetitions_can_be_merged(*merged_operands.back(), *operand))
+        {
+            merged_operands.back() =
+                merge_repetitions(move(merged_operands.back()),
+                                  move(operand));
+        }
+        else
+        {
+            merged_operands.push_back(move(operand));
+        }
+    }
+
+    return concatenation_of(move(merged_operands)).release();
+}
+
 void
 ConcatenationRegex::do_rewind()
 {
@@ -3434,6 +4936,17 @@ ConcatenationRegex::optimize_concatenations_left_right_and_right_left()
     }
 }
 
+// Same as operands(), except that the operands are removed from this
+// ConcatenationRegex and returned.
+vector<unique_ptr<Regex>>
+ConcatenationRegex::steal_operands()
+{
+    auto result = split_concatenation(steal_left_child());
+    auto right_operands = split_concatenation(steal_right_child());
+    move(begin(right_operands), end(right_operands), back_inserter(result));
+    return result;
+}
+
 void
 ConcatenationRegex::while_right_at_end_increment()
 {
@@ -3458,7 +4971,12 @@ ConcatenationRegex::while_right_at_end_increment()
 
 UnionRegex::UnionRegex(unique_ptr<Regex> left_child,
                        unique_ptr<Regex> right_child) :
-  BinaryRegex(move(left_child), move(right_child))
+  BinaryRegex(move(left_child), move(right_child)),
+  m_first_characters_are_initialized(false),
+  m_left_child_may_be_empty(true),
+  m_right_child_may_be_empty(true),
+  m_left_child_is_skipped(false),
+  m_right_child_is_skipped(false)
 {
     assert(class_invariant());
 }
@@ -3485,17 +5003,56 @@ UnionRegex::do_clone() const
 Regex&
 UnionRegex::active_child() const
 {
-    if (not_at_end(left_child()))
+    if (!left_child_at_end())
     {
         return left_child();
     }
     else
     {
-        assert(not_at_end(right_child()));
+        assert(!right_child_at_end());
         return right_child();
     }
 }
 
+// Return the alternatives of this UnionRegex, i.e., the regexes which
+// are united through this UnionRegex and its descendant UnionRegex'es.
+//
+// For example, the alternatives of 'A|BC|(D|E)' are 'A', 'BC' and
+// '(D|E)'.
+vector<const Regex*>
+UnionRegex::alternatives() const
+{
+    vector<const Regex*> result;
+
+    for (const auto child : { &left_child(), &right_child() })
+    {
+        if (is_union(*child))
+        {
+            const auto child_alternatives =
+                static_cast<const UnionRegex*>(child)->alternatives();
+            result.insert(end(result),
+                          begin(child_alternatives),
+                          end(child_alternatives));
+        }
+        else
+        {
+            result.push_back(child);
+        }
+    }
+
+    return result;
+}
+
+bool
+UnionRegex::do_add_to_automaton(Automaton& automaton,
+                                size_t     from,
+                                size_t     to,
+                                size_t     max_length) const
+{
+    return add_to_automaton(left_child(), automaton, from, to, max_length)
+           && add_to_automaton(right_child(), automaton, from, to, max_length);
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 UnionRegex::do_constrain_once_with_current_value(Constraint& constraint,
@@ -3514,6 +5071,19 @@ UnionRegex::do_constrain_word_boundaries_with_current_value(
              active_child(), constraint);
 }
 
+SetOfCharacters
+UnionRegex::do_first_characters() const
+{
+    return first_characters(left_child()) | first_characters(right_child());
+}
+
+bool
+UnionRegex::do_get_kernel_strings(vector<RegexKernelString>& strings) const
+{
+    return get_kernel_strings(left_child(), strings) &&
+           get_kernel_strings(right_child(), strings);
+}
+
 size_t
 UnionRegex::do_length_of_current_value() const
 {
@@ -3540,13 +5110,13 @@ UnionRegex::first_child_with_a_value() const
 {
     assert(has_a_value());
 
-    if (has_a_value(left_child()))
+    if (!m_left_child_is_skipped && has_a_value(left_child()))
     {
         return left_child();
     }
     else
     {
-        assert(has_a_value(right_child()));
+        assert(!m_right_child_is_skipped && has_a_value(right_child()));
         return right_child();
     }
 }
@@ -3557,13 +5127,73 @@ UnionRegex::operator_string() const
     return Utils::char_to_string('|');
 }
 
+size_t
+UnionRegex::do_min_length() const
+{
+    return min(min_length(left_child()), min_length(right_child()));
+}
+
+RequiredLiterals
+UnionRegex::do_required_literals() const
+{
+    return RequiredLiterals::alternation(left_child().required_literals(),
+                                         right_child().required_literals());
+}
+
+SetOfCharacters
+UnionRegex::do_single_characters() const
+{
+    return single_characters(left_child()) | single_characters(right_child());
+}
+
+vector<bool>
+UnionRegex::do_universal_lengths(size_t max_length) const
+{
+    auto result = universal_lengths(left_child(), max_length);
+    const auto right_lengths = universal_lengths(right_child(), max_length);
+
+    for (size_t i = 0; i <= max_length; ++i)
+    {
+        result[i] = result[i] || right_lengths[i];
+    }
+
+    return result;
+}
+
 // querying
 
+// Return whether a child of this union, whose non-empty values start
+// with 'first_characters', can be skipped instead of being rewound,
+// because none of its values can satisfy the constraint which the
+// root of this union is constraining.
+//
+// For example, when 'AB|C.|DE' constrains { "DE", "AE" }, 'AB' and
+// 'C.' are skipped: only 'DE' is enumerated.
+bool
+UnionRegex::child_can_be_skipped(
+                const SetOfCharacters& first_characters,
+                bool                   child_may_be_empty) const
+{
+    if (!m_first_characters_are_initialized || child_may_be_empty)
+    {
+        return false;
+    }
+
+    const auto constraint = constraint_being_constrained();
+
+    if (constraint == nullptr || begin_pos() >= constraint->size())
+    {
+        return false;
+    }
+
+    return (first_characters & (*constraint)[begin_pos()]).empty();
+}
+
 bool
 UnionRegex::do_at_end() const
 {
-    return at_end(left_child()) &&
-           at_end(right_child());
+    return left_child_at_end() &&
+           right_child_at_end();
 }
 
 bool
@@ -3578,38 +5208,254 @@ UnionRegex::do_is_union() const
     return true;
 }
 
+bool
+UnionRegex::left_child_at_end() const
+{
+    return m_left_child_is_skipped || at_end(left_child());
+}
+
+bool
+UnionRegex::right_child_at_end() const
+{
+    return m_right_child_is_skipped || at_end(right_child());
+}
+
+void
+UnionRegex::do_rewind()
+{
+    if (!m_first_characters_are_initialized &&
+        constraint_being_constrained() != nullptr)
+    {
+        initialize_first_characters();
+    }
+
+    m_right_child_is_skipped = false;
+
+    rewind_left_child();
+
+    if (left_child_at_end())
+    {
+        rewind_right_child();
+    }
+}
+
+// Remove the child of this union which cannot fit in 'length'
+// characters, if any. A child which contains groups is kept, since
+// backreferences may refer to them.
+Regex*
+UnionRegex::do_specialize_for_length(size_t length)
+{
+    set_left_child(specialize_for_length(steal_left_child(), length));
+    set_right_child(specialize_for_length(steal_right_child(), length));
+
+    const auto left_child_fits = min_length(left_child()) <= length;
+    const auto right_child_fits = min_length(right_child()) <= length;
+
+    if (left_child_fits && !right_child_fits &&
+        Regex::groups(right_child()).empty())
+    {
+        return steal_left_child().release();
+    }
+
+    if (!left_child_fits && right_child_fits &&
+        Regex::groups(left_child()).empty())
+    {
+        return steal_right_child().release();
+    }
+
+    return this;
+}
+
+bool
+UnionRegex::either_child_can_be_unified() const
+{
+    return can_be_unified(left_child()) ||
+           can_be_unified(right_child());
+}
+
+// modifying
+
+void
+UnionRegex::do_increment()
+{
+    auto& first_child_with_a_value_before_increment =
+        first_child_with_a_value();
+
+    increment(first_child_with_a_value_before_increment);
+
+    if (&first_child_with_a_value_before_increment == &left_child() &&
+        at_end(left_child()))
+    {
+        rewind_right_child();
+    }
+}
+
+// Factor the operands which begin (or, failing that, end) all the
+// alternatives of this UnionRegex out of it.
+//
+// For example, 'AB|AC|A' becomes 'A(?:B|C|)' and 'AC|BC' becomes
+// '(?:A|B)C'. Only CharacterBlockRegex'es and StringRegex'es are
+// factored, so that groups and backreferences are left untouched.
+Regex*
+UnionRegex::do_optimize_factorizations()
+{
+    optimize_factorizations_of_alternatives();
+
+    vector<vector<const Regex*>> operands_of_alternatives;
+
+    for (const auto alternative : alternatives())
+    {
+        operands_of_alternatives.push_back(concatenated_regexes(*alternative));
+    }
+
+    const auto min_num_operands =
+        min_element(operands_of_alternatives.cbegin(),
+                    operands_of_alternatives.cend(),
+                    [](const vector<const Regex*>& operands_1,
+                       const vector<const Regex*>& operands_2)
+                    {
+                        return operands_1.size() < operands_2.size();
+                    })->size();
+
+    // Whether the 'i'th operand of all the alternatives is the same,
+    // counting from the end if 'from_end' is true.
+    const auto is_common_operand =
+        [&operands_of_alternatives](size_t i, bool from_end)
+        {
+            const auto operand_at =
+                [i, from_end](const vector<const Regex*>& operands)
+                {
+                    return from_end ? operands[operands.size() - 1 - i]
+                                    : operands[i];
+                };
+            const auto& first = *operand_at(operands_of_alternatives.front());
+
+            return all_of(operands_of_alternatives.cbegin(),
+                          operands_of_alternatives.cend(),
+                          [&first, &operand_at](
+                            const vector<const Regex*>& operands)
+                          {
+                              return are_identical_blocks(
+                                       first, *operand_at(operands));
+                          });
+        };
+
+    size_t prefix_size = 0;
+
+    while (prefix_size != min_num_operands &&
+           is_common_operand(prefix_size, false))
+    {
+        ++prefix_size;
+    }
+
+    size_t suffix_size = 0;
+
+    if (prefix_size == 0)
+    {
+        while (suffix_size != min_num_operands &&
+               is_common_operand(suffix_size, true))
+        {
+            ++suffix_size;
+        }
+    }
+
+    if (prefix_size == 0 && suffix_size == 0)
+    {
+        return this;
+    }
+
+    vector<unique_ptr<Regex>> prefix;
+    vector<unique_ptr<Regex>> middles;
+    vector<unique_ptr<Regex>> suffix;
+
+    for (auto& alternative : steal_alternatives())
+    {
+        auto operands = split_concatenation(move(alternative));
+
+        const auto middle_begin = next(begin(operands),
+                                       static_cast<int>(prefix_size));
+        const auto middle_end = prev(end(operands),
+                                     static_cast<int>(suffix_size));
+
+        if (prefix.empty() && suffix.empty())
+        {
+            move(begin(operands), middle_begin, back_inserter(prefix));
+            move(middle_end, end(operands), back_inserter(suffix));
+        }
+
+        vector<unique_ptr<Regex>> middle;
+        move(middle_begin, middle_end, back_inserter(middle));
+        middles.push_back(concatenation_of(move(middle)));
+    }
+
+    const auto all_middles_are_epsilon =
+        all_of(middles.cbegin(),
+               middles.cend(),
+               [](const unique_ptr<Regex>& middle)
+               {
+                   return is_epsilon(*middle);
+               });
+
+    auto result = move(prefix);
+
+    if (!all_middles_are_epsilon)
+    {
+        auto middle_union = optimize_factorizations(union_of(move(middles)));
+        result.push_back(Utils::make_unique<NonCapturingGroupRegex>(
+                                  move(middle_union)));
+    }
+
+    move(begin(suffix), end(suffix), back_inserter(result));
+
+    return concatenation_of(move(result)).release();
+}
+
+// The children of this union may have changed since the constraint
+// size was last set (e.g., by optimizations), so their first characters
+// are computed again when they are next needed.
 void
-UnionRegex::do_rewind()
+UnionRegex::do_set_constraint_size(size_t constraint_size)
 {
-    rewind(left_child(), begin_pos());
+    m_first_characters_are_initialized = false;
 
-    if (at_end(left_child()))
-    {
-        rewind(right_child(), begin_pos());
-    }
+    Regex::do_set_constraint_size(constraint_size);
 }
 
-bool
-UnionRegex::either_child_can_be_unified() const
+void
+UnionRegex::initialize_first_characters()
 {
-    return can_be_unified(left_child()) ||
-           can_be_unified(right_child());
-}
+    m_first_characters_of_left_child = first_characters(left_child());
+    m_first_characters_of_right_child = first_characters(right_child());
+    m_left_child_may_be_empty = (min_length(left_child()) == 0);
+    m_right_child_may_be_empty = (min_length(right_child()) == 0);
 
-// modifying
+    m_first_characters_are_initialized = true;
+}
 
+// Optimize the factorizations of the alternatives of this UnionRegex,
+// but not of this UnionRegex itself, nor of its descendant
+// UnionRegex'es: they are factorized as a whole by the caller.
 void
-UnionRegex::do_increment()
+UnionRegex::optimize_factorizations_of_alternatives()
 {
-    auto& first_child_with_a_value_before_increment =
-        first_child_with_a_value();
-
-    increment(first_child_with_a_value_before_increment);
+    if (is_union(left_child()))
+    {
+        downcast<UnionRegex>(left_child()).
+            optimize_factorizations_of_alternatives();
+    }
+    else
+    {
+        set_left_child(optimize_factorizations(steal_left_child()));
+    }
 
-    if (&first_child_with_a_value_before_increment == &left_child() &&
-        at_end(left_child()))
+    if (is_union(right_child()))
     {
-        rewind(right_child(), begin_pos());
+        downcast<UnionRegex>(right_child()).
+            optimize_factorizations_of_alternatives();
+    }
+    else
+    {
+        set_right_child(optimize_factorizations(steal_right_child()));
     }
 }
 
@@ -3846,6 +5692,36 @@ UnionRegex::optimize_unions_left_either_and_right_either()
     }
 }
 
+// Same as alternatives(), except that the alternatives are removed from
+// this UnionRegex and returned.
+vector<unique_ptr<Regex>>
+UnionRegex::steal_alternatives()
+{
+    vector<unique_ptr<Regex>> children;
+    children.push_back(steal_left_child());
+    children.push_back(steal_right_child());
+
+    vector<unique_ptr<Regex>> result;
+
+    for (auto& child : children)
+    {
+        if (is_union(*child))
+        {
+            auto child_alternatives =
+                downcast<UnionRegex>(*child).steal_alternatives();
+            move(begin(child_alternatives),
+                 end(child_alternatives),
+                 back_inserter(result));
+        }
+        else
+        {
+            result.push_back(move(child));
+        }
+    }
+
+    return result;
+}
+
 // Precondition:
 // * either child can be unified
 void
@@ -3874,6 +5750,32 @@ UnionRegex::place_child_which_can_be_unified_to_right()
     swap_children();
 }
 
+void
+UnionRegex::rewind_left_child()
+{
+    m_left_child_is_skipped =
+        child_can_be_skipped(m_first_characters_of_left_child,
+                             m_left_child_may_be_empty);
+
+    if (!m_left_child_is_skipped)
+    {
+        rewind(left_child(), begin_pos());
+    }
+}
+
+void
+UnionRegex::rewind_right_child()
+{
+    m_right_child_is_skipped =
+        child_can_be_skipped(m_first_characters_of_right_child,
+                             m_right_child_may_be_empty);
+
+    if (!m_right_child_is_skipped)
+    {
+        rewind(right_child(), begin_pos());
+    }
+}
+
 // Precondition:
 // * both children can be unified
 Regex*
@@ -3900,13 +5802,19 @@ RepetitionRegex::RepetitionRegex(unique_ptr<Regex>      child,
   m_variable_children_max_count(max_count - min_count),
   m_fixed_children_at_beginning(true),
   m_variable_children_at_beginning(true),
-  m_num_used_variable_children(0)
+  m_num_used_variable_children(0),
+  m_num_copies(0),
+  m_copies_at_end(false),
+  m_copies_were_constrained_by_backreference(false)
 {
     assert(min_count.is_not_infinite());
     assert(min_count <= max_count);
 
     set_parent(*m_child_to_repeat, this);
-    build_fixed_children();
+
+    // The fixed children are built by do_set_constraint_size(), when
+    // they are first needed, so that cloning this regex does not clone
+    // them.
 }
 
 void
@@ -3921,12 +5829,13 @@ RepetitionRegex::build_fixed_children()
 void
 RepetitionRegex::rebuild_after_optimization()
 {
+    // The variable children, if any, are clones of the child to repeat
+    // before its optimization, so they must be discarded too.
     m_fixed_children.clear();
+    m_variable_children.clear();
     m_all_children.clear();
-
-    build_fixed_children();
-
-    assert(m_num_used_variable_children == 0);
+    m_num_used_variable_children = 0;
+    m_constrained_characters_of_copies.clear();
 }
 
 // accessing
@@ -3943,11 +5852,82 @@ RepetitionRegex::child_to_repeat() const
     return *m_child_to_repeat;
 }
 
+bool
+RepetitionRegex::do_add_to_automaton(Automaton& automaton,
+                                     size_t     from,
+                                     size_t     to,
+                                     size_t     max_length) const
+{
+    // Beyond this number of states, the automaton is deemed too large.
+    const size_t max_num_states = 4096;
+
+    // A repetition of more than 'max_length' + 1 copies of the child
+    // (at least one of which matches a non-empty string) cannot match
+    // a string of up to 'max_length' characters, so larger counts are
+    // capped. 'max_length' + 1 copies also accommodate the copies which
+    // match the empty string.
+    const auto max_num_copies = max_length + 1;
+    const auto min_count = min(m_min_count.count(), max_num_copies);
+    const auto max_count_is_finite =
+        m_max_count.is_not_infinite()
+        && m_max_count.count() <= max_num_copies;
+    const auto max_count =
+        max_count_is_finite ? m_max_count.count() : max_num_copies;
+
+    // The required copies.
+    auto state = from;
+    for (size_t i = 0; i != min_count; ++i)
+    {
+        const auto next_state = automaton.add_state();
+        if (!add_to_automaton(
+                 *m_child_to_repeat, automaton, state, next_state, max_length)
+            || automaton.num_states() > max_num_states)
+        {
+            return false;
+        }
+        state = next_state;
+    }
+
+    if (!max_count_is_finite)
+    {
+        // The optional copies, as a loop.
+        const auto loop_state = automaton.add_state();
+        automaton.add_epsilon_transition(state, loop_state);
+        automaton.add_epsilon_transition(loop_state, to);
+        return add_to_automaton(
+                   *m_child_to_repeat, automaton, loop_state, loop_state,
+                   max_length)
+               && automaton.num_states() <= max_num_states;
+    }
+
+    // The optional copies, each of which may be skipped.
+    for (auto i = min_count; i != max_count; ++i)
+    {
+        automaton.add_epsilon_transition(state, to);
+        const auto next_state = automaton.add_state();
+        if (!add_to_automaton(
+                 *m_child_to_repeat, automaton, state, next_state, max_length)
+            || automaton.num_states() > max_num_states)
+        {
+            return false;
+        }
+        state = next_state;
+    }
+    automaton.add_epsilon_transition(state, to);
+
+    return true;
+}
+
 // See Regex::constrain_once_with_current_value().
 bool
 RepetitionRegex::do_constrain_once_with_current_value(
                    Constraint& constraint, size_t offset)
 {
+    if (is_compact())
+    {
+        return constrain_copies_once(constraint, offset);
+    }
+
     // The lambda function used in all_of() needs to capture
     // 'constraint'. If 'constraint' were captured by value,
     // 'constraint' would be copied, which would be inefficient. And I
@@ -3991,6 +5971,31 @@ RepetitionRegex::do_explicit_characters() const
     return m_child_to_repeat->explicit_characters();
 }
 
+SetOfCharacters
+RepetitionRegex::do_first_characters() const
+{
+    if (m_max_count == 0)
+    {
+        return SetOfCharacters();
+    }
+
+    return first_characters(*m_child_to_repeat);
+}
+
+bool
+RepetitionRegex::do_get_kernel_pieces(vector<RegexKernelPiece>& pieces) const
+{
+    vector<RegexKernelString> strings;
+
+    if (!get_kernel_strings(child_to_repeat(), strings))
+    {
+        return false;
+    }
+
+    pieces.push_back(RegexKernelPiece(move(strings), m_min_count, m_max_count));
+    return true;
+}
+
 void
 RepetitionRegex::do_get_used_backreference_numbers(
                    BackreferenceNumbers& used_backreference_numbers) const
@@ -4002,6 +6007,11 @@ RepetitionRegex::do_get_used_backreference_numbers(
 size_t
 RepetitionRegex::do_length_of_current_value() const
 {
+    if (is_compact())
+    {
+        return m_num_copies;
+    }
+
     return accumulate(m_all_children.cbegin(),
                       m_all_children.cend(),
                       static_cast<decltype(do_length_of_current_value())>(0),
@@ -4074,6 +6084,30 @@ RepetitionRegex::last_variable_child()
     return m_variable_children[m_num_used_variable_children - 1];
 }
 
+RepetitionCount
+RepetitionRegex::do_max_repetition_count() const
+{
+    return m_max_count;
+}
+
+RepetitionCount
+RepetitionRegex::do_min_repetition_count() const
+{
+    return m_min_count;
+}
+
+size_t
+RepetitionRegex::do_num_nodes() const
+{
+    return 1 + num_nodes(*m_child_to_repeat);
+}
+
+const Regex&
+RepetitionRegex::do_repeated_regex() const
+{
+    return *m_child_to_repeat;
+}
+
 RepetitionCount
 RepetitionRegex::max_count() const
 {
@@ -4086,17 +6120,94 @@ RepetitionRegex::min_count() const
     return m_min_count;
 }
 
+size_t
+RepetitionRegex::do_min_length() const
+{
+    return m_min_count.count() * min_length(child_to_repeat());
+}
+
+RequiredLiterals
+RepetitionRegex::do_required_literals() const
+{
+    return RequiredLiterals::repetition(child_to_repeat().required_literals(),
+                                        m_min_count,
+                                        m_max_count);
+}
+
+SetOfCharacters
+RepetitionRegex::do_single_characters() const
+{
+    const auto& child = child_to_repeat();
+
+    if (1 <= m_max_count &&
+        (m_min_count <= 1 || universal_lengths(child, 0)[0]))
+    {
+        return single_characters(child);
+    }
+
+    return SetOfCharacters();
+}
+
+// The universal lengths of k repetitions are those of the concatenation
+// of k copies of the repeated regex. Beyond 'm_min_count' +
+// 'max_length' repetitions, no new lengths up to 'max_length' appear.
+vector<bool>
+RepetitionRegex::do_universal_lengths(size_t max_length) const
+{
+    const auto child_lengths = universal_lengths(child_to_repeat(),
+                                                 max_length);
+    vector<bool> result(max_length + 1, false);
+    vector<bool> lengths_of_k_repetitions(max_length + 1, false);
+    lengths_of_k_repetitions[0] = true;
+
+    for (size_t k = 0; ; ++k)
+    {
+        if (m_min_count <= k)
+        {
+            for (size_t i = 0; i <= max_length; ++i)
+            {
+                result[i] = result[i] || lengths_of_k_repetitions[i];
+            }
+        }
+
+        if (RepetitionCount(k) == m_max_count ||
+            RepetitionCount(k) == m_min_count + max_length ||
+            none_of(lengths_of_k_repetitions.cbegin(),
+                    lengths_of_k_repetitions.cend(),
+                    [](bool b) { return b; }))
+        {
+            break;
+        }
+
+        lengths_of_k_repetitions = sum_of_lengths(lengths_of_k_repetitions,
+                                                  child_lengths,
+                                                  max_length);
+    }
+
+    return result;
+}
+
 // querying
 
 bool
 RepetitionRegex::do_at_end() const
 {
+    if (is_compact())
+    {
+        return m_copies_at_end;
+    }
+
     return fixed_children_at_end() || variable_children_at_end();
 }
 
 bool
 RepetitionRegex::do_characters_were_constrained_by_backreference() const
 {
+    if (is_compact())
+    {
+        return m_copies_were_constrained_by_backreference;
+    }
+
     return any_of(m_all_children.cbegin(),
                   m_all_children.cend(),
                   [this](const Regex* child)
@@ -4106,6 +6217,18 @@ RepetitionRegex::do_characters_were_constrained_by_backreference() const
                   });
 }
 
+bool
+RepetitionRegex::do_has_exact_values() const
+{
+    return has_exact_values(*m_child_to_repeat);
+}
+
+bool
+RepetitionRegex::do_is_repetition() const
+{
+    return true;
+}
+
 bool
 RepetitionRegex::do_parents_are_correctly_setup() const
 {
@@ -4146,6 +6269,15 @@ RepetitionRegex::fixed_children_at_end() const
     }
 }
 
+// Return whether this repetition repeats a CharacterBlockRegex, in
+// which case its values are described by the number of copies of that
+// CharacterBlockRegex alone.
+bool
+RepetitionRegex::is_compact() const
+{
+    return is_character_block(*m_child_to_repeat);
+}
+
 bool
 RepetitionRegex::variable_children_at_end() const
 {
@@ -4201,9 +6333,60 @@ RepetitionRegex::append_variable_child()
     ++m_num_used_variable_children;
 }
 
+// Same as CharacterBlockRegex::do_constrain_once_with_current_value(),
+// for each copy of the CharacterBlockRegex which this compact
+// repetition repeats.
+bool
+RepetitionRegex::constrain_copies_once(Constraint& constraint, size_t offset)
+{
+    const auto characters = single_characters(*m_child_to_repeat);
+
+    while (m_constrained_characters_of_copies.size() < m_num_copies)
+    {
+        m_constrained_characters_of_copies.push_back(characters);
+    }
+
+    const auto begin_pos_ = begin_pos() + offset;
+    auto copies_were_constrained = false;
+
+    for (size_t i = 0; i != m_num_copies; ++i)
+    {
+        auto& constrained_characters = m_constrained_characters_of_copies[i];
+        const auto constrained_characters_before = constrained_characters;
+
+        constrained_characters &= constraint[begin_pos_ + i];
+        constraint[begin_pos_ + i] = constrained_characters;
+
+        if (constrained_characters.empty())
+        {
+            return false;
+        }
+
+        if (constrained_characters != constrained_characters_before)
+        {
+            copies_were_constrained = true;
+        }
+    }
+
+    const auto constraint_comes_from_backreference = (offset != 0);
+
+    if (constraint_comes_from_backreference)
+    {
+        m_copies_were_constrained_by_backreference = copies_were_constrained;
+    }
+
+    return true;
+}
+
 void
 RepetitionRegex::do_increment()
 {
+    if (is_compact())
+    {
+        increment_copies();
+        return;
+    }
+
     increment_variable_children();
     while_variable_children_at_end_increment();
 }
@@ -4216,6 +6399,14 @@ RepetitionRegex::do_optimize_concatenations()
     return this;
 }
 
+Regex*
+RepetitionRegex::do_optimize_factorizations()
+{
+    m_child_to_repeat = optimize_factorizations(move(m_child_to_repeat));
+    rebuild_after_optimization();
+    return this;
+}
+
 Regex*
 RepetitionRegex::do_optimize_groups(
                    const BackreferenceNumbers& used_backreference_numbers)
@@ -4226,6 +6417,14 @@ RepetitionRegex::do_optimize_groups(
     return this;
 }
 
+Regex*
+RepetitionRegex::do_optimize_repetitions()
+{
+    m_child_to_repeat = optimize_repetitions(move(m_child_to_repeat));
+    rebuild_after_optimization();
+    return this;
+}
+
 Regex*
 RepetitionRegex::do_optimize_unions()
 {
@@ -4237,6 +6436,8 @@ RepetitionRegex::do_optimize_unions()
 void
 RepetitionRegex::do_reset_after_constrain()
 {
+    m_constrained_characters_of_copies.clear();
+
     for (auto child : m_all_children)
     {
         reset_after_constrain(*child);
@@ -4246,6 +6447,8 @@ RepetitionRegex::do_reset_after_constrain()
 void
 RepetitionRegex::do_reset_characters_were_constrained_by_backreference()
 {
+    m_copies_were_constrained_by_backreference = false;
+
     for (auto child : m_all_children)
     {
         reset_characters_were_constrained_by_backreference(*child);
@@ -4255,6 +6458,12 @@ RepetitionRegex::do_reset_characters_were_constrained_by_backreference()
 void
 RepetitionRegex::do_rewind()
 {
+    if (is_compact())
+    {
+        rewind_copies();
+        return;
+    }
+
     rewind_fixed_children();
 
     if (fixed_children_at_end())
@@ -4270,10 +6479,30 @@ RepetitionRegex::do_rewind()
 void
 RepetitionRegex::do_set_constraint_size(size_t constraint_size)
 {
+    if (!is_compact() && m_fixed_children.size() != m_min_count.count())
+    {
+        build_fixed_children();
+    }
+
     set_constraint_size(*m_child_to_repeat, constraint_size);
     Regex::do_set_constraint_size(constraint_size);
 }
 
+// Add a copy to the current value of this compact repetition if it
+// fits, like increment_variable_children() appends a variable child.
+void
+RepetitionRegex::increment_copies()
+{
+    if (m_num_copies < m_max_count && end_pos() < constraint_size())
+    {
+        ++m_num_copies;
+    }
+    else
+    {
+        m_copies_at_end = true;
+    }
+}
+
 void
 RepetitionRegex::increment_fixed_children()
 {
@@ -4342,6 +6571,13 @@ RepetitionRegex::remove_variable_children()
     m_num_used_variable_children = 0;
 }
 
+void
+RepetitionRegex::rewind_copies()
+{
+    m_num_copies = m_min_count.count();
+    m_copies_at_end = (begin_pos() + m_num_copies > constraint_size());
+}
+
 void
 RepetitionRegex::rewind_fixed_children()
 {
@@ -4398,6 +6634,34 @@ RepetitionRegex::rewind_variable_children()
     m_variable_children_at_beginning = true;
 }
 
+// Clamp the maximum count of this repetition to the number of times
+// its child fits in 'length' characters.
+Regex*
+RepetitionRegex::do_specialize_for_length(size_t length)
+{
+    m_child_to_repeat = specialize_for_length(move(m_child_to_repeat), length);
+    rebuild_after_optimization();
+
+    const auto child_min_length = min_length(*m_child_to_repeat);
+
+    if (child_min_length == 0)
+    {
+        // The child may match the empty string any number of times.
+        return this;
+    }
+
+    const RepetitionCount max_count = max(m_min_count.count(),
+                                          length / child_min_length);
+
+    if (m_max_count <= max_count)
+    {
+        return this;
+    }
+
+    return repetition_of(move(m_child_to_repeat), m_min_count, max_count)
+             .release();
+}
+
 void
 RepetitionRegex::set_constraint_size_of_children(size_t constraint_size)
 {
@@ -27,8 +27,12 @@
 #ifndef REGEX_HPP
 #define REGEX_HPP
 
+#include "constraint.hpp"
 #include "group_number.hpp"
+#include "regex_kernel.hpp"
+#include "regex_optimizations.hpp"
 #include "repetition_count.hpp"
+#include "required_literals.hpp"
 #include "set_of_characters.hpp"
 
 #include <iosfwd>
@@ -36,13 +40,12 @@
 #include <string>
 #include <vector>
 
+class Automaton;
 class BackreferenceNumbers;
 class BackreferenceRegex;
 class CharacterBlock;
-class Constraint;
 class GroupRegex;
 class PositiveLookaheadRegex;
-class RegexOptimizations;
 
 
 // class hierarchy
@@ -93,10 +96,21 @@ public:
 
     // accessing
     Constraint constrain(const Constraint& constraint);
+    Constraint constrain(const Constraint&        constraint,
+                         std::vector<Constraint>& supports);
     std::vector<Constraint> constraints(const Constraint& constraint,
                                         size_t            begin_pos);
     std::string explicit_characters() const;
+    bool get_automaton(Automaton& automaton, size_t length) const;
+    bool get_kernel_pieces(std::vector<RegexKernelPiece>& pieces) const;
+    size_t num_enumeration_steps(size_t constraint_size);
+    size_t num_nodes() const;
     static std::unique_ptr<Regex> parse(const std::string& regex_as_string);
+    RequiredLiterals required_literals() const;
+
+    // querying
+    bool has_exact_values() const;
+    bool is_universal(size_t length) const;
 
     // converting
     std::string to_string() const;
@@ -105,39 +119,69 @@ public:
     static std::unique_ptr<Regex> optimize(
                                     std::unique_ptr<Regex>    root,
                                     const RegexOptimizations& optimizations);
+    static std::unique_ptr<Regex> specialize(std::unique_ptr<Regex> root,
+                                             size_t                 length);
 
 protected:
     // instance creation and deletion
     Regex();
+    static std::unique_ptr<Regex> concatenation_of(
+                    std::vector<std::unique_ptr<Regex>> regexes);
+    static std::unique_ptr<Regex> repetition_of(
+                                    std::unique_ptr<Regex> child,
+                                    const RepetitionCount& min_count,
+                                    const RepetitionCount& max_count);
+    static std::unique_ptr<Regex> union_of(
+                    std::vector<std::unique_ptr<Regex>> regexes);
 
     // copying
     static std::unique_ptr<Regex> clone(const Regex& regex, Regex* parent);
 
     // accessing
+    static bool add_to_automaton(const Regex& regex,
+                                 Automaton&   automaton,
+                                 size_t       from,
+                                 size_t       to,
+                                 size_t       max_length);
     static std::vector<const BackreferenceRegex*>
                backreferences_to(const Regex&       regex,
                                  const GroupNumber& group_number);
     size_t begin_pos() const;
+    static std::vector<const Regex*> concatenated_regexes(const Regex& regex);
     static size_t begin_pos(const Regex& regex);
     static bool constrain_as_positive_lookahead(Regex&      regex,
                                                 Constraint& constraint,
                                                 size_t      begin_pos);
+    static std::vector<Constraint> constraints_as_positive_lookahead(
+                                     Regex&            regex,
+                                     const Constraint& constraint,
+                                     size_t            begin_pos);
     static bool constrain_once_with_current_value(Regex&      regex,
                                                   Constraint& constraint,
                                                   size_t      offset);
     static bool constrain_word_boundaries_with_current_value(
                   Regex& regex, Constraint& constraint);
+    const Constraint* constraint_being_constrained() const;
     size_t constraint_size() const;
     static const GroupRegex* enclosing_group(const Regex& regex);
     const GroupRegex* enclosing_group() const;
     static size_t end_pos(const Regex& regex);
     size_t end_pos() const;
+    static SetOfCharacters first_characters(const Regex& regex);
+    static bool get_kernel_pieces(const Regex&                   regex,
+                                  std::vector<RegexKernelPiece>& pieces);
+    static bool get_kernel_strings(const Regex&                    regex,
+                                   std::vector<RegexKernelString>& strings);
     static void get_used_backreference_numbers(
                    const Regex&          regex,
                    BackreferenceNumbers& used_backreference_numbers);
     static std::vector<const GroupRegex*> groups(const Regex& regex);
     static size_t length_of_current_value(const Regex& regex);
     size_t length_of_current_value() const;
+    static RepetitionCount max_repetition_count(const Regex& regex);
+    static size_t min_length(const Regex& regex);
+    static RepetitionCount min_repetition_count(const Regex& regex);
+    static size_t num_nodes(const Regex& regex);
     static Regex* parent(const Regex& regex);
     Regex* parent() const;
     static GroupRegex* rightmost_group(Regex&             regex,
@@ -147,9 +191,17 @@ protected:
                                        const GroupNumber& group_number);
     GroupRegex* rightmost_group_from_parent(
                   const GroupNumber& group_number) const;
+    static const Regex& repeated_regex(const Regex& regex);
     const Regex& root() const;
+    static SetOfCharacters single_characters(const Regex& regex);
+    static std::vector<std::unique_ptr<Regex>> split_concatenation(
+                                                 std::unique_ptr<Regex> regex);
+    static std::vector<bool> universal_lengths(const Regex& regex,
+                                               size_t       max_length);
 
     // querying
+    static bool are_identical_blocks(const Regex& regex_1,
+                                     const Regex& regex_2);
     static bool at_end(const Regex& regex);
     bool        at_end() const;
     static bool can_be_concatenated(const Regex& regex);
@@ -160,14 +212,19 @@ protected:
     static bool has_a_value(const Regex& regex);
     bool        has_a_value() const;
     static bool has_a_value_which_fits(const Regex& regex);
+    static bool has_exact_values(const Regex& regex);
     static bool is_character_block(const Regex& regex);
     static bool is_concatenation(const Regex& regex);
     static bool is_empty(const Regex& regex);
+    static bool is_epsilon(const Regex& regex);
+    static bool is_repetition(const Regex& regex);
     static bool is_string(const Regex& regex);
     static bool is_union(const Regex& regex);
     static bool not_at_end(const Regex& regex);
     bool        not_at_end() const;
     static bool parents_are_correctly_setup(const Regex& regex);
+    static bool repetitions_can_be_merged(const Regex& regex_1,
+                                          const Regex& regex_2);
     static bool value_is_epsilon(const Regex& regex);
 
     // converting
@@ -180,6 +237,11 @@ protected:
     virtual void do_increment() = 0;
     virtual void do_set_constraint_size(size_t constraint_size);
     static void increment(Regex& regex);
+    static std::unique_ptr<Regex> merge_repetitions(
+                                    std::unique_ptr<Regex> regex_1,
+                                    std::unique_ptr<Regex> regex_2);
+    static std::unique_ptr<Regex> optimize(std::unique_ptr<Regex> root,
+                                           RegexOptimizations::Type type);
     static std::unique_ptr<Regex> optimize_concatenations(
                                     std::unique_ptr<Regex> regex);
     static std::unique_ptr<Regex> optimize_concatenations_of_root(
@@ -188,11 +250,19 @@ protected:
                                     std::unique_ptr<Regex> regex);
     static std::unique_ptr<Regex> optimize_concatenations_on_right(
                                     std::unique_ptr<Regex> regex);
+    static std::unique_ptr<Regex> optimize_factorizations(
+                                    std::unique_ptr<Regex> regex);
+    static std::unique_ptr<Regex> optimize_factorizations_of_root(
+                                    std::unique_ptr<Regex> root);
     static std::unique_ptr<Regex> optimize_groups(
         std::unique_ptr<Regex>      regex,
         const BackreferenceNumbers& used_backreference_numbers);
     static std::unique_ptr<Regex> optimize_groups_of_root(
                                     std::unique_ptr<Regex> root);
+    static std::unique_ptr<Regex> optimize_repetitions(
+                                    std::unique_ptr<Regex> regex);
+    static std::unique_ptr<Regex> optimize_repetitions_of_root(
+                                    std::unique_ptr<Regex> root);
     static std::unique_ptr<Regex> optimize_unions(
                                     std::unique_ptr<Regex> regex);
     static std::unique_ptr<Regex> optimize_unions_of_root(
@@ -203,6 +273,9 @@ protected:
     static void rewind(Regex& regex, size_t begin_pos);
     static void set_constraint_size(Regex& regex, size_t constraint_size);
     static void set_parent(Regex& regex, Regex* parent);
+    static std::unique_ptr<Regex> specialize_for_length(
+                                    std::unique_ptr<Regex> regex,
+                                    size_t                 length);
 
     // error handling
     static void check_no_self_references(const Regex& regex);
@@ -220,6 +293,8 @@ private:
     // accessing
     virtual std::vector<const BackreferenceRegex*>
                 backreferences_to(const GroupNumber& group_number) const = 0;
+    Constraint constrain(const Constraint&        constraint,
+                         std::vector<Constraint>* supports);
     bool constrain_as_positive_lookahead(Constraint& constraint,
                                          size_t      begin_pos);
     bool constrain_once_with_current_value(Constraint& constraint);
@@ -227,17 +302,36 @@ private:
                                            size_t      offset);
     bool constrain_with_current_value(Constraint& constraint);
     bool constrain_word_boundaries_with_current_value(Constraint& constraint);
+    std::vector<Constraint> constraints_as_positive_lookahead(
+                              const Constraint& constraint, size_t begin_pos);
+    virtual bool do_add_to_automaton(Automaton& automaton,
+                                     size_t     from,
+                                     size_t     to,
+                                     size_t     max_length) const;
     virtual bool do_constrain_once_with_current_value(
                    Constraint& constraint, size_t offset) = 0;
     virtual bool do_constrain_word_boundaries_with_current_value(
                    Constraint& constraint) = 0;
     virtual std::string do_explicit_characters() const = 0;
+    virtual SetOfCharacters do_first_characters() const;
+    virtual bool do_get_kernel_pieces(
+                   std::vector<RegexKernelPiece>& pieces) const;
+    virtual bool do_get_kernel_strings(
+                   std::vector<RegexKernelString>& strings) const;
     virtual void do_get_used_backreference_numbers(
                    BackreferenceNumbers& used_backreference_numbers) const = 0;
     virtual size_t do_length_of_current_value() const = 0;
+    virtual RepetitionCount do_max_repetition_count() const;
+    virtual size_t do_min_length() const;
+    virtual RepetitionCount do_min_repetition_count() const;
+    virtual size_t do_num_nodes() const = 0;
+    virtual const Regex& do_repeated_regex() const;
     virtual GroupRegex* do_rightmost_group(const GroupNumber& group_number,
                                            const Regex*       from_child) = 0;
     virtual GroupRegex* do_rightmost_group(const GroupNumber& group_number) = 0;
+    virtual SetOfCharacters do_single_characters() const;
+    virtual RequiredLiterals do_required_literals() const;
+    virtual std::vector<bool> do_universal_lengths(size_t max_length) const;
     const PositiveLookaheadRegex* enclosing_lookahead() const;
     virtual std::vector<const GroupRegex*> groups() const = 0;
     static size_t invalid_begin_pos(size_t constraint_size);
@@ -253,9 +347,12 @@ private:
     virtual bool do_can_be_unified() const;
     virtual bool do_characters_were_constrained_by_backreference() const = 0;
     virtual bool do_has_a_value() const;
+    virtual bool do_has_exact_values() const;
     virtual bool do_is_character_block() const;
     virtual bool do_is_concatenation() const;
     virtual bool do_is_empty() const;
+    virtual bool do_is_epsilon() const;
+    virtual bool do_is_repetition() const;
     virtual bool do_is_string() const;
     virtual bool do_is_union() const;
     virtual bool do_parents_are_correctly_setup() const = 0;
@@ -272,12 +369,15 @@ private:
     virtual Regex* do_optimize_concatenations() = 0;
     virtual Regex* do_optimize_concatenations_on_left();
     virtual Regex* do_optimize_concatenations_on_right();
+    virtual Regex* do_optimize_factorizations() = 0;
     virtual Regex* do_optimize_groups(
                     const BackreferenceNumbers& used_backreference_numbers) = 0;
+    virtual Regex* do_optimize_repetitions() = 0;
     virtual Regex* do_optimize_unions() = 0;
     virtual void do_reset_after_constrain() = 0;
     virtual void do_reset_characters_were_constrained_by_backreference() = 0;
     virtual void do_rewind() = 0;
+    virtual Regex* do_specialize_for_length(size_t length) = 0;
     void increment();
     void rewind();
     void rewind(size_t begin_pos);
@@ -285,6 +385,7 @@ private:
     void set_constraint_size(size_t constraint_size);
     virtual void set_constraint_size_of_children(size_t constraint_size) = 0;
     void set_parent(Regex* parent);
+    void unset_constraint_size();
 
     // error handling
     void check_lookaheads_are_not_referenced_from_outside() const;
@@ -300,6 +401,16 @@ private:
     // The size of the constraint that this regex is to handle.
     size_t m_constraint_size;
 
+    // The constraint which this regex is constraining, while
+    // constrain() or constraints() is running on this regex, or
+    // 'nullptr' otherwise. It is only set on the root of a parse tree.
+    const Constraint* m_constraint_being_constrained;
+
+    // The root of the parse tree of this regex, or 'nullptr' if it is
+    // not known yet. It is forgotten when the constraint size is set,
+    // since the parse tree may have changed since it was last set.
+    mutable const Regex* m_root;
+
     // The position in the constraint where the value of this regex
     // starts to apply.
     //
@@ -344,6 +455,7 @@ private:
     void do_get_used_backreference_numbers(
            BackreferenceNumbers& used_backreference_numbers) const override;
     size_t do_length_of_current_value() const override;
+    size_t do_num_nodes() const override;
     GroupRegex* do_rightmost_group(const GroupNumber& group_number,
                                    const Regex*       from_child) override;
     GroupRegex* do_rightmost_group(const GroupNumber& group_number) override;
@@ -351,17 +463,21 @@ private:
 
     // querying
     bool do_characters_were_constrained_by_backreference() const override;
+    virtual bool do_is_impossible_at_begin_pos() const;
     bool do_parents_are_correctly_setup() const override;
 
     // modifying
     void do_increment() override;
     Regex* do_optimize_concatenations() override;
+    Regex* do_optimize_factorizations() override;
     Regex* do_optimize_groups(
              const BackreferenceNumbers& used_backreference_numbers) override;
+    Regex* do_optimize_repetitions() override;
     Regex* do_optimize_unions() override;
     void do_reset_after_constrain() override;
     void do_reset_characters_were_constrained_by_backreference() override;
     void do_rewind() override;
+    Regex* do_specialize_for_length(size_t length) override;
     void set_constraint_size_of_children(size_t constraint_size) override;
 
     // error handling
@@ -389,6 +505,12 @@ private:
     // copying
     std::unique_ptr<Regex> do_clone() const override;
 
+    // accessing
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
+
     // querying
     bool do_at_end() const override;
     bool do_can_be_unified() const override;
@@ -414,8 +536,19 @@ private:
     // copying
     std::unique_ptr<Regex> do_clone() const override;
 
+    // accessing
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
+    bool do_get_kernel_strings(
+           std::vector<RegexKernelString>& strings) const override;
+    RequiredLiterals do_required_literals() const override;
+    std::vector<bool> do_universal_lengths(size_t max_length) const override;
+
     // querying
     bool do_can_be_concatenated() const override;
+    bool do_is_epsilon() const override;
 
     // converting
     std::string do_to_string() const override;
@@ -439,6 +572,10 @@ private:
     std::unique_ptr<Regex> do_clone() const override;
 
     // accessing
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
 
@@ -464,6 +601,10 @@ private:
     std::unique_ptr<Regex> do_clone() const override;
 
     // accessing
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
 
@@ -494,6 +635,10 @@ private:
 
     // converting
     std::string do_to_string() const override;
+
+    // querying
+    bool do_has_exact_values() const override;
+    bool do_is_impossible_at_begin_pos() const override;
 };
 
 
@@ -519,6 +664,10 @@ private:
 
     // converting
     std::string do_to_string() const override;
+
+    // querying
+    bool do_has_exact_values() const override;
+    bool do_is_impossible_at_begin_pos() const override;
 };
 
 
@@ -537,23 +686,33 @@ private:
     // accessing
     std::vector<const BackreferenceRegex*>
         backreferences_to(const GroupNumber& group_number) const override;
+    const std::vector<Constraint>&
+        allowed_constraints(const Constraint& root_constraint);
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
     std::string do_explicit_characters() const override;
     void do_get_used_backreference_numbers(
            BackreferenceNumbers& used_backreference_numbers) const override;
+    size_t do_num_nodes() const override;
     std::vector<const GroupRegex*> groups() const override;
     const PositiveLookaheadRegex*
         yourself_or_enclosing_lookahead() const override;
 
+    // querying
+    bool do_has_exact_values() const override;
+
     // converting
     std::string do_to_string() const override;
 
     // modifying
     Regex* do_optimize_concatenations() override;
+    Regex* do_optimize_factorizations() override;
     Regex* do_optimize_groups(
              const BackreferenceNumbers& used_backreference_numbers) override;
+    Regex* do_optimize_repetitions() override;
     Regex* do_optimize_unions() override;
+    void do_set_constraint_size(size_t constraint_size) override;
+    Regex* do_specialize_for_length(size_t length) override;
     void set_constraint_size_of_children(size_t constraint_size) override;
 
     // error handling
@@ -562,6 +721,23 @@ private:
     // The regex which this lookahead regex asserts. For example, if
     // this lookahead regex is '(?=abc)', m_regex is 'abc'.
     std::unique_ptr<Regex> m_regex;
+
+    // Whether m_regex constrains each position of a constraint
+    // independently of the other positions (i.e., whether the regex
+    // kernels support it: it has no backreferences, lookaheads or word
+    // boundaries), and whether that was determined yet. Only such
+    // lookaheads use the cache below.
+    bool m_regex_is_positional;
+    bool m_regex_is_positional_is_initialized;
+
+    // For each begin position, the constraints which m_regex
+    // allows from that position when constraining m_root_constraint, if
+    // they were computed since m_root_constraint was set. These are
+    // computed once per call to constrain() on the root, instead of
+    // enumerating m_regex each time that this lookahead is reached.
+    Constraint                           m_root_constraint;
+    std::vector<std::vector<Constraint>> m_allowed_constraints;
+    std::vector<bool>                    m_allowed_constraints_are_computed;
 };
 
 
@@ -593,10 +769,20 @@ private:
     // accessing
     const SetOfCharacters& characters() const;
     SetOfCharacters compute_characters() const;
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
     std::string do_explicit_characters() const override;
+    SetOfCharacters do_first_characters() const override;
+    bool do_get_kernel_strings(
+           std::vector<RegexKernelString>& strings) const override;
     size_t do_length_of_current_value() const override;
+    size_t do_min_length() const override;
+    RequiredLiterals do_required_literals() const override;
+    SetOfCharacters do_single_characters() const override;
 
     // querying
     bool do_can_be_concatenated() const override;
@@ -660,12 +846,23 @@ private:
 
     // accessing
     std::vector<SetOfCharacters>& characters() const;
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
     std::string do_explicit_characters() const override;
+    SetOfCharacters do_first_characters() const override;
+    bool do_get_kernel_strings(
+           std::vector<RegexKernelString>& strings) const override;
     size_t do_length_of_current_value() const override;
     void initialize_characters() const;
     void initialize_constrained_characters();
+    size_t do_min_length() const override;
+    RequiredLiterals do_required_literals() const override;
+    SetOfCharacters do_single_characters() const override;
+    std::vector<bool> do_universal_lengths(size_t max_length) const override;
 
     // querying
     bool do_can_be_concatenated() const override;
@@ -728,6 +925,7 @@ private:
         backreferences_to(const GroupNumber& group_number) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
+    SetOfCharacters do_first_characters() const override;
     void do_get_used_backreference_numbers(
            BackreferenceNumbers& used_backreference_numbers) const override;
     size_t do_length_of_current_value() const override;
@@ -735,6 +933,7 @@ private:
 
     // querying
     bool do_has_a_value() const override;
+    bool do_has_exact_values() const override;
 
     // converting
     std::string do_to_string() const override;
@@ -764,18 +963,33 @@ private:
     // accessing
     std::vector<const BackreferenceRegex*>
         backreferences_to(const GroupNumber& group_number) const override;
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
     bool do_constrain_word_boundaries_with_current_value(
            Constraint& constraint) override;
     std::string do_explicit_characters() const override;
+    SetOfCharacters do_first_characters() const override;
+    bool do_get_kernel_pieces(
+           std::vector<RegexKernelPiece>& pieces) const override;
+    bool do_get_kernel_strings(
+           std::vector<RegexKernelString>& strings) const override;
     void do_get_used_backreference_numbers(
            BackreferenceNumbers& used_backreference_numbers) const override;
     size_t do_length_of_current_value() const override;
+    size_t do_num_nodes() const override;
+    size_t do_min_length() const override;
+    RequiredLiterals do_required_literals() const override;
+    SetOfCharacters do_single_characters() const override;
+    std::vector<bool> do_universal_lengths(size_t max_length) const override;
 
     // querying
     bool do_at_end() const override;
     bool do_characters_were_constrained_by_backreference() const override;
+    bool do_has_exact_values() const override;
     bool do_parents_are_correctly_setup() const override;
     virtual bool number_belongs_to(
                    const BackreferenceNumbers& backreference_numbers) const = 0;
@@ -783,12 +997,15 @@ private:
     // modifying
     void do_increment() override;
     Regex* do_optimize_concatenations() override;
+    Regex* do_optimize_factorizations() override;
     Regex* do_optimize_groups(
              const BackreferenceNumbers& used_backreference_numbers) override;
+    Regex* do_optimize_repetitions() override;
     Regex* do_optimize_unions() override;
     void do_reset_after_constrain() override;
     void do_reset_characters_were_constrained_by_backreference() override;
     void do_rewind() override;
+    Regex* do_specialize_for_length(size_t length) override;
     void set_constraint_size_of_children(size_t constraint_size) override;
 
     // error handling
@@ -910,9 +1127,11 @@ private:
     void do_get_used_backreference_numbers(
            BackreferenceNumbers& used_backreference_numbers) const override;
     std::vector<const GroupRegex*> groups() const override;
+    size_t do_num_nodes() const override;
     virtual std::string operator_string() const = 0;
 
     // querying
+    bool do_has_exact_values() const override;
     bool do_parents_are_correctly_setup() const override;
 
     // converting
@@ -920,11 +1139,14 @@ private:
 
     // modifying
     Regex* do_optimize_concatenations() override;
+    Regex* do_optimize_factorizations() override;
     Regex* do_optimize_groups(
              const BackreferenceNumbers& used_backreference_numbers) override;
+    Regex* do_optimize_repetitions() override;
     Regex* do_optimize_unions() override;
     void do_reset_after_constrain() override;
     void do_reset_characters_were_constrained_by_backreference() override;
+    Regex* do_specialize_for_length(size_t length) override;
     void set_constraint_size_of_children(size_t constraint_size) override;
 
     // error handling
@@ -952,6 +1174,10 @@ public:
     ConcatenationRegex(std::unique_ptr<Regex> left_child,
                        std::unique_ptr<Regex> right_child);
 
+    // accessing
+    std::vector<const Regex*> operands() const;
+    std::vector<std::unique_ptr<Regex>> steal_operands();
+
 private:
     // instance creation and deletion
     std::unique_ptr<Regex>
@@ -962,15 +1188,28 @@ private:
     std::unique_ptr<Regex> do_clone() const override;
 
     // accessing
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
     bool do_constrain_word_boundaries_with_current_value(
            Constraint& constraint) override;
+    SetOfCharacters do_first_characters() const override;
+    bool do_get_kernel_pieces(
+           std::vector<RegexKernelPiece>& pieces) const override;
+    bool do_get_kernel_strings(
+           std::vector<RegexKernelString>& strings) const override;
     size_t do_length_of_current_value() const override;
     GroupRegex* do_rightmost_group(const GroupNumber& group_number,
                                    const Regex*       from_child) override;
     GroupRegex* do_rightmost_group(const GroupNumber& group_number) override;
     std::string operator_string() const override;
+    size_t do_min_length() const override;
+    RequiredLiterals do_required_literals() const override;
+    SetOfCharacters do_single_characters() const override;
+    std::vector<bool> do_universal_lengths(size_t max_length) const override;
 
     // querying
     bool do_at_end() const override;
@@ -983,6 +1222,7 @@ private:
     Regex* do_optimize_concatenations() override;
     Regex* do_optimize_concatenations_on_left() override;
     Regex* do_optimize_concatenations_on_right() override;
+    Regex* do_optimize_repetitions() override;
     void   do_rewind() override;
     Regex* optimize_concatenations_left_and_right();
     Regex* optimize_concatenations_left_and_right_left();
@@ -1004,6 +1244,10 @@ public:
     UnionRegex(std::unique_ptr<Regex> left_child,
                std::unique_ptr<Regex> right_child);
 
+    // accessing
+    std::vector<const Regex*> alternatives() const;
+    std::vector<std::unique_ptr<Regex>> steal_alternatives();
+
 private:
     // instance creation and deletion
     std::unique_ptr<Regex>
@@ -1015,34 +1259,87 @@ private:
 
     // accessing
     Regex& active_child() const;
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
     bool do_constrain_word_boundaries_with_current_value(
            Constraint& constraint) override;
+    SetOfCharacters do_first_characters() const override;
+    bool do_get_kernel_strings(
+           std::vector<RegexKernelString>& strings) const override;
     size_t do_length_of_current_value() const override;
     GroupRegex* do_rightmost_group(const GroupNumber& group_number,
                                    const Regex*       from_child) override;
     GroupRegex* do_rightmost_group(const GroupNumber& group_number) override;
     Regex& first_child_with_a_value() const;
     std::string operator_string() const override;
+    size_t do_min_length() const override;
+    RequiredLiterals do_required_literals() const override;
+    SetOfCharacters do_single_characters() const override;
+    std::vector<bool> do_universal_lengths(size_t max_length) const override;
 
     // querying
+    bool child_can_be_skipped(const SetOfCharacters& first_characters,
+                              bool                   child_may_be_empty) const;
     bool do_at_end() const override;
     bool do_characters_were_constrained_by_backreference() const override;
     bool do_is_union() const override;
     bool either_child_can_be_unified() const;
+    bool left_child_at_end() const;
+    bool right_child_at_end() const;
 
     // modifying
     void   do_increment() override;
+    Regex* do_optimize_factorizations() override;
     Regex* do_optimize_unions() override;
+    void   do_set_constraint_size(size_t constraint_size) override;
+    Regex* do_specialize_for_length(size_t length) override;
     void   do_rewind() override;
+    void   initialize_first_characters();
+    void   optimize_factorizations_of_alternatives();
     Regex* optimize_unions_left_and_right();
     Regex* optimize_unions_left_and_right_either();
     Regex* optimize_unions_left_either_and_right();
     Regex* optimize_unions_left_either_and_right_either();
     void   place_child_which_can_be_unified_to_left();
     void   place_child_which_can_be_unified_to_right();
+    void   rewind_left_child();
+    void   rewind_right_child();
     Regex* unify();
+
+    // data members
+
+    // Whether the first characters of the children and whether they may
+    // be empty are initialized. They are only initialized when they are
+    // first needed, since they depend on the alphabet.
+    bool m_first_characters_are_initialized;
+
+    // The characters which the non-empty values of the left and right
+    // children may start with.
+    //
+    // For example, in 'AB|C.|DE', these are { A } for 'AB' and
+    // { C, D } for 'C.|DE'.
+    SetOfCharacters m_first_characters_of_left_child;
+    SetOfCharacters m_first_characters_of_right_child;
+
+    // Whether the left and right children may have empty values. Such
+    // children are never skipped.
+    bool m_left_child_may_be_empty;
+    bool m_right_child_may_be_empty;
+
+    // Whether the left and right children were skipped when they were
+    // last rewound, because the constraint being constrained allows
+    // none of their first characters at begin_pos(). A skipped child is
+    // at its end.
+    //
+    // Thanks to the right-leaning shape of union trees, a whole group
+    // of alternatives is skipped at once: in 'AB|C.|DE', all of 'C.|DE'
+    // is skipped if neither C nor D is allowed.
+    bool m_left_child_is_skipped;
+    bool m_right_child_is_skipped;
 };
 
 
@@ -1068,11 +1365,18 @@ private:
     // accessing
     std::vector<const BackreferenceRegex*>
         backreferences_to(const GroupNumber& group_number) const override;
+    bool do_add_to_automaton(Automaton& automaton,
+                             size_t     from,
+                             size_t     to,
+                             size_t     max_length) const override;
     bool do_constrain_once_with_current_value(
            Constraint& constraint, size_t offset) override;
     bool do_constrain_word_boundaries_with_current_value(
            Constraint& constraint) override;
     std::string do_explicit_characters() const override;
+    SetOfCharacters do_first_characters() const override;
+    bool do_get_kernel_pieces(
+           std::vector<RegexKernelPiece>& pieces) const override;
     void do_get_used_backreference_numbers(
            BackreferenceNumbers& used_backreference_numbers) const override;
     size_t do_length_of_current_value() const override;
@@ -1081,13 +1385,24 @@ private:
     GroupRegex* do_rightmost_group(const GroupNumber& group_number) override;
     std::vector<const GroupRegex*> groups() const override;
     std::unique_ptr<Regex>& last_variable_child();
+    RepetitionCount do_max_repetition_count() const override;
+    RepetitionCount do_min_repetition_count() const override;
+    size_t do_num_nodes() const override;
+    const Regex& do_repeated_regex() const override;
     virtual std::string repetition_suffix() const = 0;
+    size_t do_min_length() const override;
+    RequiredLiterals do_required_literals() const override;
+    SetOfCharacters do_single_characters() const override;
+    std::vector<bool> do_universal_lengths(size_t max_length) const override;
 
     // querying
     bool do_at_end() const override;
     bool do_characters_were_constrained_by_backreference() const override;
+    bool do_has_exact_values() const override;
+    bool do_is_repetition() const override;
     bool do_parents_are_correctly_setup() const override;
     bool fixed_children_at_end() const;
+    bool is_compact() const;
     bool variable_children_at_end() const;
 
     // converting
@@ -1096,25 +1411,31 @@ private:
     // modifying
     void append_fixed_child();
     void append_variable_child();
+    bool constrain_copies_once(Constraint& constraint, size_t offset);
     void do_increment() override;
     Regex* do_optimize_concatenations() override;
+    Regex* do_optimize_factorizations() override;
     Regex* do_optimize_groups(
              const BackreferenceNumbers& used_backreference_numbers) override;
+    Regex* do_optimize_repetitions() override;
     Regex* do_optimize_unions() override;
     void do_reset_after_constrain() override;
     void do_reset_characters_were_constrained_by_backreference() override;
     void do_rewind() override;
     void do_set_constraint_size(size_t constraint_size) override;
+    void increment_copies();
     void increment_fixed_children();
     void increment_variable_children();
     void remove_last_variable_child();
     void remove_variable_children();
+    void rewind_copies();
     void rewind_fixed_children();
     std::vector<std::unique_ptr<Regex>>::const_iterator
          rewind_fixed_children(
           std::vector<std::unique_ptr<Regex>>::const_iterator first,
           size_t                                              first_begin_pos);
     void rewind_variable_children();
+    Regex* do_specialize_for_length(size_t length) override;
     void set_constraint_size_of_children(size_t constraint_size) override;
     void while_fixed_child_at_end_increment_fixed(
            std::vector<std::unique_ptr<Regex>>::const_iterator
@@ -1189,6 +1510,29 @@ private:
     // The concatenation of 'm_fixed_children' and
     // 'm_variable_children'.
     std::vector<Regex*> m_all_children;
+
+    // The number of copies of 'm_child_to_repeat' in the current value
+    // of this repetition, if this repetition is compact (see
+    // is_compact()).
+    //
+    // A compact repetition never builds its fixed and variable
+    // children: 'A{50}' or '.*' iterate on this number instead.
+    size_t m_num_copies;
+
+    // Whether the iteration on 'm_num_copies' is at its end.
+    bool m_copies_at_end;
+
+    // The characters of the copies in the current value of this
+    // repetition, as restricted by backreferences, if this repetition
+    // is compact. See CharacterBlockRegex::m_constrained_characters.
+    //
+    // Only the first elements are meaningful: the copies beyond them
+    // have not been restricted yet.
+    std::vector<SetOfCharacters> m_constrained_characters_of_copies;
+
+    // Whether the last backreference which constrained the copies
+    // restricted 'm_constrained_characters_of_copies'.
+    bool m_copies_were_constrained_by_backreference;
 };
 
 
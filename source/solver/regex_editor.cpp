@@ -0,0 +1,353 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "regex_editor.hpp"
+
+#include "alphabet.hpp"
+#include "grid.hpp"
+#include "grid_cell.hpp"
+#include "grid_line.hpp"
+#include "grid_line_regex.hpp"
+#include "regex_crossword_solver_exception.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <set>
+#include <utility>
+
+using namespace std;
+
+
+namespace
+{
+
+// The maximum number of steps with which to prove that a new regex
+// matches no strings which the replaced one does not match (see
+// GridLineRegex::is_included_in()).
+const size_t max_num_inclusion_steps = 10000;
+
+} // unnamed namespace
+
+
+// instance creation and deletion
+
+// 'grid' should not be optimized yet: its regexes, as well as the new
+// ones, are optimized according to 'optimizations'.
+RegexEditor::RegexEditor(unique_ptr<Grid>          grid,
+                         const RegexOptimizations& optimizations,
+                         const SearchOptions&      options) :
+  m_optimizations(optimizations),
+  m_search_options(options),
+  m_unconstrained_grid(move(grid)),
+  m_root_is_consistent(false),
+  m_num_edits(0),
+  m_num_edits_from_root(0),
+  m_num_edits_of_alphabet(0),
+  m_total_edit_time_ms(0.0),
+  m_max_edit_time_ms(0.0)
+{
+    assert(m_unconstrained_grid != nullptr);
+
+    m_unconstrained_grid->optimize(m_optimizations);
+    m_unconstrained_grid->m_search_options =
+        make_shared<const SearchOptions>(m_search_options);
+
+    for (const auto line : m_unconstrained_grid->all_lines())
+    {
+        vector<string> explicit_characters;
+
+        for (size_t i = 0; i != line->num_regexes(); ++i)
+        {
+            const GridLineRegex grid_line_regex(
+                                  line->grid_line_regex(i).as_string());
+            explicit_characters.push_back(
+              grid_line_regex.explicit_characters());
+        }
+
+        m_explicit_characters.push_back(explicit_characters);
+    }
+
+    constrain_root();
+    solve();
+}
+
+RegexEditor::~RegexEditor() = default;
+
+// accessing
+
+// Return the alphabet (see Alphabet::characters_as_string()) of the grid
+// if the regex of the line with index 'line_index' with index
+// 'regex_index' had 'explicit_characters'.
+string
+RegexEditor::alphabet_with(size_t        line_index,
+                           size_t        regex_index,
+                           const string& explicit_characters) const
+{
+    set<char> characters(explicit_characters.cbegin(),
+                         explicit_characters.cend());
+
+    for (size_t i = 0; i != m_explicit_characters.size(); ++i)
+    {
+        for (size_t j = 0; j != m_explicit_characters[i].size(); ++j)
+        {
+            if (i != line_index || j != regex_index)
+            {
+                const auto& s = m_explicit_characters[i][j];
+                characters.insert(s.cbegin(), s.cend());
+            }
+        }
+    }
+
+    return string(characters.cbegin(), characters.cend());
+}
+
+size_t
+RegexEditor::num_lines() const
+{
+    return m_explicit_characters.size();
+}
+
+size_t
+RegexEditor::num_regexes(size_t line_index) const
+{
+    assert(line_index < num_lines());
+    return m_explicit_characters[line_index].size();
+}
+
+// Return the number of solutions of the grid, where 2 means two or
+// more.
+size_t
+RegexEditor::num_solutions() const
+{
+    return m_solutions.size();
+}
+
+string
+RegexEditor::regex(size_t line_index, size_t regex_index) const
+{
+    assert(regex_index < num_regexes(line_index));
+
+    const auto line = m_unconstrained_grid->all_lines()[line_index];
+    return line->grid_line_regex(regex_index).as_string();
+}
+
+// Return the solutions of the grid, up to two.
+const vector<unique_ptr<Grid>>&
+RegexEditor::solutions() const
+{
+    return m_solutions;
+}
+
+// querying
+
+bool
+RegexEditor::has_unique_solution() const
+{
+    return num_solutions() == 1;
+}
+
+// printing
+
+vector<string>
+RegexEditor::print_statistics() const
+{
+    const auto mean_edit_time_ms =
+        m_num_edits == 0                                               ?
+        0.0                                                            :
+        m_total_edit_time_ms / static_cast<double>(m_num_edits);
+
+    return
+    {
+        Utils::statistics_line("edits", Utils::to_string(m_num_edits)),
+        Utils::statistics_line("edits from root",
+                               Utils::to_string(m_num_edits_from_root)),
+        Utils::statistics_line("alphabet changes",
+                               Utils::to_string(m_num_edits_of_alphabet)),
+        Utils::statistics_line("mean time (ms)",
+                               Utils::to_string(mean_edit_time_ms)),
+        Utils::statistics_line("max time (ms)",
+                               Utils::to_string(m_max_edit_time_ms))
+    };
+}
+
+// modifying
+
+// Constrain a copy of the unconstrained grid, and make it the root.
+void
+RegexEditor::constrain_root()
+{
+    m_root = m_unconstrained_grid->clone();
+    m_root_is_consistent = m_root->constrain();
+}
+
+// Rebuild the unconstrained grid, and its root, with 'alphabet' (see
+// Alphabet::set()) and the regexes in 'regex_groups' (one group per
+// line), all of them parsed anew.
+//
+// If 'alphabet' is not valid, an AlphabetException is thrown, and this
+// editor is left unchanged.
+void
+RegexEditor::rebuild(const string&                 alphabet,
+                     const vector<vector<string>>& regex_groups)
+{
+    // The hash of a cell is updated from the characters it loses, which
+    // are indexed in the alphabet. Its cells are thus emptied before the
+    // alphabet changes, and filled again afterwards.
+    const auto cells = m_unconstrained_grid->all_cells();
+
+    for (const auto& cell : cells)
+    {
+        cell->set_possible_characters(SetOfCharacters());
+    }
+
+    try
+    {
+        Alphabet::set(alphabet);
+    }
+    catch (const AlphabetException&)
+    {
+        m_unconstrained_grid->initialize_cells();
+        throw;
+    }
+
+    const auto lines = m_unconstrained_grid->all_lines();
+
+    for (size_t i = 0; i != lines.size(); ++i)
+    {
+        for (size_t j = 0; j != regex_groups[i].size(); ++j)
+        {
+            lines[i]->replace_regex(j, GridLineRegex(regex_groups[i][j]));
+        }
+    }
+
+    m_unconstrained_grid->ignore_universal_regexes();
+    m_unconstrained_grid->specialize_regexes();
+    m_unconstrained_grid->initialize_cells();
+    m_unconstrained_grid->optimize(m_optimizations);
+    constrain_root();
+}
+
+// Replace the regex of the line with index 'line_index' with index
+// 'regex_index' with 'regex_as_string'. Return the number of solutions
+// of the grid afterwards (see num_solutions()).
+//
+// If 'regex_as_string' is not a valid regex, a RegexParseException is
+// thrown, and if the alphabet of the grid with it is not valid, an
+// AlphabetException is thrown. In both cases, this editor is left
+// unchanged.
+size_t
+RegexEditor::replace_regex(size_t        line_index,
+                           size_t        regex_index,
+                           const string& regex_as_string)
+{
+    assert(regex_index < num_regexes(line_index));
+
+    using Clock = chrono::steady_clock;
+    const auto start = Clock::now();
+
+    GridLineRegex new_regex(regex_as_string);
+    const auto explicit_characters = new_regex.explicit_characters();
+    const auto alphabet =
+        alphabet_with(line_index, regex_index, explicit_characters);
+
+    if (alphabet != Alphabet::characters_as_string())
+    {
+        vector<vector<string>> regex_groups;
+
+        for (size_t i = 0; i != num_lines(); ++i)
+        {
+            regex_groups.emplace_back();
+
+            for (size_t j = 0; j != num_regexes(i); ++j)
+            {
+                regex_groups.back().push_back(
+                  i == line_index && j == regex_index ? regex_as_string
+                                                      : regex(i, j));
+            }
+        }
+
+        // The analysis of all the regexes depends on the alphabet.
+        rebuild(alphabet, regex_groups);
+        ++m_num_edits_of_alphabet;
+    }
+    else
+    {
+        const auto line = m_unconstrained_grid->all_lines()[line_index];
+        const auto line_length = line->num_cells();
+
+        new_regex.ignore_if_universal(line_length);
+        new_regex.specialize(line_length);
+        new_regex.optimize(m_optimizations);
+
+        const auto starts_from_root =
+            new_regex.is_included_in(line->grid_line_regex(regex_index),
+                                     line_length,
+                                     max_num_inclusion_steps);
+
+        line->replace_regex(regex_index, new_regex);
+        m_unconstrained_grid->initialize_cells();
+
+        if (starts_from_root)
+        {
+            // The root is constrained further, from the line of the new
+            // regex. A root without solutions has none with it either.
+            m_root->all_lines()[line_index]->replace_regex(regex_index,
+                                                           new_regex);
+            m_root_is_consistent = m_root_is_consistent && m_root->constrain();
+            ++m_num_edits_from_root;
+        }
+        else
+        {
+            constrain_root();
+        }
+    }
+
+    m_explicit_characters[line_index][regex_index] = explicit_characters;
+    solve();
+
+    const auto edit_time_ms =
+        chrono::duration<double, milli>(Clock::now() - start).count();
+
+    ++m_num_edits;
+    m_total_edit_time_ms += edit_time_ms;
+    m_max_edit_time_ms = max(m_max_edit_time_ms, edit_time_ms);
+
+    return num_solutions();
+}
+
+// Search a copy of the root for up to two solutions.
+void
+RegexEditor::solve()
+{
+    m_solutions.clear();
+
+    if (m_root_is_consistent)
+    {
+        m_solutions = m_root->clone()->solve(2, m_search_options);
+    }
+}
@@ -0,0 +1,137 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef REGEX_EDITOR_HPP
+#define REGEX_EDITOR_HPP
+
+#include "regex_optimizations.hpp"
+#include "search_options.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Grid;
+
+
+// An instance of this class tells a puzzle author, after each edit of
+// one of the regexes of a grid, whether the grid still has exactly one
+// solution.
+//
+// An edit does not read and solve the grid from scratch:
+// * Only the new regex is parsed and optimized. The other regexes keep
+//   their analysis (their kernels, profiles, etc.), unless the edit
+//   changes the alphabet (see Alphabet), which all of them depend on.
+// * If each string which the new regex matches is matched by the
+//   replaced one as well (see GridLineRegex::is_included_in()), the
+//   new grid has no solutions which the old one did not have, so that
+//   constraining it may start from the root of the old one - the grid
+//   constrained before any search - which is kept. Otherwise,
+//   constraining starts over from the unconstrained grid, which is kept
+//   as well.
+// * The search stops after two solutions.
+//
+// The regexes are designated by the index of their line, in the order
+// in which the regexes of the lines are read (see GridReader), and by
+// their index within their line.
+class RegexEditor final
+{
+public:
+    // instance creation and deletion
+    RegexEditor(std::unique_ptr<Grid>     grid,
+                const RegexOptimizations& optimizations,
+                const SearchOptions&      options = SearchOptions());
+    ~RegexEditor();
+
+    // accessing
+    size_t num_lines() const;
+    size_t num_regexes(size_t line_index) const;
+    size_t num_solutions() const;
+    std::string regex(size_t line_index, size_t regex_index) const;
+    const std::vector<std::unique_ptr<Grid>>& solutions() const;
+
+    // querying
+    bool has_unique_solution() const;
+
+    // printing
+    std::vector<std::string> print_statistics() const;
+
+    // modifying
+    size_t replace_regex(size_t             line_index,
+                         size_t             regex_index,
+                         const std::string& regex_as_string);
+
+private:
+    // accessing
+    std::string alphabet_with(size_t             line_index,
+                              size_t             regex_index,
+                              const std::string& explicit_characters) const;
+
+    // modifying
+    void constrain_root();
+    void rebuild(const std::string&                            alphabet,
+                 const std::vector<std::vector<std::string>>& regex_groups);
+    void solve();
+
+    // data members
+
+    // How the regexes are optimized, and how the grid is searched.
+    RegexOptimizations m_optimizations;
+    SearchOptions m_search_options;
+
+    // The grid with its regexes parsed and optimized, but before any
+    // constraining, from which constraining starts over.
+    std::unique_ptr<Grid> m_unconstrained_grid;
+
+    // The grid constrained before any search, and whether it may have
+    // solutions.
+    std::unique_ptr<Grid> m_root;
+    bool m_root_is_consistent;
+
+    // The explicit characters (see Alphabet) of each regex of each line,
+    // which make up the alphabet. They are kept because the regexes
+    // which are ignored (see GridLineRegex::ignore_if_universal()) no
+    // longer tell them.
+    std::vector<std::vector<std::string>> m_explicit_characters;
+
+    // The solutions of the grid, up to two.
+    std::vector<std::unique_ptr<Grid>> m_solutions;
+
+    // The number of edits, of those which started constraining from the
+    // root, and of those which changed the alphabet.
+    size_t m_num_edits;
+    size_t m_num_edits_from_root;
+    size_t m_num_edits_of_alphabet;
+
+    // The total and maximum times from an edit to its answer, in
+    // milliseconds.
+    double m_total_edit_time_ms;
+    double m_max_edit_time_ms;
+};
+
+
+#endif // REGEX_EDITOR_HPP
@@ -0,0 +1,853 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "regex_kernel.hpp"
+
+#include "character_block.hpp"
+#include "constraint.hpp"
+#include "regex.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+using namespace std;
+
+
+// RegexKernelPiece
+// ----------------
+
+// instance creation and deletion
+
+RegexKernelPiece::RegexKernelPiece(vector<RegexKernelString> alternatives_,
+                                   RepetitionCount           min_count_,
+                                   RepetitionCount           max_count_) :
+  alternatives(move(alternatives_)),
+  min_count(min_count_),
+  max_count(max_count_)
+{
+}
+
+
+// RegexKernel
+// -----------
+
+// instance creation and deletion
+
+RegexKernel::RegexKernel(vector<RegexKernelPiece> pieces) :
+  m_pieces(move(pieces)),
+  m_alternatives_are_initialized(false)
+{
+}
+
+RegexKernel::~RegexKernel() = default;
+
+// Return the kernel which constrains lines on behalf of 'regex', or
+// nullptr if 'regex' has none of the shapes supported by the kernels.
+unique_ptr<RegexKernel>
+RegexKernel::create(const Regex& regex)
+{
+    vector<RegexKernelPiece> pieces;
+
+    if (!regex.get_kernel_pieces(pieces))
+    {
+        return nullptr;
+    }
+
+    pieces = normalized(move(pieces));
+
+    if (pieces.empty())
+    {
+        return nullptr;
+    }
+
+    if (ClassStarKernel::has_shape(pieces))
+    {
+        return Utils::make_unique<ClassStarKernel>(move(pieces));
+    }
+
+    if (AlternationStarKernel::has_shape(pieces))
+    {
+        return Utils::make_unique<AlternationStarKernel>(move(pieces));
+    }
+
+    if (LiteralSandwichKernel::has_shape(pieces))
+    {
+        return Utils::make_unique<LiteralSandwichKernel>(move(pieces));
+    }
+
+    if (CharacterBlockSequenceKernel::has_shape(pieces))
+    {
+        return Utils::make_unique<CharacterBlockSequenceKernel>(move(pieces));
+    }
+
+    return nullptr;
+}
+
+// Return 'pieces' without the alternatives which match the empty
+// string, since '(A|)' matches the same strings as 'A?', and without
+// the pieces which match only the empty string.
+vector<RegexKernelPiece>
+RegexKernel::normalized(vector<RegexKernelPiece> pieces)
+{
+    vector<RegexKernelPiece> result;
+
+    for (auto& piece : pieces)
+    {
+        auto& alternatives = piece.alternatives;
+        const auto it = remove_if(alternatives.begin(),
+                                  alternatives.end(),
+                                  [](const RegexKernelString& alternative)
+                                  {
+                                      return alternative.empty();
+                                  });
+
+        if (it != alternatives.end())
+        {
+            alternatives.erase(it, alternatives.end());
+            piece.min_count = 0;
+        }
+
+        if (!alternatives.empty() && piece.max_count != 0)
+        {
+            result.push_back(move(piece));
+        }
+    }
+
+    return result;
+}
+
+// copying
+
+unique_ptr<RegexKernel>
+RegexKernel::clone() const
+{
+    return do_clone();
+}
+
+// accessing
+
+// Return the characters of the alternatives of the 'piece_index'th
+// piece.
+//
+// Precondition:
+// * the alphabet is set
+const vector<RegexKernel::Word>&
+RegexKernel::alternatives(size_t piece_index) const
+{
+    if (!m_alternatives_are_initialized)
+    {
+        initialize_alternatives();
+        m_alternatives_are_initialized = true;
+    }
+
+    return m_alternatives[piece_index];
+}
+
+// Return the union of the characters of 'alternatives', each of which
+// is one character wide.
+SetOfCharacters
+RegexKernel::class_of(const vector<Word>& alternatives)
+{
+    SetOfCharacters result;
+
+    for (const auto& alternative : alternatives)
+    {
+        assert(alternative.size() == 1);
+        result |= alternative[0];
+    }
+
+    return result;
+}
+
+// Return the constraint that results from all the strings matched by
+// this kernel's regex applied to 'constraint'. See Regex::constrain().
+Constraint
+RegexKernel::constrain(const Constraint& constraint) const
+{
+    const auto new_constraint = do_constrain(constraint);
+    assert(new_constraint.is_tighter_than_or_equal_to(constraint));
+    return new_constraint;
+}
+
+void
+RegexKernel::initialize_alternatives() const
+{
+    m_alternatives.clear();
+
+    for (const auto& piece : m_pieces)
+    {
+        vector<Word> alternatives;
+
+        for (const auto& alternative : piece.alternatives)
+        {
+            Word word;
+
+            for (const auto& character_block : alternative)
+            {
+                word.push_back(character_block->characters());
+            }
+
+            alternatives.push_back(word);
+        }
+
+        m_alternatives.push_back(alternatives);
+    }
+}
+
+// Return the maximum number of repetitions of 'piece', capped to
+// 'bound'.
+size_t
+RegexKernel::max_count(const RegexKernelPiece& piece, size_t bound)
+{
+    if (piece.max_count.is_not_infinite())
+    {
+        return min(piece.max_count.count(), bound);
+    }
+
+    return bound;
+}
+
+size_t
+RegexKernel::min_count(const RegexKernelPiece& piece)
+{
+    return piece.min_count.count();
+}
+
+// Return the name under which this kernel is reported.
+string
+RegexKernel::name() const
+{
+    return do_name();
+}
+
+// Return the names of all the kernels, in the order in which a regex
+// is matched against their shapes.
+vector<string>
+RegexKernel::names()
+{
+    return { "class_star",
+             "alternation_star",
+             "literal_sandwich",
+             "block_sequence" };
+}
+
+size_t
+RegexKernel::num_pieces() const
+{
+    return m_pieces.size();
+}
+
+const RegexKernelPiece&
+RegexKernel::piece(size_t piece_index) const
+{
+    return m_pieces[piece_index];
+}
+
+// querying
+
+// Return whether 'word' can be placed at position 'pos' of
+// 'constraint'.
+bool
+RegexKernel::fits(const Word& word, const Constraint& constraint, size_t pos)
+{
+    if (pos + word.size() > constraint.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i != word.size(); ++i)
+    {
+        if ((word[i] & constraint[pos + i]).empty())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Return whether all the alternatives of 'piece' are one character
+// wide.
+bool
+RegexKernel::is_class(const RegexKernelPiece& piece)
+{
+    return all_of(piece.alternatives.cbegin(),
+                  piece.alternatives.cend(),
+                  [](const RegexKernelString& alternative)
+                  {
+                      return alternative.size() == 1;
+                  });
+}
+
+bool
+RegexKernel::is_class_star(const RegexKernelPiece& piece)
+{
+    return is_star(piece) && is_class(piece);
+}
+
+// Return whether 'piece' matches a single string of characters blocks,
+// exactly once.
+bool
+RegexKernel::is_literal(const RegexKernelPiece& piece)
+{
+    return piece.alternatives.size() == 1 &&
+           piece.min_count == 1           &&
+           piece.max_count == 1;
+}
+
+bool
+RegexKernel::is_star(const RegexKernelPiece& piece)
+{
+    return piece.min_count == 0 && !piece.max_count.is_not_infinite();
+}
+
+// modifying
+
+// Add to 'new_constraint' the characters of 'word' placed at position
+// 'pos' of 'constraint'.
+void
+RegexKernel::add_word(Constraint&       new_constraint,
+                      const Word&       word,
+                      const Constraint& constraint,
+                      size_t            pos)
+{
+    for (size_t i = 0; i != word.size(); ++i)
+    {
+        new_constraint[pos + i] |= word[i] & constraint[pos + i];
+    }
+}
+
+
+// ClassStarKernel
+// ---------------
+
+// instance creation and deletion
+
+ClassStarKernel::ClassStarKernel(vector<RegexKernelPiece> pieces) :
+  RegexKernel(move(pieces))
+{
+}
+
+// copying
+
+unique_ptr<RegexKernel>
+ClassStarKernel::do_clone() const
+{
+    return Utils::make_unique<ClassStarKernel>(*this);
+}
+
+// accessing
+
+// Each cell may contain any character of the class, independently of
+// the other cells.
+Constraint
+ClassStarKernel::do_constrain(const Constraint& constraint) const
+{
+    const auto characters = class_of(alternatives(0));
+    auto new_constraint = constraint;
+
+    for (size_t i = 0; i != new_constraint.size(); ++i)
+    {
+        new_constraint[i] &= characters;
+
+        if (new_constraint[i].empty())
+        {
+            return Constraint::none(constraint.size());
+        }
+    }
+
+    return new_constraint;
+}
+
+string
+ClassStarKernel::do_name() const
+{
+    return "class_star";
+}
+
+// querying
+
+bool
+ClassStarKernel::has_shape(const vector<RegexKernelPiece>& pieces)
+{
+    return pieces.size() == 1 && is_class_star(pieces[0]);
+}
+
+
+// AlternationStarKernel
+// ---------------------
+
+// instance creation and deletion
+
+AlternationStarKernel::AlternationStarKernel(vector<RegexKernelPiece> pieces) :
+  RegexKernel(move(pieces))
+{
+}
+
+// copying
+
+unique_ptr<RegexKernel>
+AlternationStarKernel::do_clone() const
+{
+    return Utils::make_unique<AlternationStarKernel>(*this);
+}
+
+// accessing
+
+// An alternative placed at position 'pos' contributes to the new
+// constraint if the alternatives can tile [0, pos) and the rest of the
+// line after it.
+Constraint
+AlternationStarKernel::do_constrain(const Constraint& constraint) const
+{
+    const auto& words = alternatives(0);
+    const auto size = constraint.size();
+
+    // 'reachable[pos]' is true if [0, pos) can be tiled.
+    vector<bool> reachable(size + 1, false);
+    reachable[0] = true;
+
+    for (size_t pos = 0; pos != size; ++pos)
+    {
+        if (!reachable[pos])
+        {
+            continue;
+        }
+
+        for (const auto& word : words)
+        {
+            if (fits(word, constraint, pos))
+            {
+                reachable[pos + word.size()] = true;
+            }
+        }
+    }
+
+    if (!reachable[size])
+    {
+        return Constraint::none(size);
+    }
+
+    // 'completable[pos]' is true if [pos, size) can be tiled.
+    vector<bool> completable(size + 1, false);
+    completable[size] = true;
+
+    for (size_t pos = size; pos-- != 0;)
+    {
+        completable[pos] =
+            any_of(words.cbegin(),
+                   words.cend(),
+                   [&](const Word& word)
+                   {
+                       return fits(word, constraint, pos) &&
+                              completable[pos + word.size()];
+                   });
+    }
+
+    auto new_constraint = Constraint::none(size);
+
+    for (size_t pos = 0; pos != size; ++pos)
+    {
+        if (!reachable[pos])
+        {
+            continue;
+        }
+
+        for (const auto& word : words)
+        {
+            if (fits(word, constraint, pos) && completable[pos + word.size()])
+            {
+                add_word(new_constraint, word, constraint, pos);
+            }
+        }
+    }
+
+    return new_constraint;
+}
+
+string
+AlternationStarKernel::do_name() const
+{
+    return "alternation_star";
+}
+
+// querying
+
+bool
+AlternationStarKernel::has_shape(const vector<RegexKernelPiece>& pieces)
+{
+    return pieces.size() == 1 && is_star(pieces[0]);
+}
+
+
+// LiteralSandwichKernel
+// ---------------------
+
+// instance creation and deletion
+
+LiteralSandwichKernel::LiteralSandwichKernel(vector<RegexKernelPiece> pieces) :
+  RegexKernel(move(pieces))
+{
+}
+
+// copying
+
+unique_ptr<RegexKernel>
+LiteralSandwichKernel::do_clone() const
+{
+    return Utils::make_unique<LiteralSandwichKernel>(*this);
+}
+
+// accessing
+
+// The literal can be placed at position 'pos' if it fits there, and if
+// the cells before it (resp. after it) all admit a character of the
+// leading (resp. trailing) class. Without a leading (resp. trailing)
+// class, the literal must start (resp. end) the line.
+Constraint
+LiteralSandwichKernel::do_constrain(const Constraint& constraint) const
+{
+    const auto size = constraint.size();
+    const auto word = literal();
+    const auto has_prefix = is_class_star(piece(0));
+    const auto has_suffix = is_class_star(piece(num_pieces() - 1));
+    const auto prefix_class = has_prefix ? class_of(alternatives(0))
+                                         : SetOfCharacters();
+    const auto suffix_class = has_suffix
+                              ? class_of(alternatives(num_pieces() - 1))
+                              : SetOfCharacters();
+
+    if (word.size() > size)
+    {
+        return Constraint::none(size);
+    }
+
+    // 'prefix_fits[pos]' is true if [0, pos) can be matched by the
+    // leading class star.
+    vector<bool> prefix_fits(size + 1, false);
+    prefix_fits[0] = true;
+
+    for (size_t pos = 0; has_prefix && pos != size; ++pos)
+    {
+        prefix_fits[pos + 1] = prefix_fits[pos] &&
+                               (constraint[pos] & prefix_class).not_empty();
+    }
+
+    // 'suffix_fits[pos]' is true if [pos, size) can be matched by the
+    // trailing class star.
+    vector<bool> suffix_fits(size + 1, false);
+    suffix_fits[size] = true;
+
+    for (size_t pos = size; has_suffix && pos-- != 0;)
+    {
+        suffix_fits[pos] = suffix_fits[pos + 1] &&
+                           (constraint[pos] & suffix_class).not_empty();
+    }
+
+    auto new_constraint = Constraint::none(size);
+    size_t prefix_end = 0;
+    auto suffix_begin = size;
+    auto literal_fits = false;
+
+    for (size_t pos = 0; pos + word.size() <= size; ++pos)
+    {
+        if (prefix_fits[pos]              &&
+            suffix_fits[pos + word.size()] &&
+            fits(word, constraint, pos))
+        {
+            literal_fits = true;
+            add_word(new_constraint, word, constraint, pos);
+            prefix_end = max(prefix_end, pos);
+            suffix_begin = min(suffix_begin, pos + word.size());
+        }
+    }
+
+    if (!literal_fits)
+    {
+        return Constraint::none(size);
+    }
+
+    for (size_t pos = 0; pos != prefix_end; ++pos)
+    {
+        new_constraint[pos] |= constraint[pos] & prefix_class;
+    }
+
+    for (auto pos = suffix_begin; pos != size; ++pos)
+    {
+        new_constraint[pos] |= constraint[pos] & suffix_class;
+    }
+
+    return new_constraint;
+}
+
+string
+LiteralSandwichKernel::do_name() const
+{
+    return "literal_sandwich";
+}
+
+// Return the characters of the literal, i.e., of the concatenation of
+// the pieces between the class stars.
+RegexKernel::Word
+LiteralSandwichKernel::literal() const
+{
+    Word result;
+
+    for (size_t i = 0; i != num_pieces(); ++i)
+    {
+        if (is_literal(piece(i)))
+        {
+            const auto& word = alternatives(i)[0];
+            result.insert(result.end(), word.cbegin(), word.cend());
+        }
+    }
+
+    return result;
+}
+
+// querying
+
+bool
+LiteralSandwichKernel::has_shape(const vector<RegexKernelPiece>& pieces)
+{
+    size_t begin = 0;
+    auto end = pieces.size();
+
+    if (is_class_star(pieces.front()))
+    {
+        ++begin;
+    }
+
+    if (end > begin && is_class_star(pieces.back()))
+    {
+        --end;
+    }
+
+    return (begin != 0 || end != pieces.size()) &&
+           begin < end                          &&
+           all_of(pieces.cbegin() + static_cast<ptrdiff_t>(begin),
+                  pieces.cbegin() + static_cast<ptrdiff_t>(end),
+                  is_literal);
+}
+
+
+// CharacterBlockSequenceKernel
+// ----------------------------
+
+// instance creation and deletion
+
+CharacterBlockSequenceKernel::CharacterBlockSequenceKernel(
+                                vector<RegexKernelPiece> pieces) :
+  RegexKernel(move(pieces))
+{
+}
+
+// copying
+
+unique_ptr<RegexKernel>
+CharacterBlockSequenceKernel::do_clone() const
+{
+    return Utils::make_unique<CharacterBlockSequenceKernel>(*this);
+}
+
+// accessing
+
+// Each piece is a class repeated from 'min_length' to 'max_length'
+// times. Piece j may match [begin, end) if:
+// * the pieces before it match [0, begin) ('forward[j][begin]')
+// * the pieces after it match [end, size) ('backward[j + 1][end]')
+// * min_length <= end - begin <= max_length
+// * all the cells of [begin, end) admit a character of the class
+//
+// For each piece, all these are computed with prefix sums, in time
+// linear in the length of the line.
+Constraint
+CharacterBlockSequenceKernel::do_constrain(const Constraint& constraint) const
+{
+    const auto size = constraint.size();
+    const auto n = num_pieces();
+
+    vector<SetOfCharacters> classes;
+
+    for (size_t j = 0; j != n; ++j)
+    {
+        classes.push_back(class_of(alternatives(j)));
+    }
+
+    auto admits = [&](size_t j, size_t pos)
+                  {
+                      return (constraint[pos] & classes[j]).not_empty();
+                  };
+
+    // Return the prefix sums of 'positions': result[i] is the number
+    // of true elements of 'positions' before index 'i'.
+    auto prefix_sums = [](const vector<bool>& positions)
+                       {
+                           vector<size_t> result(positions.size() + 1, 0);
+
+                           for (size_t i = 0; i != positions.size(); ++i)
+                           {
+                               result[i + 1] = result[i] +
+                                               (positions[i] ? 1 : 0);
+                           }
+
+                           return result;
+                       };
+
+    vector<vector<bool>> forward(n + 1, vector<bool>(size + 1, false));
+    forward[0][0] = true;
+
+    for (size_t j = 0; j != n; ++j)
+    {
+        const auto min_length = min_count(piece(j));
+        const auto max_length = max_count(piece(j), size);
+        const auto sums = prefix_sums(forward[j]);
+
+        // All the cells of [run_begin, end) admit the class of piece j.
+        size_t run_begin = 0;
+
+        for (size_t end = 0; end <= size; ++end)
+        {
+            if (end > 0 && !admits(j, end - 1))
+            {
+                run_begin = end;
+            }
+
+            if (end < min_length)
+            {
+                continue;
+            }
+
+            const auto first = std::max(run_begin,
+                                        end >= max_length ? end - max_length
+                                                          : 0);
+            const auto last = end - min_length;
+            forward[j + 1][end] = first <= last &&
+                                  sums[last + 1] > sums[first];
+        }
+    }
+
+    if (!forward[n][size])
+    {
+        return Constraint::none(size);
+    }
+
+    vector<vector<bool>> backward(n + 1, vector<bool>(size + 1, false));
+    backward[n][size] = true;
+    auto new_constraint = Constraint::none(size);
+
+    for (size_t j = n; j-- != 0;)
+    {
+        const auto min_length = min_count(piece(j));
+        const auto max_length = max_count(piece(j), size);
+        const auto sums = prefix_sums(backward[j + 1]);
+
+        // 'last_true[pos]' is the greatest end <= pos such that
+        // 'backward[j + 1][end]' is true, or 'size + 1' if none.
+        vector<size_t> last_true(size + 1, size + 1);
+
+        for (size_t pos = 0; pos <= size; ++pos)
+        {
+            if (backward[j + 1][pos])
+            {
+                last_true[pos] = pos;
+            }
+            else if (pos > 0)
+            {
+                last_true[pos] = last_true[pos - 1];
+            }
+        }
+
+        // 'covered[pos]' is the number of matches of piece j which
+        // begin at or before 'pos', minus those which end at or before
+        // 'pos'.
+        vector<long> covered(size + 1, 0);
+
+        // All the cells of [begin, run_end) admit the class of piece j.
+        auto run_end = size;
+
+        for (size_t begin = size + 1; begin-- != 0;)
+        {
+            if (begin < size && !admits(j, begin))
+            {
+                run_end = begin;
+            }
+
+            if (begin + min_length > size)
+            {
+                continue;
+            }
+
+            const auto first = begin + min_length;
+            const auto last = std::min(run_end, begin + max_length);
+
+            if (first > last || sums[last + 1] == sums[first])
+            {
+                continue;
+            }
+
+            backward[j][begin] = true;
+
+            if (forward[j][begin])
+            {
+                ++covered[begin];
+                --covered[last_true[last]];
+            }
+        }
+
+        long num_matches = 0;
+
+        for (size_t pos = 0; pos != size; ++pos)
+        {
+            num_matches += covered[pos];
+
+            if (num_matches > 0)
+            {
+                new_constraint[pos] |= constraint[pos] & classes[j];
+            }
+        }
+    }
+
+    return new_constraint;
+}
+
+string
+CharacterBlockSequenceKernel::do_name() const
+{
+    return "block_sequence";
+}
+
+// querying
+
+bool
+CharacterBlockSequenceKernel::has_shape(
+                                const vector<RegexKernelPiece>& pieces)
+{
+    return all_of(pieces.cbegin(), pieces.cend(), is_class);
+}
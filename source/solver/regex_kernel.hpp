@@ -0,0 +1,244 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef REGEX_KERNEL_HPP
+#define REGEX_KERNEL_HPP
+
+#include "repetition_count.hpp"
+#include "set_of_characters.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class CharacterBlock;
+class Constraint;
+class Regex;
+
+
+// A string of character blocks, e.g., 'D[IS]'.
+typedef std::vector<std::shared_ptr<const CharacterBlock>> RegexKernelString;
+
+// A part of a regex which matches one of 'alternatives', repeated from
+// 'min_count' to 'max_count' times. For example, '(DI|NS)*' is the
+// piece { { "DI", "NS" }, 0, infinite }.
+struct RegexKernelPiece
+{
+    RegexKernelPiece(std::vector<RegexKernelString> alternatives_,
+                     RepetitionCount                min_count_,
+                     RepetitionCount                max_count_);
+
+    std::vector<RegexKernelString> alternatives;
+    RepetitionCount                min_count;
+    RepetitionCount                max_count;
+};
+
+
+// class hierarchy
+// ---------------
+// RegexKernel
+//     AlternationStarKernel
+//     CharacterBlockSequenceKernel
+//     ClassStarKernel
+//     LiteralSandwichKernel
+
+
+// An instance of a class derived from this abstract class constrains a
+// line exactly like Regex::constrain() does, but in time linear in the
+// length of the line, for a regex which has one of the following
+// shapes:
+// * ClassStarKernel: the star of a class, e.g., '[CR]*'
+// * AlternationStarKernel: the star of fixed-width alternatives, e.g.,
+//   '(DI|NS|TH|OM)*' or '(RR|HHH)*'
+// * LiteralSandwichKernel: a literal, preceded and/or followed by the
+//   star of a class, e.g., '.*XEXM*' or '[^C]*MMM[^C]*'
+// * CharacterBlockSequenceKernel: a sequence of repeated character
+//   blocks, e.g., 'A+[BC]?D{2,3}'
+//
+// Regex::constrain() enumerates all the values of a regex, which takes
+// a time exponential in the length of the line for most regexes.
+class RegexKernel
+{
+public:
+    // instance creation and deletion
+    virtual ~RegexKernel() = 0;
+    static std::unique_ptr<RegexKernel> create(const Regex& regex);
+
+    // copying
+    std::unique_ptr<RegexKernel> clone() const;
+
+    // accessing
+    Constraint constrain(const Constraint& constraint) const;
+    std::string name() const;
+    static std::vector<std::string> names();
+
+protected:
+    // The characters of a RegexKernelString.
+    typedef std::vector<SetOfCharacters> Word;
+
+    // instance creation and deletion
+    explicit RegexKernel(std::vector<RegexKernelPiece> pieces);
+    RegexKernel(const RegexKernel& rhs) = default;
+
+    // accessing
+    const std::vector<Word>& alternatives(size_t piece_index) const;
+    static SetOfCharacters class_of(const std::vector<Word>& alternatives);
+    static size_t max_count(const RegexKernelPiece& piece, size_t bound);
+    static size_t min_count(const RegexKernelPiece& piece);
+    const RegexKernelPiece& piece(size_t piece_index) const;
+    size_t num_pieces() const;
+
+    // querying
+    static bool fits(const Word&       word,
+                     const Constraint& constraint,
+                     size_t            pos);
+    static bool is_class(const RegexKernelPiece& piece);
+    static bool is_class_star(const RegexKernelPiece& piece);
+    static bool is_literal(const RegexKernelPiece& piece);
+    static bool is_star(const RegexKernelPiece& piece);
+
+    // modifying
+    static void add_word(Constraint&       new_constraint,
+                         const Word&       word,
+                         const Constraint& constraint,
+                         size_t            pos);
+
+private:
+    // instance creation and deletion
+    static std::vector<RegexKernelPiece> normalized(
+                                   std::vector<RegexKernelPiece> pieces);
+
+    // copying
+    virtual std::unique_ptr<RegexKernel> do_clone() const = 0;
+
+    // accessing
+    virtual Constraint do_constrain(const Constraint& constraint) const = 0;
+    virtual std::string do_name() const = 0;
+    void initialize_alternatives() const;
+
+    // data members
+
+    // The pieces which, concatenated, make up the regex.
+    std::vector<RegexKernelPiece> m_pieces;
+
+    // If 'm_alternatives_are_initialized' is true, 'm_alternatives[i]'
+    // contains the characters of the alternatives of 'm_pieces[i]'.
+    // 'm_alternatives' is undefined otherwise. The characters are
+    // computed lazily, because they depend on the alphabet, which is
+    // not yet known when a kernel is created.
+    mutable std::vector<std::vector<Word>> m_alternatives;
+    mutable bool                           m_alternatives_are_initialized;
+};
+
+
+// An instance of this class represents the star of a class, e.g.,
+// '[CR]*' or '(C|R)*'.
+class ClassStarKernel final : public RegexKernel
+{
+public:
+    // instance creation and deletion
+    explicit ClassStarKernel(std::vector<RegexKernelPiece> pieces);
+
+    // querying
+    static bool has_shape(const std::vector<RegexKernelPiece>& pieces);
+
+private:
+    // copying
+    std::unique_ptr<RegexKernel> do_clone() const override;
+
+    // accessing
+    Constraint do_constrain(const Constraint& constraint) const override;
+    std::string do_name() const override;
+};
+
+
+// An instance of this class represents the star of fixed-width
+// alternatives, e.g., '(DI|NS|TH|OM)*' or '(RR|HHH)*'.
+class AlternationStarKernel final : public RegexKernel
+{
+public:
+    // instance creation and deletion
+    explicit AlternationStarKernel(std::vector<RegexKernelPiece> pieces);
+
+    // querying
+    static bool has_shape(const std::vector<RegexKernelPiece>& pieces);
+
+private:
+    // copying
+    std::unique_ptr<RegexKernel> do_clone() const override;
+
+    // accessing
+    Constraint do_constrain(const Constraint& constraint) const override;
+    std::string do_name() const override;
+};
+
+
+// An instance of this class represents a literal which is preceded
+// and/or followed by the star of a class, e.g., '.*XEXM*' or
+// '[^C]*MMM[^C]*'.
+class LiteralSandwichKernel final : public RegexKernel
+{
+public:
+    // instance creation and deletion
+    explicit LiteralSandwichKernel(std::vector<RegexKernelPiece> pieces);
+
+    // querying
+    static bool has_shape(const std::vector<RegexKernelPiece>& pieces);
+
+private:
+    // copying
+    std::unique_ptr<RegexKernel> do_clone() const override;
+
+    // accessing
+    Constraint do_constrain(const Constraint& constraint) const override;
+    std::string do_name() const override;
+    Word literal() const;
+};
+
+
+// An instance of this class represents a sequence of repeated
+// character blocks, e.g., 'A+[BC]?D{2,3}'.
+class CharacterBlockSequenceKernel final : public RegexKernel
+{
+public:
+    // instance creation and deletion
+    explicit CharacterBlockSequenceKernel(
+               std::vector<RegexKernelPiece> pieces);
+
+    // querying
+    static bool has_shape(const std::vector<RegexKernelPiece>& pieces);
+
+private:
+    // copying
+    std::unique_ptr<RegexKernel> do_clone() const override;
+
+    // accessing
+    Constraint do_constrain(const Constraint& constraint) const override;
+    std::string do_name() const override;
+};
+
+
+#endif // REGEX_KERNEL_HPP
@@ -0,0 +1,160 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "regex_optimization_statistics.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+
+namespace
+{
+
+// Return 'columns' as a line of a table, each column being
+// right-aligned within 'column_width' characters, except the first
+// one, which is left-aligned.
+template<typename T>
+string
+table_line(const string& first_column, const vector<T>& columns)
+{
+    const int first_column_width = 16;
+    const int column_width = 14;
+
+    ostringstream oss;
+    oss << left << setw(first_column_width) << first_column << right;
+
+    for (const auto& column : columns)
+    {
+        oss << setw(column_width) << column;
+    }
+
+    return oss.str();
+}
+
+} // unnamed namespace
+
+
+// RegexOptimizationStatistics::PassStatistics
+// -------------------------------------------
+
+// instance creation and deletion
+
+RegexOptimizationStatistics::PassStatistics::PassStatistics(
+                               RegexOptimizations::Type type_) :
+  type(type_),
+  num_regexes(0),
+  num_changed_regexes(0),
+  num_nodes_before(0),
+  num_nodes_after(0),
+  num_steps_before(0),
+  num_steps_after(0)
+{
+}
+
+
+// RegexOptimizationStatistics
+// ---------------------------
+
+// accessing
+
+RegexOptimizationStatistics::PassStatistics&
+RegexOptimizationStatistics::pass_statistics(RegexOptimizations::Type type)
+{
+    const auto it = find_if(m_pass_statistics.begin(),
+                            m_pass_statistics.end(),
+                            [type](const PassStatistics& pass_statistics_)
+                            {
+                                return pass_statistics_.type == type;
+                            });
+
+    if (it != m_pass_statistics.end())
+    {
+        return *it;
+    }
+
+    m_pass_statistics.push_back(PassStatistics(type));
+    return m_pass_statistics.back();
+}
+
+// printing
+
+// Return the statistics as a table, with a header line followed by one
+// line per pass, in the order in which the passes were applied.
+vector<string>
+RegexOptimizationStatistics::print() const
+{
+    vector<string> result;
+
+    result.push_back(table_line("pass",
+                                vector<string>{ "regexes",
+                                                "changed",
+                                                "nodes before",
+                                                "nodes after",
+                                                "steps before",
+                                                "steps after" }));
+
+    for (const auto& pass : m_pass_statistics)
+    {
+        result.push_back(table_line(RegexOptimizations::name(pass.type),
+                                    vector<size_t>{ pass.num_regexes,
+                                                    pass.num_changed_regexes,
+                                                    pass.num_nodes_before,
+                                                    pass.num_nodes_after,
+                                                    pass.num_steps_before,
+                                                    pass.num_steps_after }));
+    }
+
+    return result;
+}
+
+// modifying
+
+// Record that pass 'type' was applied to a regex.
+void
+RegexOptimizationStatistics::add(RegexOptimizations::Type type,
+                                 size_t                   num_nodes_before,
+                                 size_t                   num_nodes_after,
+                                 size_t                   num_steps_before,
+                                 size_t                   num_steps_after)
+{
+    auto& pass = pass_statistics(type);
+
+    ++pass.num_regexes;
+
+    if (num_nodes_before != num_nodes_after ||
+        num_steps_before != num_steps_after)
+    {
+        ++pass.num_changed_regexes;
+    }
+
+    pass.num_nodes_before += num_nodes_before;
+    pass.num_nodes_after  += num_nodes_after;
+    pass.num_steps_before += num_steps_before;
+    pass.num_steps_after  += num_steps_after;
+}
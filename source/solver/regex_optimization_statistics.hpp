@@ -0,0 +1,79 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef REGEX_OPTIMIZATION_STATISTICS_HPP
+#define REGEX_OPTIMIZATION_STATISTICS_HPP
+
+#include "regex_optimizations.hpp"
+
+#include <string>
+#include <vector>
+
+
+// An instance of this class accumulates, for each optimization pass,
+// the effect of that pass on the regexes it was applied to: number of
+// nodes of their parse trees and number of enumeration steps (see
+// Regex::num_enumeration_steps()), before and after the pass.
+class RegexOptimizationStatistics final
+{
+public:
+    // printing
+    std::vector<std::string> print() const;
+
+    // modifying
+    void add(RegexOptimizations::Type type,
+             size_t                   num_nodes_before,
+             size_t                   num_nodes_after,
+             size_t                   num_steps_before,
+             size_t                   num_steps_after);
+
+private:
+    // The statistics of a single pass.
+    struct PassStatistics
+    {
+        explicit PassStatistics(RegexOptimizations::Type type_);
+
+        RegexOptimizations::Type type;
+        size_t                   num_regexes;
+        size_t                   num_changed_regexes;
+        size_t                   num_nodes_before;
+        size_t                   num_nodes_after;
+        size_t                   num_steps_before;
+        size_t                   num_steps_after;
+    };
+
+    // accessing
+    PassStatistics& pass_statistics(RegexOptimizations::Type type);
+
+    // data members
+
+    // The statistics of each pass, in the order in which the passes
+    // were first applied.
+    std::vector<PassStatistics> m_pass_statistics;
+};
+
+
+#endif // REGEX_OPTIMIZATION_STATISTICS_HPP
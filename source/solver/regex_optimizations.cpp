@@ -26,7 +26,66 @@
 
 #include "regex_optimizations.hpp"
 
+#include "utils.hpp"
+
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+
+using namespace std;
+
+
+namespace
+{
+
+// data
+
+// The name and description of each optimization pass, in the default
+// order of application.
+//
+// The order is important in order to get the best results. For
+// example:
+// * groups are removed first, so that the other passes can see through
+//   groups which are not backreferenced
+// * factorizations are done before unions, so that 'AB|AC' is first
+//   factorized into 'A(?:B|C)', which is then unified into 'A(?:[BC])'
+// * concatenations are done last, because StringRegex'es cannot be
+//   factorized nor unified
+const struct
+{
+    RegexOptimizations::Type type;
+    const char*              name;
+    const char*              description;
+} g_passes[] =
+{
+    {
+        RegexOptimizations::Type::GROUPS,
+        "groups",
+        "remove the groups which are not backreferenced"
+    },
+    {
+        RegexOptimizations::Type::REPETITIONS,
+        "repetitions",
+        "merge adjacent repetitions of the same character block"
+    },
+    {
+        RegexOptimizations::Type::FACTORIZATIONS,
+        "factorizations",
+        "factor the common prefixes and suffixes out of unions"
+    },
+    {
+        RegexOptimizations::Type::UNIONS,
+        "unions",
+        "collapse unions of character blocks into character blocks"
+    },
+    {
+        RegexOptimizations::Type::CONCATENATIONS,
+        "concatenations",
+        "merge concatenated character blocks into strings"
+    }
+};
+
+} // unnamed namespace
 
 
 // instance creation and deletion
@@ -34,42 +93,148 @@
 RegexOptimizations
 RegexOptimizations::all()
 {
-    return RegexOptimizations(true, true, true);
+    return RegexOptimizations(true);
 }
 
 RegexOptimizations
 RegexOptimizations::none()
 {
-    return RegexOptimizations(false, false, false);
+    return RegexOptimizations(false);
+}
+
+// Return the optimizations which consist of the single pass 'type'.
+RegexOptimizations
+RegexOptimizations::only(Type type)
+{
+    auto optimizations = none();
+    optimizations.set(type, true);
+    return optimizations;
+}
+
+RegexOptimizations::RegexOptimizations(bool on_or_off) :
+  m_order(default_order()),
+  m_is_enabled(m_order.size(), on_or_off)
+{
+}
+
+// accessing
+
+// Return all the passes, in the order in which they are applied by
+// default.
+vector<RegexOptimizations::Type>
+RegexOptimizations::default_order()
+{
+    vector<Type> result;
+
+    for (const auto& pass : g_passes)
+    {
+        result.push_back(pass.type);
+    }
+
+    return result;
+}
+
+string
+RegexOptimizations::description(Type type)
+{
+    return g_passes[index(type)].description;
+}
+
+// Return the enabled passes, in the order in which they are to be
+// applied.
+vector<RegexOptimizations::Type>
+RegexOptimizations::enabled_passes() const
+{
+    vector<Type> result;
+
+    copy_if(m_order.cbegin(),
+            m_order.cend(),
+            back_inserter(result),
+            [this](Type type)
+            {
+                return is_enabled(type);
+            });
+
+    return result;
+}
+
+// Return the index of 'type' in 'g_passes'.
+size_t
+RegexOptimizations::index(Type type)
+{
+    const auto num_passes = static_cast<size_t>(Utils::array_size(g_passes));
+
+    for (size_t i = 0; i != num_passes; ++i)
+    {
+        if (g_passes[i].type == type)
+        {
+            return i;
+        }
+    }
+
+    assert(false);
+    return 0;
 }
 
-RegexOptimizations::RegexOptimizations(bool optimize_concatenations,
-                                       bool optimize_groups,
-                                       bool optimize_unions) :
-  m_optimize_concatenations(optimize_concatenations),
-  m_optimize_groups(optimize_groups),
-  m_optimize_unions(optimize_unions)
+string
+RegexOptimizations::name(Type type)
 {
+    return g_passes[index(type)].name;
+}
+
+// If 'name' is the name of a pass, return true and set '*type' to that
+// pass. Return false otherwise.
+bool
+RegexOptimizations::type_from_name(const string& name, Type* type)
+{
+    for (const auto& pass : g_passes)
+    {
+        if (name == pass.name)
+        {
+            *type = pass.type;
+            return true;
+        }
+    }
+
+    return false;
 }
 
 // querying
 
+bool
+RegexOptimizations::is_enabled(Type type) const
+{
+    return m_is_enabled[index(type)];
+}
+
 bool
 RegexOptimizations::optimize_concatenations() const
 {
-    return m_optimize_concatenations;
+    return is_enabled(Type::CONCATENATIONS);
+}
+
+bool
+RegexOptimizations::optimize_factorizations() const
+{
+    return is_enabled(Type::FACTORIZATIONS);
 }
 
 bool
 RegexOptimizations::optimize_groups() const
 {
-    return m_optimize_groups;
+    return is_enabled(Type::GROUPS);
+}
+
+bool
+RegexOptimizations::optimize_repetitions() const
+{
+    return is_enabled(Type::REPETITIONS);
 }
 
 bool
 RegexOptimizations::optimize_unions() const
 {
-    return m_optimize_unions;
+    return is_enabled(Type::UNIONS);
 }
 
 // modifying
@@ -77,22 +242,33 @@ RegexOptimizations::optimize_unions() const
 void
 RegexOptimizations::set(Type type, bool on_or_off)
 {
-    switch (type)
-    {
-    case Type::CONCATENATIONS:
-        m_optimize_concatenations = on_or_off;
-        break;
+    m_is_enabled[index(type)] = on_or_off;
+}
 
-    case Type::GROUPS:
-        m_optimize_groups = on_or_off;
-        break;
+// Enable 'passes' - and only them -, to be applied in the order in
+// which they appear in 'passes'.
+//
+// Precondition:
+// * 'passes' contains no duplicates
+void
+RegexOptimizations::set_passes(const vector<Type>& passes)
+{
+    m_order = passes;
+    m_is_enabled.assign(m_is_enabled.size(), false);
 
-    case Type::UNIONS:
-        m_optimize_unions = on_or_off;
-        break;
+    for (const auto type : passes)
+    {
+        assert(!is_enabled(type));
+        set(type, true);
+    }
 
-    default:
-        assert(false);
-        break;
+    // The passes which are not in 'passes' are disabled, but they are
+    // kept in 'm_order', so that they can be enabled again with set().
+    for (const auto type : default_order())
+    {
+        if (find(m_order.cbegin(), m_order.cend(), type) == m_order.cend())
+        {
+            m_order.push_back(type);
+        }
     }
 }
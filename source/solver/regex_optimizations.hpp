@@ -27,42 +27,66 @@
 #ifndef REGEX_OPTIMIZATIONS_HPP
 #define REGEX_OPTIMIZATIONS_HPP
 
+#include <string>
+#include <vector>
+
 
 // An instance of this class represents a set of optimization methods to
 // be applied to a regular expression after it has been parsed.
+//
+// Each optimization method is a pass over the parse tree of the regex.
+// The passes are applied in a given order (see default_order()), which
+// can be modified with set_passes().
 class RegexOptimizations final
 {
 public:
     enum class Type
     {
         CONCATENATIONS,
+        FACTORIZATIONS,
         GROUPS,
+        REPETITIONS,
         UNIONS
     };
 
     // instance creation and deletion
     static RegexOptimizations all();
     static RegexOptimizations none();
+    static RegexOptimizations only(Type type);
+
+    // accessing
+    static std::vector<Type> default_order();
+    static std::string description(Type type);
+    std::vector<Type> enabled_passes() const;
+    static std::string name(Type type);
+    static bool type_from_name(const std::string& name, Type* type);
 
     // querying
+    bool is_enabled(Type type) const;
     bool optimize_concatenations() const;
+    bool optimize_factorizations() const;
     bool optimize_groups() const;
+    bool optimize_repetitions() const;
     bool optimize_unions() const;
 
     // modifying
     void set(Type type, bool on_or_off);
+    void set_passes(const std::vector<Type>& passes);
 
 private:
     // instance creation and deletion
-    RegexOptimizations(bool optimize_concatenations,
-                       bool optimize_groups,
-                       bool optimize_unions);
+    explicit RegexOptimizations(bool on_or_off);
+
+    // accessing
+    static size_t index(Type type);
 
     // data members
 
-    bool m_optimize_concatenations;
-    bool m_optimize_groups;
-    bool m_optimize_unions;
+    // The passes, in the order in which they are applied (if enabled).
+    std::vector<Type> m_order;
+
+    // Whether each pass is enabled, indexed by index().
+    std::vector<bool> m_is_enabled;
 };
 
 
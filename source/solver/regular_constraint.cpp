@@ -0,0 +1,582 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "regular_constraint.hpp"
+
+#include "alphabet.hpp"
+#include "automaton.hpp"
+#include "regex.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <utility>
+
+using namespace std;
+
+
+namespace
+{
+
+// Beyond this number of edges, a layered graph is deemed too large.
+const size_t max_num_edges = 100000;
+
+// The labels and targets of the transitions on characters from the
+// states of 'states', one pair (character index, target state) per
+// character, without duplicates.
+vector<pair<size_t, size_t>>
+character_transitions(const Automaton&      automaton,
+                      const vector<size_t>& states)
+{
+    vector<pair<size_t, size_t>> result;
+
+    for (const auto state : states)
+    {
+        for (const auto& transition : automaton.transitions(state))
+        {
+            for (const auto c : transition.characters)
+            {
+                result.emplace_back(Alphabet::index_of_character(c),
+                                    transition.to);
+            }
+        }
+    }
+
+    sort(begin(result), end(result));
+    result.erase(unique(begin(result), end(result)), end(result));
+    return result;
+}
+
+} // unnamed namespace
+
+
+// instance creation and deletion
+
+RegularConstraint::RegularConstraint(shared_ptr<const Graph> graph,
+                                     size_t                  length) :
+  m_length(length),
+  m_alphabet_size(Alphabet::characters_as_string().size()),
+  m_graph(move(graph))
+{
+    reset();
+}
+
+// Return a regular constraint which constrains lines of 'length' cells
+// on behalf of 'regex', or nullptr if 'regex' cannot be represented as
+// an automaton, or if the layered graph would be too large.
+//
+// Precondition:
+// * the alphabet is set
+unique_ptr<RegularConstraint>
+RegularConstraint::create(const Regex& regex, size_t length)
+{
+    return create(vector<const Regex*>{ &regex }, length);
+}
+
+// Return a regular constraint which constrains lines of 'length' cells
+// on behalf of all the regexes of 'regexes' at once, i.e., whose paths
+// spell the strings which all these regexes match. Return nullptr if
+// one of them cannot be represented as an automaton, or if a layered
+// graph would be too large.
+//
+// The layered graph is the product of the layered graphs of the
+// regexes: its nodes are tuples of nodes of the same layer, one per
+// regex, and its edges are tuples of edges with the same label. Unlike
+// constraining a line with each regex in turn, this removes every
+// character which is not in a string that all the regexes match.
+//
+// Precondition:
+// * the alphabet is set
+unique_ptr<RegularConstraint>
+RegularConstraint::create(const vector<const Regex*>& regexes,
+                          size_t                      length)
+{
+    assert(!regexes.empty());
+
+    auto graph = create_graph(*regexes.front(), length);
+
+    for (auto it = next(regexes.cbegin());
+         it != regexes.cend() && graph != nullptr;
+         ++it)
+    {
+        const auto rhs_graph = create_graph(**it, length);
+
+        graph = rhs_graph == nullptr
+                ? nullptr
+                : create_product_graph(*graph, *rhs_graph, length);
+    }
+
+    if (graph == nullptr)
+    {
+        return nullptr;
+    }
+
+    return unique_ptr<RegularConstraint>(
+             new RegularConstraint(move(graph), length));
+}
+
+// Return the layered graph of 'regex' for lines of 'length' cells, or
+// nullptr if 'regex' cannot be represented as an automaton, or if the
+// layered graph would be too large.
+shared_ptr<const RegularConstraint::Graph>
+RegularConstraint::create_graph(const Regex& regex, size_t length)
+{
+    Automaton automaton;
+
+    if (length == 0 || !regex.get_automaton(automaton, length))
+    {
+        return nullptr;
+    }
+
+    const auto no_node = numeric_limits<size_t>::max();
+
+    // The transitions on characters from each state, past the first
+    // position (where epsilon transitions to '^' may be taken) and
+    // before the end of the string. They are computed when they are
+    // first needed.
+    vector<vector<pair<size_t, size_t>>> inner_transitions(
+                                           automaton.num_states());
+    vector<bool> inner_transitions_are_computed(automaton.num_states(),
+                                                false);
+
+    // Unroll the automaton, layer by layer. The nodes of each layer are
+    // numbered after those of the previous layer, and so are the edges
+    // from each layer.
+    vector<size_t> node_states = { Automaton::initial_state() };
+    vector<Edge> edges;
+    size_t layer_begin = 0;
+
+    for (size_t pos = 0; pos != length; ++pos)
+    {
+        const auto layer_end = node_states.size();
+        vector<size_t> next_node_of_state(automaton.num_states(), no_node);
+
+        for (auto node = layer_begin; node != layer_end; ++node)
+        {
+            const auto state = node_states[node];
+
+            if (pos != 0 && !inner_transitions_are_computed[state])
+            {
+                inner_transitions[state] = character_transitions(
+                    automaton, automaton.epsilon_closure(state, false, false));
+                inner_transitions_are_computed[state] = true;
+            }
+
+            const auto transitions =
+                pos == 0
+                ? character_transitions(
+                    automaton, automaton.epsilon_closure(state, true, false))
+                : inner_transitions[state];
+
+            for (const auto& transition : transitions)
+            {
+                auto& next_node = next_node_of_state[transition.second];
+
+                if (next_node == no_node)
+                {
+                    next_node = node_states.size();
+                    node_states.push_back(transition.second);
+                }
+
+                edges.push_back({ node, next_node, pos, transition.first });
+            }
+
+            if (edges.size() > max_num_edges)
+            {
+                return nullptr;
+            }
+        }
+
+        layer_begin = layer_end;
+    }
+
+    // The final nodes are the nodes of the last layer whose epsilon
+    // closure contains the final state.
+    vector<bool> node_is_final(node_states.size(), false);
+
+    for (auto node = layer_begin; node != node_states.size(); ++node)
+    {
+        const auto closure = automaton.epsilon_closure(node_states[node],
+                                                       false,
+                                                       true);
+        node_is_final[node] = find(closure.cbegin(),
+                                   closure.cend(),
+                                   Automaton::final_state())
+                              != closure.cend();
+    }
+
+    return create_pruned_graph(edges, move(node_is_final), length);
+}
+
+// Return the layered graph of the strings which both 'lhs' and 'rhs'
+// spell, for lines of 'length' cells, or nullptr if it would be too
+// large. See create(const std::vector<const Regex*>&, size_t).
+shared_ptr<const RegularConstraint::Graph>
+RegularConstraint::create_product_graph(const Graph& lhs,
+                                        const Graph& rhs,
+                                        size_t       length)
+{
+    // The nodes of the product, as pairs of nodes of 'lhs' and 'rhs',
+    // numbered layer by layer as in create_graph(). Node 0 of a graph
+    // is its initial node, unless the graph has no nodes at all.
+    vector<pair<size_t, size_t>> node_pairs;
+    vector<Edge> edges;
+    size_t layer_begin = 0;
+
+    if (!lhs.in_edges.empty() && !rhs.in_edges.empty())
+    {
+        node_pairs.emplace_back(0, 0);
+    }
+
+    for (size_t pos = 0; pos != length; ++pos)
+    {
+        const auto layer_end = node_pairs.size();
+        map<pair<size_t, size_t>, size_t> next_node_of_pair;
+
+        for (auto node = layer_begin; node != layer_end; ++node)
+        {
+            const auto node_pair = node_pairs[node];
+
+            for (const auto lhs_edge_index : lhs.out_edges[node_pair.first])
+            {
+                const auto& lhs_edge = lhs.edges[lhs_edge_index];
+
+                for (const auto rhs_edge_index :
+                       rhs.out_edges[node_pair.second])
+                {
+                    const auto& rhs_edge = rhs.edges[rhs_edge_index];
+
+                    if (lhs_edge.character_index != rhs_edge.character_index)
+                    {
+                        continue;
+                    }
+
+                    const auto next_node_pair = make_pair(lhs_edge.to,
+                                                          rhs_edge.to);
+                    const auto insertion = next_node_of_pair.emplace(
+                                             next_node_pair,
+                                             node_pairs.size());
+
+                    if (insertion.second)
+                    {
+                        node_pairs.push_back(next_node_pair);
+                    }
+
+                    edges.push_back({ node,
+                                      insertion.first->second,
+                                      pos,
+                                      lhs_edge.character_index });
+                }
+            }
+
+            if (edges.size() > max_num_edges)
+            {
+                return nullptr;
+            }
+        }
+
+        layer_begin = layer_end;
+    }
+
+    // Every node of the last layers of 'lhs' and 'rhs' is final, since
+    // the other ones were pruned.
+    vector<bool> node_is_final(node_pairs.size(), false);
+    fill(node_is_final.begin() + static_cast<ptrdiff_t>(layer_begin),
+         node_is_final.end(),
+         true);
+
+    return create_pruned_graph(edges, move(node_is_final), length);
+}
+
+// Return the layered graph made of the edges of 'edges' which lie on a
+// path to a node for which 'node_is_final' is true. 'edges' must be
+// ordered by layer, and the nodes numbered layer by layer, starting
+// with the initial node.
+shared_ptr<const RegularConstraint::Graph>
+RegularConstraint::create_pruned_graph(const vector<Edge>& edges,
+                                       vector<bool>        node_is_final,
+                                       size_t              length)
+{
+    const auto alphabet_size = Alphabet::characters_as_string().size();
+    const auto no_node = numeric_limits<size_t>::max();
+
+    // Keep only the nodes from which a final node can be reached, i.e.,
+    // the final nodes and their ancestors. Since the edges are ordered
+    // by layer, iterating them backwards visits the edges to a node
+    // before the edges from it.
+    auto node_is_kept = move(node_is_final);
+
+    for (auto it = edges.crbegin(); it != edges.crend(); ++it)
+    {
+        if (node_is_kept[it->to])
+        {
+            node_is_kept[it->from] = true;
+        }
+    }
+
+    // Renumber the nodes and the edges which are kept.
+    vector<size_t> new_nodes(node_is_kept.size(), no_node);
+    size_t num_nodes = 0;
+
+    for (size_t node = 0; node != node_is_kept.size(); ++node)
+    {
+        if (node_is_kept[node])
+        {
+            new_nodes[node] = num_nodes++;
+        }
+    }
+
+    auto graph = make_shared<Graph>();
+    graph->in_edges.resize(num_nodes);
+    graph->out_edges.resize(num_nodes);
+    graph->labeled_edges.resize(length * alphabet_size);
+    graph->num_supports.resize(length * alphabet_size, 0);
+
+    for (const auto& edge : edges)
+    {
+        if (!node_is_kept[edge.to])
+        {
+            continue;
+        }
+
+        const auto edge_index = graph->edges.size();
+        const auto label = edge.pos * alphabet_size + edge.character_index;
+
+        graph->edges.push_back({ new_nodes[edge.from],
+                                 new_nodes[edge.to],
+                                 edge.pos,
+                                 edge.character_index });
+        graph->out_edges[new_nodes[edge.from]].push_back(edge_index);
+        graph->in_edges[new_nodes[edge.to]].push_back(edge_index);
+        graph->labeled_edges[label].push_back(edge_index);
+        ++graph->num_supports[label];
+    }
+
+    return graph;
+}
+
+// accessing
+
+// Set 'strings' to the strings which the paths of the layered graph
+// that the last constraint left spell, and return true, unless there
+// are more than 'max_num_strings' of them, in which case return false.
+//
+// Every edge which is left lies on a path from the initial node to a
+// final node, so each step of the depth-first traversal below extends
+// a string which is eventually completed. The traversal thus stops
+// after having spelled at most 'max_num_strings' + 1 strings.
+bool
+RegularConstraint::get_strings(vector<string>& strings,
+                               size_t          max_num_strings) const
+{
+    strings.clear();
+
+    if (m_graph->in_edges.empty())
+    {
+        return true;
+    }
+
+    // The indices of the edges of the current path, and, for each of
+    // them, the index of the next out-edge of its origin to try.
+    vector<size_t> path;
+    vector<size_t> next_out_edge_indices(1, 0);
+    string string_;
+
+    while (!next_out_edge_indices.empty())
+    {
+        const auto node = path.empty() ? 0 : m_graph->edges[path.back()].to;
+
+        if (path.size() == m_length)
+        {
+            if (strings.size() == max_num_strings)
+            {
+                strings.clear();
+                return false;
+            }
+
+            strings.push_back(string_);
+        }
+        else
+        {
+            const auto& out_edges = m_graph->out_edges[node];
+            auto& i = next_out_edge_indices.back();
+
+            while (i != out_edges.size() && !m_edge_is_alive[out_edges[i]])
+            {
+                ++i;
+            }
+
+            if (i != out_edges.size())
+            {
+                const auto edge_index = out_edges[i++];
+                const auto& edge = m_graph->edges[edge_index];
+
+                path.push_back(edge_index);
+                next_out_edge_indices.push_back(0);
+                string_.push_back(
+                          Alphabet::character_at(edge.character_index));
+                continue;
+            }
+        }
+
+        // Backtrack.
+        next_out_edge_indices.pop_back();
+
+        if (!path.empty())
+        {
+            path.pop_back();
+            string_.pop_back();
+        }
+    }
+
+    return true;
+}
+
+// Return the number of supports of 'c' at position 'pos', i.e., the
+// number of paths through the layered graph which the last constraint
+// left and which spell 'c' at 'pos', counted as edges of that layer.
+size_t
+RegularConstraint::num_supports(size_t pos, char c) const
+{
+    return m_num_supports[pos * m_alphabet_size +
+                          Alphabet::index_of_character(c)];
+}
+
+// modifying
+
+// Constrain 'constraint' with the paths of the layered graph which are
+// left, and return the result. See the class comment.
+Constraint
+RegularConstraint::constrain(const Constraint& constraint)
+{
+    assert(constraint.size() == m_length);
+
+    if (m_last_constraint.empty() ||
+        !constraint.is_tighter_than_or_equal_to(m_last_constraint))
+    {
+        reset();
+        m_last_constraint = Constraint::all(m_length);
+    }
+
+    vector<size_t> edges_to_remove;
+
+    for (size_t pos = 0; pos != m_length; ++pos)
+    {
+        for (const auto c : m_last_constraint[pos] - constraint[pos])
+        {
+            const auto label =
+                pos * m_alphabet_size + Alphabet::index_of_character(c);
+
+            for (const auto edge_index : m_graph->labeled_edges[label])
+            {
+                if (m_edge_is_alive[edge_index])
+                {
+                    edges_to_remove.push_back(edge_index);
+                }
+            }
+        }
+    }
+
+    remove_edges(move(edges_to_remove));
+    m_last_constraint = constraint;
+
+    auto result = Constraint::none(m_length);
+
+    for (size_t pos = 0; pos != m_length; ++pos)
+    {
+        for (const auto c : constraint[pos])
+        {
+            const auto character_index = Alphabet::index_of_character(c);
+
+            if (m_num_supports[pos * m_alphabet_size + character_index] != 0)
+            {
+                result[pos].add_character_at(character_index);
+            }
+        }
+    }
+
+    return result;
+}
+
+// Remove the edges of 'edge_indices', and the edges which are left
+// without a path from the initial node or to a final node as a result.
+void
+RegularConstraint::remove_edges(vector<size_t> edge_indices)
+{
+    while (!edge_indices.empty())
+    {
+        const auto edge_index = edge_indices.back();
+        edge_indices.pop_back();
+
+        if (!m_edge_is_alive[edge_index])
+        {
+            continue;
+        }
+
+        m_edge_is_alive[edge_index] = false;
+
+        const auto& edge = m_graph->edges[edge_index];
+        --m_num_supports[edge.pos * m_alphabet_size + edge.character_index];
+
+        if (--m_num_out_edges[edge.from] == 0)
+        {
+            const auto& in_edges = m_graph->in_edges[edge.from];
+            edge_indices.insert(end(edge_indices),
+                                in_edges.cbegin(),
+                                in_edges.cend());
+        }
+
+        if (--m_num_in_edges[edge.to] == 0)
+        {
+            const auto& out_edges = m_graph->out_edges[edge.to];
+            edge_indices.insert(end(edge_indices),
+                                out_edges.cbegin(),
+                                out_edges.cend());
+        }
+    }
+}
+
+// Restore all the edges of the layered graph.
+void
+RegularConstraint::reset()
+{
+    const auto num_nodes = m_graph->in_edges.size();
+
+    m_edge_is_alive.assign(m_graph->edges.size(), true);
+    m_num_in_edges.resize(num_nodes);
+    m_num_out_edges.resize(num_nodes);
+
+    for (size_t node = 0; node != num_nodes; ++node)
+    {
+        m_num_in_edges[node] = m_graph->in_edges[node].size();
+        m_num_out_edges[node] = m_graph->out_edges[node].size();
+    }
+
+    m_num_supports = m_graph->num_supports;
+    m_last_constraint = Constraint();
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef REGULAR_CONSTRAINT_HPP
+#define REGULAR_CONSTRAINT_HPP
+
+#include "constraint.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Regex;
+
+
+// An instance of this class constrains a line on behalf of a regex by
+// maintaining the paths of its automaton (see Regex::get_automaton())
+// which spell a string that fits in the constraint of the line, instead
+// of by enumerating the values of the regex.
+//
+// The automaton is unrolled into a layered graph: the nodes of layer
+// 'i' are the states of the automaton which can be reached after
+// reading 'i' characters, and an edge from layer 'i' to layer 'i' + 1
+// is labeled with the character read at position 'i'. Only the nodes
+// and edges which lie on a path from the initial state (in layer 0) to
+// the final state (in the last layer) are kept.
+//
+// For each position and each character, the number of edges of that
+// layer labeled with that character (the "supports" of that character
+// at that position) is maintained. When a character is removed from a
+// position, its edges are removed; removing an edge may leave a node
+// without incoming or outgoing edges, in which case its other edges
+// are removed too, and so on. A character is then kept at a position
+// iff it still has supports at that position.
+//
+// For example, with regex 'AB|BA' and lines of 2 cells, constraint
+// { "AB", "A" } removes the edge labeled B at position 1, which leaves
+// the node reached with A at position 0 without outgoing edges, so
+// that the edge labeled A at position 0 is removed too. The new
+// constraint is { "B", "A" }.
+//
+// This is exact, like CompactTable, and its work is proportional to
+// the number of removed edges. The constraints that it is given are
+// normally tighter than the previous ones; if not, it starts afresh.
+//
+// A regular constraint may also constrain a line on behalf of several
+// regexes at once (see create()), in which case its paths spell the
+// strings which all of them match.
+//
+// Copies of a regular constraint share their layered graph, which
+// never changes.
+class RegularConstraint final
+{
+public:
+    // instance creation and deletion
+    static std::unique_ptr<RegularConstraint> create(const Regex& regex,
+                                                     size_t       length);
+    static std::unique_ptr<RegularConstraint> create(
+             const std::vector<const Regex*>& regexes, size_t length);
+
+    // accessing
+    bool get_strings(std::vector<std::string>& strings,
+                     size_t                    max_num_strings) const;
+    size_t num_supports(size_t pos, char c) const;
+
+    // modifying
+    Constraint constrain(const Constraint& constraint);
+
+private:
+    // An edge from node 'from' to node 'to', labeled with the character
+    // with index 'character_index' (see Alphabet::index_of_character())
+    // at position 'pos'.
+    struct Edge
+    {
+        size_t from;
+        size_t to;
+        size_t pos;
+        size_t character_index;
+    };
+
+    // The layered graph, and the supports before any removal.
+    struct Graph
+    {
+        std::vector<Edge> edges;
+
+        // 'in_edges[n]' and 'out_edges[n]' contain the indices of the
+        // edges to and from node 'n'.
+        std::vector<std::vector<size_t>> in_edges;
+        std::vector<std::vector<size_t>> out_edges;
+
+        // 'labeled_edges[pos * alphabet_size + c]' contains the indices
+        // of the edges labeled with the character with index 'c' at
+        // position 'pos'.
+        std::vector<std::vector<size_t>> labeled_edges;
+
+        // The initial values of 'm_num_supports'.
+        std::vector<size_t> num_supports;
+    };
+
+    // instance creation and deletion
+    RegularConstraint(std::shared_ptr<const Graph> graph,
+                      size_t                       length);
+    static std::shared_ptr<const Graph> create_graph(const Regex& regex,
+                                                     size_t       length);
+    static std::shared_ptr<const Graph> create_product_graph(
+                                          const Graph& lhs,
+                                          const Graph& rhs,
+                                          size_t       length);
+    static std::shared_ptr<const Graph> create_pruned_graph(
+                                          const std::vector<Edge>& edges,
+                                          std::vector<bool> node_is_final,
+                                          size_t                   length);
+
+    // modifying
+    void remove_edges(std::vector<size_t> edge_indices);
+    void reset();
+
+    // data members
+
+    // The length of the lines that this regular constraint constrains.
+    size_t m_length;
+
+    // The number of characters in the alphabet.
+    size_t m_alphabet_size;
+
+    std::shared_ptr<const Graph> m_graph;
+
+    // 'm_edge_is_alive[e]' tells whether edge 'e' has not been removed.
+    std::vector<bool> m_edge_is_alive;
+
+    // The numbers of edges which have not been removed, to and from
+    // each node.
+    std::vector<size_t> m_num_in_edges;
+    std::vector<size_t> m_num_out_edges;
+
+    // 'm_num_supports[pos * m_alphabet_size + c]' is the number of
+    // edges labeled with the character with index 'c' at position
+    // 'pos' which have not been removed.
+    std::vector<size_t> m_num_supports;
+
+    // The last constraint that this regular constraint was given, or
+    // an empty constraint if there is none.
+    Constraint m_last_constraint;
+};
+
+
+#endif // REGULAR_CONSTRAINT_HPP
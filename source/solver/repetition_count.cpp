@@ -54,6 +54,15 @@ RepetitionCount::infinite()
 
 // accessing
 
+// Precondition:
+// * this repetition count is not infinite
+size_t
+RepetitionCount::count() const
+{
+    assert(!m_is_infinite);
+    return m_count;
+}
+
 RepetitionCount
 operator+(const RepetitionCount& a, const RepetitionCount& b)
 {
@@ -46,6 +46,9 @@ public:
     RepetitionCount(size_t count);
     static RepetitionCount infinite();
 
+    // accessing
+    size_t count() const;
+
     // querying
     bool is_not_infinite() const;
 
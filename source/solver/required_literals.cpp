@@ -0,0 +1,417 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "required_literals.hpp"
+
+#include "constraint.hpp"
+
+#include <cassert>
+#include <utility>
+
+using namespace std;
+
+
+// instance creation and deletion
+
+RequiredLiterals::RequiredLiterals(vector<Literal> literals,
+                                   bool            is_prefix,
+                                   bool            is_suffix,
+                                   bool            is_exact) :
+  m_literals(move(literals)),
+  m_is_prefix(is_prefix),
+  m_is_suffix(is_suffix),
+  m_is_exact(is_exact)
+{
+    assert(!m_is_exact || m_literals.size() <= 1);
+}
+
+// Return the required literals of the union of a regex whose required
+// literals are 'lhs' and of a regex whose required literals are 'rhs'.
+//
+// Only unions of literals of the same length are taken into account:
+// 'AB|CD' requires '[AC][BD]'.
+RequiredLiterals
+RequiredLiterals::alternation(const RequiredLiterals& lhs,
+                              const RequiredLiterals& rhs)
+{
+    if (lhs.is_epsilon() && rhs.is_epsilon())
+    {
+        return epsilon();
+    }
+
+    if (!lhs.is_exact() || lhs.is_epsilon() ||
+        !rhs.is_exact() || rhs.is_epsilon())
+    {
+        return none();
+    }
+
+    const auto& lhs_literal = lhs.m_literals[0];
+    const auto& rhs_literal = rhs.m_literals[0];
+
+    if (lhs_literal.size() != rhs_literal.size())
+    {
+        return none();
+    }
+
+    auto literal = lhs_literal;
+
+    for (size_t i = 0; i != literal.size(); ++i)
+    {
+        literal[i] |= rhs_literal[i];
+    }
+
+    return exact(literal);
+}
+
+// Return the required literals of the concatenation of a regex whose
+// required literals are 'lhs' and of a regex whose required literals
+// are 'rhs'.
+//
+// If the last literal of 'lhs' is a suffix and the first literal of
+// 'rhs' is a prefix, they are merged into a single literal: 'A.*BC'
+// followed by 'DE.*F' requires 'A', 'BCDE' and 'F'.
+RequiredLiterals
+RequiredLiterals::concatenation(const RequiredLiterals& lhs,
+                                const RequiredLiterals& rhs)
+{
+    if (lhs.is_epsilon())
+    {
+        return rhs;
+    }
+
+    if (rhs.is_epsilon())
+    {
+        return lhs;
+    }
+
+    auto literals = lhs.m_literals;
+    auto rhs_it = rhs.m_literals.cbegin();
+
+    if (lhs.is_suffix() && rhs.is_prefix() &&
+        !lhs.m_literals.empty() && !rhs.m_literals.empty())
+    {
+        literals.back().insert(literals.back().end(),
+                               rhs_it->cbegin(),
+                               rhs_it->cend());
+        ++rhs_it;
+    }
+
+    literals.insert(literals.end(), rhs_it, rhs.m_literals.cend());
+
+    return RequiredLiterals(move(literals),
+                            !lhs.m_literals.empty() && lhs.is_prefix(),
+                            !rhs.m_literals.empty() && rhs.is_suffix(),
+                            lhs.is_exact() && rhs.is_exact());
+}
+
+// Return the required literals of a regex which matches only the empty
+// string.
+RequiredLiterals
+RequiredLiterals::epsilon()
+{
+    return RequiredLiterals({}, true, true, true);
+}
+
+// Return the required literals of a regex which matches exactly the
+// strings matched by 'literal'.
+RequiredLiterals
+RequiredLiterals::exact(const Literal& literal)
+{
+    return RequiredLiterals({ literal }, true, true, true);
+}
+
+// Return the required literals of a regex about which nothing is
+// known.
+RequiredLiterals
+RequiredLiterals::none()
+{
+    return RequiredLiterals({}, false, false, false);
+}
+
+// Return the required literals of a regex which repeats, from
+// 'min_count' to 'max_count' times, a regex whose required literals
+// are 'child'.
+//
+// At most 'max_num_copies' copies of 'child' are concatenated, in
+// order to keep the literals short. The remaining copies, if any, are
+// treated as unknown.
+RequiredLiterals
+RequiredLiterals::repetition(const RequiredLiterals& child,
+                             const RepetitionCount& min_count,
+                             const RepetitionCount& max_count)
+{
+    const size_t max_num_copies = 8;
+
+    if (max_count == 0)
+    {
+        return epsilon();
+    }
+
+    auto result = epsilon();
+    size_t num_copies = 0;
+
+    while (num_copies != max_num_copies && num_copies < min_count)
+    {
+        result = concatenation(result, child);
+        ++num_copies;
+    }
+
+    if (max_count != num_copies)
+    {
+        result = concatenation(result, none());
+    }
+
+    return result;
+}
+
+// accessing
+
+// Return 'constraint', narrowed by placing the required literals on
+// it: each literal must be placed where it fits, after the previous
+// literal and before the next one. The cells which are covered by all
+// the possible placements of a literal are narrowed to the characters
+// that the literal allows there.
+//
+// If the literals cannot be placed, return an impossible constraint.
+Constraint
+RequiredLiterals::constrain(const Constraint& constraint) const
+{
+    const auto size = constraint.size();
+
+    if (is_exact() &&
+        (is_epsilon() ? size != 0 : m_literals[0].size() != size))
+    {
+        return Constraint::none(size);
+    }
+
+    vector<size_t> earliest_positions;
+    vector<size_t> latest_positions;
+
+    if (!get_earliest_positions(constraint, earliest_positions) ||
+        !get_latest_positions(constraint, latest_positions))
+    {
+        return Constraint::none(size);
+    }
+
+    auto new_constraint = constraint;
+
+    for (size_t i = 0; i != m_literals.size(); ++i)
+    {
+        const auto& literal = m_literals[i];
+        const auto earliest_pos = earliest_positions[i];
+        const auto latest_pos = latest_positions[i];
+
+        if (latest_pos < earliest_pos)
+        {
+            return Constraint::none(size);
+        }
+
+        vector<size_t> positions;
+
+        for (auto pos = earliest_pos; pos <= latest_pos; ++pos)
+        {
+            if (literal_fits(literal, constraint, pos))
+            {
+                positions.push_back(pos);
+            }
+        }
+
+        for (auto x = latest_pos; x < earliest_pos + literal.size(); ++x)
+        {
+            SetOfCharacters characters;
+
+            for (const auto pos : positions)
+            {
+                characters |= literal[x - pos];
+            }
+
+            new_constraint[x] &= characters;
+
+            if (new_constraint[x].empty())
+            {
+                return Constraint::none(size);
+            }
+        }
+    }
+
+    return new_constraint;
+}
+
+// Put in 'positions' the leftmost position at which each literal can
+// be placed on 'constraint', after the previous literals. Return false
+// if the literals cannot be placed.
+bool
+RequiredLiterals::get_earliest_positions(const Constraint& constraint,
+                                         vector<size_t>&   positions) const
+{
+    const auto size = constraint.size();
+    size_t pos = 0;
+
+    for (size_t i = 0; i != m_literals.size(); ++i)
+    {
+        const auto& literal = m_literals[i];
+
+        if (pos + literal.size() > size)
+        {
+            return false;
+        }
+
+        if (m_is_suffix && i == m_literals.size() - 1)
+        {
+            pos = size - literal.size();
+        }
+
+        if (m_is_prefix && i == 0 && pos != 0)
+        {
+            return false;
+        }
+
+        while (!literal_fits(literal, constraint, pos))
+        {
+            if ((m_is_prefix && i == 0)                      ||
+                (m_is_suffix && i == m_literals.size() - 1) ||
+                pos + literal.size() == size)
+            {
+                return false;
+            }
+
+            ++pos;
+        }
+
+        positions.push_back(pos);
+        pos += literal.size();
+    }
+
+    return true;
+}
+
+// Put in 'positions' the rightmost position at which each literal can
+// be placed on 'constraint', before the next literals. Return false if
+// the literals cannot be placed.
+bool
+RequiredLiterals::get_latest_positions(const Constraint& constraint,
+                                       vector<size_t>&   positions) const
+{
+    positions.resize(m_literals.size());
+    auto end = constraint.size();
+
+    for (size_t i = m_literals.size(); i-- != 0;)
+    {
+        const auto& literal = m_literals[i];
+
+        if (literal.size() > end)
+        {
+            return false;
+        }
+
+        auto pos = end - literal.size();
+
+        if (m_is_prefix && i == 0)
+        {
+            pos = 0;
+        }
+
+        while (!literal_fits(literal, constraint, pos))
+        {
+            if ((m_is_prefix && i == 0)                      ||
+                (m_is_suffix && i == m_literals.size() - 1) ||
+                pos == 0)
+            {
+                return false;
+            }
+
+            --pos;
+        }
+
+        positions[i] = pos;
+        end = pos;
+    }
+
+    return true;
+}
+
+const vector<RequiredLiterals::Literal>&
+RequiredLiterals::literals() const
+{
+    return m_literals;
+}
+
+// querying
+
+// Return whether constrain() never narrows a constraint, except when
+// the constraint is impossible.
+bool
+RequiredLiterals::constrains_nothing() const
+{
+    return m_literals.empty() && !m_is_exact;
+}
+
+bool
+RequiredLiterals::is_epsilon() const
+{
+    return m_is_exact && m_literals.empty();
+}
+
+bool
+RequiredLiterals::is_exact() const
+{
+    return m_is_exact;
+}
+
+bool
+RequiredLiterals::is_prefix() const
+{
+    return m_is_prefix;
+}
+
+bool
+RequiredLiterals::is_suffix() const
+{
+    return m_is_suffix;
+}
+
+// Return whether 'literal' can be placed at position 'pos' of
+// 'constraint'.
+bool
+RequiredLiterals::literal_fits(const Literal&    literal,
+                               const Constraint& constraint,
+                               size_t            pos)
+{
+    if (pos + literal.size() > constraint.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i != literal.size(); ++i)
+    {
+        if ((literal[i] & constraint[pos + i]).empty())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef REQUIRED_LITERALS_HPP
+#define REQUIRED_LITERALS_HPP
+
+#include "repetition_count.hpp"
+#include "set_of_characters.hpp"
+
+#include <vector>
+
+class Constraint;
+
+
+// An instance of this class represents the literals which appear, in
+// that order and without overlapping, in every string matched by a
+// regex. A literal is a sequence of sets of characters.
+//
+// For example:
+// * every string matched by '.*XHCR.*X.*' contains 'XHCR', followed by
+//   'X'
+// * every string matched by 'N.*X.X.X.*E' starts with 'N', contains
+//   'X.X.X', and ends with 'E'
+//
+// The required literals of a regex are used to narrow a line
+// constraint cheaply, before the regex values are enumerated: each
+// literal must be placed somewhere on the line, after the previous
+// literal and before the next one.
+//
+// The required literals are computed from a superset of the strings
+// matched by the regex (for example, lookaheads and backreferences are
+// ignored), so they are always safe to use, although not always as
+// tight as they could be.
+class RequiredLiterals final
+{
+public:
+    typedef std::vector<SetOfCharacters> Literal;
+
+    // instance creation and deletion
+    static RequiredLiterals alternation(const RequiredLiterals& lhs,
+                                        const RequiredLiterals& rhs);
+    static RequiredLiterals concatenation(const RequiredLiterals& lhs,
+                                          const RequiredLiterals& rhs);
+    static RequiredLiterals epsilon();
+    static RequiredLiterals exact(const Literal& literal);
+    static RequiredLiterals none();
+    static RequiredLiterals repetition(const RequiredLiterals& child,
+                                       const RepetitionCount& min_count,
+                                       const RepetitionCount& max_count);
+
+    // accessing
+    Constraint constrain(const Constraint& constraint) const;
+    const std::vector<Literal>& literals() const;
+
+    // querying
+    bool constrains_nothing() const;
+    bool is_exact() const;
+    bool is_prefix() const;
+    bool is_suffix() const;
+
+private:
+    // instance creation and deletion
+    RequiredLiterals(std::vector<Literal> literals,
+                     bool                 is_prefix,
+                     bool                 is_suffix,
+                     bool                 is_exact);
+
+    // accessing
+    bool get_earliest_positions(const Constraint&    constraint,
+                                std::vector<size_t>& positions) const;
+    bool get_latest_positions(const Constraint&    constraint,
+                              std::vector<size_t>& positions) const;
+
+    // querying
+    bool is_epsilon() const;
+    static bool literal_fits(const Literal&    literal,
+                             const Constraint& constraint,
+                             size_t            pos);
+
+    // data members
+
+    // The literals, in the order in which they appear in the matched
+    // strings.
+    std::vector<Literal> m_literals;
+
+    // Whether the matched strings start (resp. end) with the first
+    // (resp. last) literal.
+    bool m_is_prefix;
+    bool m_is_suffix;
+
+    // Whether the matched strings are all matched by the single
+    // literal in 'm_literals', or are all empty if 'm_literals' is
+    // empty.
+    bool m_is_exact;
+};
+
+
+#endif // REQUIRED_LITERALS_HPP
@@ -0,0 +1,167 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "search_cost_estimate.hpp"
+
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+
+// accessing
+
+// Return the upper bound of the estimated number of nodes.
+double
+SearchCostEstimate::max_num_nodes() const
+{
+    return num_nodes() + half_width_of_interval();
+}
+
+// Return the upper bound of the estimated time to search the whole tree,
+// in milliseconds.
+double
+SearchCostEstimate::max_time_ms() const
+{
+    return max_num_nodes() * time_per_node_ms();
+}
+
+// Return the lower bound of the estimated number of nodes. The root of
+// the tree is always a node.
+double
+SearchCostEstimate::min_num_nodes() const
+{
+    return max(1.0, num_nodes() - half_width_of_interval());
+}
+
+// Return the lower bound of the estimated time to search the whole tree,
+// in milliseconds.
+double
+SearchCostEstimate::min_time_ms() const
+{
+    return min_num_nodes() * time_per_node_ms();
+}
+
+// Return the estimated number of nodes of the search tree, i.e., the
+// mean of the estimates of the probes.
+double
+SearchCostEstimate::num_nodes() const
+{
+    return m_num_probes == 0 ?
+           0.0               :
+           m_sum_of_estimates / static_cast<double>(m_num_probes);
+}
+
+size_t
+SearchCostEstimate::num_probes() const
+{
+    return m_num_probes;
+}
+
+// Return the estimated time to search the whole tree, in milliseconds.
+double
+SearchCostEstimate::time_ms() const
+{
+    return num_nodes() * time_per_node_ms();
+}
+
+// Return the half width of the 95% confidence interval of the
+// estimated number of nodes, or 0 if there are fewer than two probes.
+double
+SearchCostEstimate::half_width_of_interval() const
+{
+    if (m_num_probes < 2)
+    {
+        return 0.0;
+    }
+
+    const auto n = static_cast<double>(m_num_probes);
+    const auto mean = m_sum_of_estimates / n;
+
+    // The unbiased sample variance, which rounding may make slightly
+    // negative when all the estimates are equal.
+    const auto variance =
+        max(0.0, (m_sum_of_squared_estimates - n * mean * mean) / (n - 1.0));
+
+    const auto z_95 = 1.96;
+    return z_95 * sqrt(variance / n);
+}
+
+// Return the mean time that the probes took per node, in milliseconds.
+double
+SearchCostEstimate::time_per_node_ms() const
+{
+    return m_num_nodes_probed == 0                               ?
+           0.0                                                   :
+           m_time_probing_ms / static_cast<double>(m_num_nodes_probed);
+}
+
+// printing
+
+vector<string>
+SearchCostEstimate::print() const
+{
+    // The estimates of large search trees exceed any integer type.
+    const auto to_rounded_string = [](double x)
+                                   {
+                                       return Utils::to_string(round(x));
+                                   };
+
+    return
+    {
+        Utils::statistics_line("probes", Utils::to_string(m_num_probes)),
+        Utils::statistics_line("nodes", to_rounded_string(num_nodes())),
+        Utils::statistics_line("nodes (95%)",
+                               to_rounded_string(min_num_nodes()) + " - " +
+                               to_rounded_string(max_num_nodes())),
+        Utils::statistics_line("time (ms)", Utils::to_string(time_ms())),
+        Utils::statistics_line("time (ms, 95%)",
+                               Utils::to_string(min_time_ms()) + " - " +
+                               Utils::to_string(max_time_ms()))
+    };
+}
+
+// modifying
+
+// Add a probe, whose estimate of the number of nodes of the search tree
+// is 'num_nodes_estimate', which constrained 'num_nodes_probed' nodes,
+// in 'time_ms' milliseconds.
+void
+SearchCostEstimate::add_probe(double num_nodes_estimate,
+                              size_t num_nodes_probed,
+                              double time_ms)
+{
+    assert(num_nodes_estimate >= 1.0);
+
+    ++m_num_probes;
+    m_sum_of_estimates += num_nodes_estimate;
+    m_sum_of_squared_estimates += num_nodes_estimate * num_nodes_estimate;
+    m_num_nodes_probed += num_nodes_probed;
+    m_time_probing_ms += time_ms;
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef SEARCH_COST_ESTIMATE_HPP
+#define SEARCH_COST_ESTIMATE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+// An instance of this class estimates the cost of searching a grid
+// exhaustively (see Grid::estimate_search_cost()), from random probes
+// of its search tree, with Knuth's estimator.
+//
+// A probe follows a single random path from the root of the search tree
+// to a leaf, and estimates the number of nodes (see SearchStatistics)
+// of the tree as 1 + d1 + d1 * d2 + ..., where d1, d2... are the numbers
+// of branches of the nodes on the path. Its expected value is the
+// number of nodes of the tree, but its variance is high when the tree
+// is unbalanced, so that many probes are averaged.
+//
+// The bounds of the estimate are those of a 95% confidence interval of
+// the mean of the probes, assuming that it is normally distributed.
+// They are only indicative, since the estimates of the probes are
+// heavily skewed.
+class SearchCostEstimate final
+{
+public:
+    // accessing
+    double max_num_nodes() const;
+    double max_time_ms() const;
+    double min_num_nodes() const;
+    double min_time_ms() const;
+    double num_nodes() const;
+    size_t num_probes() const;
+    double time_ms() const;
+
+    // printing
+    std::vector<std::string> print() const;
+
+    // modifying
+    void add_probe(double num_nodes_estimate,
+                   size_t num_nodes_probed,
+                   double time_ms);
+
+private:
+    // accessing
+    double half_width_of_interval() const;
+    double time_per_node_ms() const;
+
+    // data members
+
+    // The number of probes, and the sum of their estimates and of the
+    // squares of their estimates.
+    size_t m_num_probes = 0;
+    double m_sum_of_estimates = 0.0;
+    double m_sum_of_squared_estimates = 0.0;
+
+    // The number of nodes which the probes constrained, and the time
+    // which they took, from which the time to search the whole tree is
+    // extrapolated.
+    size_t m_num_nodes_probed = 0;
+    double m_time_probing_ms = 0.0;
+};
+
+
+#endif // SEARCH_COST_ESTIMATE_HPP
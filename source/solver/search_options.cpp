@@ -0,0 +1,202 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "search_options.hpp"
+
+#include <cassert>
+
+using namespace std;
+
+
+namespace
+{
+
+// data
+
+const struct
+{
+    SearchOptions::Branching branching;
+    const char*              name;
+} g_branchings[] =
+{
+    { SearchOptions::Branching::CHARACTERS, "characters" },
+    { SearchOptions::Branching::HALVES,     "halves"     }
+};
+
+const struct
+{
+    SearchOptions::Strategy strategy;
+    const char*             name;
+} g_strategies[] =
+{
+    { SearchOptions::Strategy::DEPTH_FIRST,         "depth-first"        },
+    { SearchOptions::Strategy::LIMITED_DISCREPANCY, "discrepancy"        },
+    { SearchOptions::Strategy::GEOMETRIC_RESTARTS,  "geometric-restarts" },
+    { SearchOptions::Strategy::LUBY_RESTARTS,       "luby-restarts"      }
+};
+
+} // unnamed namespace
+
+
+// accessing
+
+SearchOptions::Branching
+SearchOptions::branching() const
+{
+    return m_branching;
+}
+
+// If 'name' is the name of a branching, set '*branching' to it and
+// return true. Otherwise, return false.
+bool
+SearchOptions::branching_from_name(const string& name, Branching* branching)
+{
+    for (const auto& branching_ : g_branchings)
+    {
+        if (name == branching_.name)
+        {
+            *branching = branching_.branching;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+string
+SearchOptions::name(Branching branching)
+{
+    for (const auto& branching_ : g_branchings)
+    {
+        if (branching == branching_.branching)
+        {
+            return branching_.name;
+        }
+    }
+
+    assert(false);
+    return "";
+}
+
+string
+SearchOptions::name(Strategy strategy)
+{
+    for (const auto& strategy_ : g_strategies)
+    {
+        if (strategy == strategy_.strategy)
+        {
+            return strategy_.name;
+        }
+    }
+
+    assert(false);
+    return "";
+}
+
+size_t
+SearchOptions::num_threads() const
+{
+    return m_num_threads;
+}
+
+unsigned int
+SearchOptions::seed() const
+{
+    return m_seed;
+}
+
+SearchOptions::Strategy
+SearchOptions::strategy() const
+{
+    return m_strategy;
+}
+
+// If 'name' is the name of a strategy, set '*strategy' to it and return
+// true. Otherwise, return false.
+bool
+SearchOptions::strategy_from_name(const string& name, Strategy* strategy)
+{
+    for (const auto& strategy_ : g_strategies)
+    {
+        if (name == strategy_.name)
+        {
+            *strategy = strategy_.strategy;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// querying
+
+bool
+SearchOptions::branches_on_lines() const
+{
+    return m_branches_on_lines;
+}
+
+// Return whether the strategy restarts the search.
+bool
+SearchOptions::restarts() const
+{
+    return m_strategy == Strategy::GEOMETRIC_RESTARTS ||
+           m_strategy == Strategy::LUBY_RESTARTS;
+}
+
+// modifying
+
+void
+SearchOptions::set_branches_on_lines(bool on_or_off)
+{
+    m_branches_on_lines = on_or_off;
+}
+
+void
+SearchOptions::set_branching(Branching branching)
+{
+    m_branching = branching;
+}
+
+// Precondition:
+// * num_threads != 0
+void
+SearchOptions::set_num_threads(size_t num_threads)
+{
+    assert(num_threads != 0);
+    m_num_threads = num_threads;
+}
+
+void
+SearchOptions::set_seed(unsigned int seed)
+{
+    m_seed = seed;
+}
+
+void
+SearchOptions::set_strategy(Strategy strategy)
+{
+    m_strategy = strategy;
+}
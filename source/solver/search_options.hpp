@@ -0,0 +1,117 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef SEARCH_OPTIONS_HPP
+#define SEARCH_OPTIONS_HPP
+
+#include <cstddef>
+#include <string>
+
+
+// An instance of this class represents the choices which Grid::solve()
+// makes when it searches a grid that constraining alone does not solve,
+// and when it constrains the grid.
+class SearchOptions final
+{
+public:
+    // How the search branches on the cell that it selects (see
+    // Grid::cell_to_search()):
+    // * CHARACTERS: one branch per possible character of the cell
+    // * HALVES: two branches, each restricting the cell to half of its
+    //   possible characters, so that constraining may refute several
+    //   characters at once
+    enum class Branching
+    {
+        CHARACTERS,
+        HALVES
+    };
+
+    // The order in which the search explores the branches (see
+    // Grid::solve()):
+    // * DEPTH_FIRST: depth-first, the branches of each node in turn
+    // * LIMITED_DISCREPANCY: in successive iterations, each exploring
+    //   the leaves which are reached by departing from the order of the
+    //   branches (a "discrepancy") exactly 0, 1, 2... times, so that
+    //   the leaves which the heuristics prefer are explored first
+    // * GEOMETRIC_RESTARTS, LUBY_RESTARTS: depth-first, with the
+    //   branches of each node in random order, restarted whenever it
+    //   has explored a given number of nodes, which grows after each
+    //   restart geometrically, or following the Luby sequence
+    //   (1, 1, 2, 1, 1, 2, 4, 1, ...)
+    enum class Strategy
+    {
+        DEPTH_FIRST,
+        LIMITED_DISCREPANCY,
+        GEOMETRIC_RESTARTS,
+        LUBY_RESTARTS
+    };
+
+    // accessing
+    Branching branching() const;
+    static bool branching_from_name(const std::string& name,
+                                    Branching*         branching);
+    static std::string name(Branching branching);
+    static std::string name(Strategy strategy);
+    size_t num_threads() const;
+    unsigned int seed() const;
+    Strategy strategy() const;
+    static bool strategy_from_name(const std::string& name,
+                                   Strategy*          strategy);
+
+    // querying
+    bool branches_on_lines() const;
+    bool restarts() const;
+
+    // modifying
+    void set_branches_on_lines(bool on_or_off);
+    void set_branching(Branching branching);
+    void set_num_threads(size_t num_threads);
+    void set_seed(unsigned int seed);
+    void set_strategy(Strategy strategy);
+
+private:
+    // data members
+
+    Branching m_branching = Branching::CHARACTERS;
+
+    // Whether the search, rather than selecting a cell, selects a line
+    // whose remaining strings are few, when there is one, and branches
+    // on each of these strings (see Grid::line_to_search()).
+    bool m_branches_on_lines = false;
+
+    Strategy m_strategy = Strategy::DEPTH_FIRST;
+
+    // The seed of the random order of the branches, when the search
+    // restarts.
+    unsigned int m_seed = 1;
+
+    // The number of threads with which the lines of the grid are
+    // constrained (see Grid::constrain_in_rounds()), or 1 if they are
+    // constrained one at a time.
+    size_t m_num_threads = 1;
+};
+
+
+#endif // SEARCH_OPTIONS_HPP
@@ -0,0 +1,64 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "search_statistics.hpp"
+
+#include "utils.hpp"
+
+using namespace std;
+
+
+// printing
+
+vector<string>
+SearchStatistics::print() const
+{
+    return
+    {
+        Utils::statistics_line("nodes", Utils::to_string(m_num_nodes)),
+        Utils::statistics_line("dead ends", Utils::to_string(m_num_dead_ends)),
+        Utils::statistics_line("runs", Utils::to_string(m_num_runs))
+    };
+}
+
+// modifying
+
+void
+SearchStatistics::count_dead_end()
+{
+    ++m_num_dead_ends;
+}
+
+void
+SearchStatistics::count_node()
+{
+    ++m_num_nodes;
+}
+
+void
+SearchStatistics::count_run()
+{
+    ++m_num_runs;
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef SEARCH_STATISTICS_HPP
+#define SEARCH_STATISTICS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+// An instance of this class counts the nodes of the search tree which
+// Grid::solve() explores, so that the ways of searching (see
+// SearchOptions) can be compared.
+//
+// A node is a grid which is constrained, i.e., the grid to solve and
+// each of the copies that the search makes of it. A dead end is a node
+// which constraining shows to have no solutions.
+class SearchStatistics final
+{
+public:
+    // printing
+    std::vector<std::string> print() const;
+
+    // modifying
+    void count_dead_end();
+    void count_node();
+    void count_run();
+
+private:
+    // data members
+
+    size_t m_num_nodes = 0;
+    size_t m_num_dead_ends = 0;
+
+    // The number of runs of the search: 1, unless the strategy of the
+    // search consists of several runs (see SearchOptions::Strategy).
+    size_t m_num_runs = 0;
+};
+
+
+#endif // SEARCH_STATISTICS_HPP
@@ -0,0 +1,97 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "transposition_table.hpp"
+
+#include "utils.hpp"
+
+using namespace std;
+
+
+// instance creation and deletion
+
+// Create a table with 2 ^ 'log2_num_slots' slots.
+TranspositionTable::TranspositionTable(size_t log2_num_slots) :
+  m_failures(size_t(1) << log2_num_slots, 0)
+{
+}
+
+// querying
+
+// Return whether the state whose hash is 'hash' was recorded as having
+// no solutions.
+bool
+TranspositionTable::is_known_failure(uint64_t hash)
+{
+    ++m_num_lookups;
+
+    const auto result =
+        hash != 0 && m_failures[hash & (m_failures.size() - 1)] == hash;
+
+    if (result)
+    {
+        ++m_num_hits;
+    }
+
+    return result;
+}
+
+// printing
+
+// Return the number of lookups, of hits and of recorded failures, and
+// the hit rate (as a percentage of the lookups).
+vector<string>
+TranspositionTable::print_statistics() const
+{
+    const auto hit_rate = m_num_lookups == 0
+                          ? 0
+                          : (100 * m_num_hits) / m_num_lookups;
+
+    return
+    {
+        Utils::statistics_line("lookups", Utils::to_string(m_num_lookups)),
+        Utils::statistics_line("hits", Utils::to_string(m_num_hits)),
+        Utils::statistics_line("hit rate", Utils::to_string(hit_rate) + '%'),
+        Utils::statistics_line("failures",
+                        Utils::to_string(m_num_recorded_failures))
+    };
+}
+
+// modifying
+
+// Record that the state whose hash is 'hash' has no solutions. A hash
+// of 0 (which marks the empty slots) is not recorded.
+void
+TranspositionTable::record_failure(uint64_t hash)
+{
+    if (hash == 0)
+    {
+        return;
+    }
+
+    m_failures[hash & (m_failures.size() - 1)] = hash;
+    ++m_num_recorded_failures;
+}
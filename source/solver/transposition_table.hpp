@@ -0,0 +1,76 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// An instance of this class records the grid states (identified by
+// their Zobrist hashes - see Grid::hash()) which are known to have no
+// solutions, so that the search does not explore them again when it
+// reaches them by another path.
+//
+// The table is bounded: each hash has a single slot, determined by its
+// low bits, and a new failure replaces whichever failure occupied its
+// slot. A hash which is not found is thus not known to have solutions;
+// it may have been replaced.
+class TranspositionTable final
+{
+public:
+    // instance creation and deletion
+    explicit TranspositionTable(size_t log2_num_slots = 16);
+
+    // querying
+    bool is_known_failure(std::uint64_t hash);
+
+    // printing
+    std::vector<std::string> print_statistics() const;
+
+    // modifying
+    void record_failure(std::uint64_t hash);
+
+private:
+    // data members
+
+    // The hashes of the failed states, or 0 for the empty slots.
+    std::vector<std::uint64_t> m_failures;
+
+    // The number of calls to is_known_failure(), and how many of them
+    // returned true.
+    size_t m_num_lookups = 0;
+    size_t m_num_hits = 0;
+
+    // The number of calls to record_failure().
+    size_t m_num_recorded_failures = 0;
+};
+
+
+#endif // TRANSPOSITION_TABLE_HPP
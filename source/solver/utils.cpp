@@ -127,6 +127,16 @@ Utils::hex_digit_to_int(char c)
     }
 }
 
+// Return 'name', padded to a fixed width, followed by 'value'. This is
+// the format of the lines of the statistics which the program prints
+// (see for example TranspositionTable::print_statistics()).
+string
+Utils::statistics_line(const string& name, const string& value)
+{
+    const size_t name_width = 20;
+    return name + string(name_width - name.size(), ' ') + value;
+}
+
 // Return 's' surrounded by single quotes.
 string
 Utils::quoted(const string& s)
@@ -114,6 +114,7 @@ int digit_to_int(char c);
 int hex_digit_to_int(char c);
 std::string quoted(const std::string& s);
 std::vector<std::string> split_into_lines(const std::string& s);
+std::string statistics_line(const std::string& name, const std::string& value);
 template<typename UnsignedIntegralType>
 bool string_to_unsigned(const std::string& s, UnsignedIntegralType* number);
 template<typename UnsignedIntegralType>
@@ -0,0 +1,107 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "zobrist_hash.hpp"
+
+#include "alphabet.hpp"
+#include "set_of_characters.hpp"
+
+using namespace std;
+
+
+namespace
+{
+
+// Return a pseudo-random value which depends on 'x' only (this is the
+// finalizer of the SplitMix64 generator).
+uint64_t
+mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+// Return the key of the character with index 'character_index' in the
+// cell whose seed is 'cell_seed'.
+uint64_t
+key(uint64_t cell_seed, size_t character_index)
+{
+    return mix(cell_seed + character_index);
+}
+
+} // unnamed namespace
+
+
+namespace ZobristHash
+{
+
+// accessing
+
+// Return the seed from which the keys of the cell at 'coordinates' are
+// derived.
+uint64_t
+cell_seed(const vector<size_t>& coordinates)
+{
+    uint64_t result = 0;
+
+    for (const auto coordinate : coordinates)
+    {
+        result = mix(result ^ coordinate);
+    }
+
+    return result;
+}
+
+// Return the hash of 'characters' as the possible characters of the
+// cell whose seed is 'cell_seed'.
+uint64_t
+hash(uint64_t cell_seed, const SetOfCharacters& characters)
+{
+    uint64_t result = 0;
+
+    for (const auto c : characters)
+    {
+        result ^= key(cell_seed, Alphabet::index_of_character(c));
+    }
+
+    return result;
+}
+
+// Return the value whose exclusive or with the hash of 'old_characters'
+// (as the possible characters of the cell whose seed is 'cell_seed')
+// gives the hash of 'new_characters'.
+uint64_t
+hash_change(uint64_t               cell_seed,
+            const SetOfCharacters& old_characters,
+            const SetOfCharacters& new_characters)
+{
+    return hash(cell_seed, (old_characters - new_characters) |
+                           (new_characters - old_characters));
+}
+
+} // namespace ZobristHash
@@ -0,0 +1,63 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef ZOBRIST_HASH_HPP
+#define ZOBRIST_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SetOfCharacters;
+
+
+// Zobrist hashing of the possible characters of cells.
+//
+// Each (cell, character) pair is assigned a pseudo-random 64-bit key,
+// and the hash of a set of cells is the exclusive or of the keys of the
+// possible characters of its cells. When the possible characters of a
+// cell change, the hash changes by the exclusive or of the keys of the
+// characters which were added or removed (see hash_change()), so hashes
+// of lines and grids can be maintained incrementally.
+//
+// The keys only depend on the coordinates of the cells and on the
+// indices of the characters in the alphabet, so that identical grid
+// states have identical hashes, even across copies of a grid.
+namespace ZobristHash
+{
+
+// accessing
+std::uint64_t cell_seed(const std::vector<size_t>& coordinates);
+std::uint64_t hash(std::uint64_t          cell_seed,
+                   const SetOfCharacters& characters);
+std::uint64_t hash_change(std::uint64_t          cell_seed,
+                          const SetOfCharacters& old_characters,
+                          const SetOfCharacters& new_characters);
+
+} // namespace ZobristHash
+
+
+#endif // ZOBRIST_HASH_HPP
@@ -109,3 +109,12 @@ TEST_F(AlphabetTest, set_to_too_large)
 
     EXPECT_THROW(Alphabet::set(characters), AlphabetException);
 }
+
+TEST_F(AlphabetTest, set_twice)
+{
+    Alphabet::set("AB");
+    Alphabet::set(" AB");
+    EXPECT_TRUE(Alphabet::has_non_word_characters(SetOfCharacters(' ')));
+    EXPECT_TRUE(Alphabet::has_word_characters(SetOfCharacters('A')));
+    EXPECT_TRUE(Alphabet::has_word_characters(SetOfCharacters('B')));
+}
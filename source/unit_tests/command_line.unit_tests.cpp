@@ -30,6 +30,7 @@
 #include "regex_crossword_solver_exception.hpp"
 #include "regex_crossword_solver_test.hpp"
 #include "regex_optimizations.hpp"
+#include "search_options.hpp"
 #include "utils.hpp"
 
 using namespace std;
@@ -254,10 +255,277 @@ TEST_F(CommandLineTest, no_optim)
     CommandLine::parse(argc, argv);
     const auto optimizations = CommandLine::regex_optimizations();
     EXPECT_FALSE(optimizations.optimize_concatenations());
+    EXPECT_FALSE(optimizations.optimize_factorizations());
     EXPECT_FALSE(optimizations.optimize_groups());
+    EXPECT_FALSE(optimizations.optimize_repetitions());
     EXPECT_FALSE(optimizations.optimize_unions());
 }
 
+TEST_F(CommandLineTest, no_factor_optim)
+{
+    const char* const argv[] =
+        { "program", "--no-factor-optim", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    const auto optimizations = CommandLine::regex_optimizations();
+    EXPECT_FALSE(optimizations.optimize_factorizations());
+    EXPECT_TRUE(optimizations.optimize_repetitions());
+}
+
+TEST_F(CommandLineTest, no_repeat_optim)
+{
+    const char* const argv[] =
+        { "program", "--no-repeat-optim", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    const auto optimizations = CommandLine::regex_optimizations();
+    EXPECT_TRUE(optimizations.optimize_factorizations());
+    EXPECT_FALSE(optimizations.optimize_repetitions());
+}
+
+TEST_F(CommandLineTest, optim)
+{
+    const char* const argv[] =
+        { "program", "--optim=unions,groups", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    const auto optimizations = CommandLine::regex_optimizations();
+    using ROT = RegexOptimizations::Type;
+    const vector<ROT> expected_passes = { ROT::UNIONS, ROT::GROUPS };
+    EXPECT_EQ(expected_passes, optimizations.enabled_passes());
+}
+
+TEST_F(CommandLineTest, optim_and_no_group_optim)
+{
+    const char* const argv[] =
+        { "program",
+          "--optim=unions,groups",
+          "--no-group-optim",
+          "input_file",
+          nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    const auto optimizations = CommandLine::regex_optimizations();
+    using ROT = RegexOptimizations::Type;
+    const vector<ROT> expected_passes = { ROT::UNIONS };
+    EXPECT_EQ(expected_passes, optimizations.enabled_passes());
+}
+
+TEST_F(CommandLineTest, optim_unknown_pass)
+{
+    const char* const argv[] =
+        { "program", "--optim=unions,foo", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, optim_duplicate_pass)
+{
+    const char* const argv[] =
+        { "program", "--optim=unions,unions", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, optim_stats)
+{
+    const char* const argv[] =
+        { "program", "--optim-stats", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_TRUE(CommandLine::optimization_statistics_are_requested());
+}
+
+TEST_F(CommandLineTest, search_stats)
+{
+    const char* const argv[] =
+        { "program", "--search-stats", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_TRUE(CommandLine::search_statistics_are_requested());
+}
+
+TEST_F(CommandLineTest, default_branching)
+{
+    const char* const argv[] = { "program", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_EQ(SearchOptions::Branching::CHARACTERS,
+              CommandLine::search_options().branching());
+    EXPECT_FALSE(CommandLine::search_options().branches_on_lines());
+    EXPECT_EQ(SearchOptions::Strategy::DEPTH_FIRST,
+              CommandLine::search_options().strategy());
+    EXPECT_EQ(1u, CommandLine::search_options().seed());
+}
+
+TEST_F(CommandLineTest, branching)
+{
+    const char* const argv[] =
+        { "program", "--branching=halves", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_EQ(SearchOptions::Branching::HALVES,
+              CommandLine::search_options().branching());
+}
+
+TEST_F(CommandLineTest, line_branching)
+{
+    const char* const argv[] =
+        { "program", "--line-branching", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_TRUE(CommandLine::search_options().branches_on_lines());
+}
+
+TEST_F(CommandLineTest, unknown_branching)
+{
+    const char* const argv[] =
+        { "program", "--branching=thirds", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, strategy_and_seed)
+{
+    const char* const argv[] =
+        { "program", "--strategy=luby-restarts", "--seed=42", "input_file",
+          nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_EQ(SearchOptions::Strategy::LUBY_RESTARTS,
+              CommandLine::search_options().strategy());
+    EXPECT_EQ(42u, CommandLine::search_options().seed());
+}
+
+TEST_F(CommandLineTest, unknown_strategy)
+{
+    const char* const argv[] =
+        { "program", "--strategy=breadth-first", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, invalid_seed)
+{
+    const char* const argv[] =
+        { "program", "--seed=x", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, default_portfolio_size)
+{
+    const char* const argv[] = { "program", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_EQ(1, CommandLine::portfolio_size());
+    EXPECT_EQ(1, CommandLine::search_options().num_threads());
+}
+
+TEST_F(CommandLineTest, portfolio)
+{
+    const char* const argv[] =
+        { "program", "--portfolio=4", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_EQ(4, CommandLine::portfolio_size());
+}
+
+TEST_F(CommandLineTest, threads)
+{
+    const char* const argv[] =
+        { "program", "--threads=8", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_EQ(8, CommandLine::search_options().num_threads());
+}
+
+TEST_F(CommandLineTest, threads_zero)
+{
+    const char* const argv[] =
+        { "program", "--threads=0", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, portfolio_zero)
+{
+    const char* const argv[] =
+        { "program", "--portfolio=0", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+#if ENABLE_LOGGING
+TEST_F(CommandLineTest, portfolio_and_log)
+{
+    const char* const argv[] =
+        { "program", "--portfolio=2", "--log=-", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, threads_and_log)
+{
+    const char* const argv[] =
+        { "program", "--threads=2", "--log=-", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+#endif // ENABLE_LOGGING
+
+TEST_F(CommandLineTest, edit_benchmark)
+{
+    const char* const argv[] =
+        { "program", "--edit-benchmark", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_TRUE(CommandLine::edit_benchmark_is_requested());
+}
+
+TEST_F(CommandLineTest, default_estimate)
+{
+    const char* const argv[] = { "program", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_FALSE(CommandLine::search_cost_estimate_is_requested());
+}
+
+TEST_F(CommandLineTest, estimate)
+{
+    const char* const argv[] =
+        { "program", "--estimate=50", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_TRUE(CommandLine::search_cost_estimate_is_requested());
+    EXPECT_EQ(50, CommandLine::search_cost_estimate_time_budget_ms());
+}
+
+TEST_F(CommandLineTest, estimate_zero)
+{
+    const char* const argv[] =
+        { "program", "--estimate=0", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, invalid_estimate)
+{
+    const char* const argv[] =
+        { "program", "--estimate=x", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    EXPECT_THROW(CommandLine::parse(argc, argv), CommandLineException);
+}
+
+TEST_F(CommandLineTest, kernel_stats)
+{
+    const char* const argv[] =
+        { "program", "--kernel-stats", "input_file", nullptr };
+    const int argc = Utils::array_size(argv) - 1;
+    CommandLine::parse(argc, argv);
+    EXPECT_TRUE(CommandLine::kernel_statistics_are_requested());
+}
+
 TEST_F(CommandLineTest, input_file)
 {
     const char* const input_file = "input_file";
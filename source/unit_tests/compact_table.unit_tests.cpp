@@ -0,0 +1,122 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "alphabet.hpp"
+#include "compact_table.hpp"
+#include "disable_warnings_from_gtest.hpp"
+#include "regex_crossword_solver_test.hpp"
+
+using namespace std;
+
+
+class CompactTableTest : public RegexCrosswordSolverTest
+{
+};
+
+
+TEST_F(CompactTableTest, constrain)
+{
+    Alphabet::set("ABC");
+
+    CompactTable table({ "AB", "BA", "BB" }, 2);
+    EXPECT_EQ(3U, table.num_valid_strings());
+
+    EXPECT_EQ(Constraint({ "AB", "AB" }),
+              table.constrain(Constraint({ "ABC", "ABC" })));
+    EXPECT_EQ(3U, table.num_valid_strings());
+
+    EXPECT_EQ(Constraint({ "AB", "B" }),
+              table.constrain(Constraint({ "AB", "B" })));
+    EXPECT_EQ(2U, table.num_valid_strings());
+
+    EXPECT_EQ(Constraint({ "B", "B" }),
+              table.constrain(Constraint({ "B", "B" })));
+    EXPECT_EQ(1U, table.num_valid_strings());
+
+    EXPECT_TRUE(table.constrain(Constraint({ "", "B" })).is_impossible());
+    EXPECT_EQ(0U, table.num_valid_strings());
+}
+
+TEST_F(CompactTableTest, constrain_copy)
+{
+    Alphabet::set("ABC");
+
+    CompactTable table({ "AB", "BA", "BB" }, 2);
+    EXPECT_EQ(Constraint({ "AB", "AB" }),
+              table.constrain(Constraint({ "ABC", "ABC" })));
+
+    auto copy = table;
+    EXPECT_EQ(Constraint({ "A", "B" }),
+              copy.constrain(Constraint({ "A", "ABC" })));
+    EXPECT_EQ(1U, copy.num_valid_strings());
+
+    // Constraining the copy does not affect the original.
+    EXPECT_EQ(3U, table.num_valid_strings());
+    EXPECT_EQ(Constraint({ "B", "AB" }),
+              table.constrain(Constraint({ "B", "AB" })));
+}
+
+TEST_F(CompactTableTest, valid_strings)
+{
+    Alphabet::set("ABC");
+
+    CompactTable table({ "AB", "BA", "BB" }, 2);
+    table.constrain(Constraint({ "AB", "B" }));
+
+    const vector<string> expected = { "AB", "BB" };
+    EXPECT_EQ(expected, table.valid_strings());
+}
+
+TEST_F(CompactTableTest, constrain_many_strings)
+{
+    Alphabet::set("ABC");
+
+    // More strings than there are bits in a single element of a bitset.
+    vector<string> strings;
+    for (const auto c1 : string("ABC"))
+    {
+        for (const auto c2 : string("ABC"))
+        {
+            for (const auto c3 : string("ABC"))
+            {
+                for (const auto c4 : string("ABC"))
+                {
+                    if (c1 != 'C' || c4 != 'C')
+                    {
+                        strings.push_back({ c1, c2, c3, c4 });
+                    }
+                }
+            }
+        }
+    }
+
+    CompactTable table(strings, 4);
+    EXPECT_EQ(72U, table.num_valid_strings());
+
+    EXPECT_EQ(Constraint({ "C", "ABC", "ABC", "AB" }),
+              table.constrain(Constraint({ "C", "ABC", "ABC", "ABC" })));
+    EXPECT_EQ(18U, table.num_valid_strings());
+}
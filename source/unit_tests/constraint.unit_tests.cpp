@@ -112,6 +112,16 @@ TEST_F(ConstraintTest, none)
     EXPECT_EQ(Constraint({ "", "" }), Constraint::none(2));
 }
 
+TEST_F(ConstraintTest, operator_and)
+{
+    Alphabet::set("ABC");
+
+    const Constraint constraint_1({  "A", "BC" });
+    const Constraint constraint_2({ "AB",  "A" });
+
+    EXPECT_EQ(Constraint({ "A", "" }), constraint_1 & constraint_2);
+}
+
 TEST_F(ConstraintTest, operator_or)
 {
     Alphabet::set("ABC");
@@ -154,6 +164,15 @@ TEST_F(ConstraintTest, is_possible)
     EXPECT_TRUE(Constraint({ "A", "" }).is_impossible());
 }
 
+TEST_F(ConstraintTest, is_satisfied_by)
+{
+    Alphabet::set("ABC");
+
+    const Constraint constraint({ "AB", "A", "AC" });
+    EXPECT_TRUE(constraint.is_satisfied_by("BAC"));
+    EXPECT_FALSE(constraint.is_satisfied_by("BAB"));
+}
+
 TEST_F(ConstraintTest, is_tighter_than_or_equal_to)
 {
     Alphabet::set("ABC");
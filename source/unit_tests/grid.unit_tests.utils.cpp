@@ -33,6 +33,7 @@
 #include "logger.hpp"
 #include "rectangular_grid.hpp"
 #include "regex_optimizations.hpp"
+#include "search_options.hpp"
 
 #include <algorithm>
 
@@ -127,7 +128,8 @@ solve_and_check(const string&                 grid_contents,
                 const vector<vector<string>>& expected_solutions,
                 const string&                 log_filepath,
                 bool                          optimize,
-                bool                          find_all_solutions)
+                bool                          find_all_solutions,
+                const SearchOptions&          options)
 {
     static_cast<void>(log_filepath);
 
@@ -141,7 +143,7 @@ solve_and_check(const string&                 grid_contents,
 
     const auto num_solutions_to_find =
         find_all_solutions ? numeric_limits<unsigned int>::max() : 1;
-    const auto solutions = grid->solve(num_solutions_to_find);
+    const auto solutions = grid->solve(num_solutions_to_find, options);
 
     if (find_all_solutions)
     {
@@ -168,19 +170,66 @@ solve_and_check(const string&                 grid_contents,
                 const string&                 log_filepath,
                 bool                          optimize)
 {
+    // All the solutions are found whichever way the search branches,
+    // and whichever order it explores the branches in, but the first
+    // solution found depends on them.
     bool find_all_solutions = true;
-    solve_and_check(grid_contents,
-                    expected_solutions,
-                    log_filepath,
-                    optimize,
-                    find_all_solutions);
+    SearchOptions options;
+
+    for (const auto branching : { SearchOptions::Branching::CHARACTERS,
+                                  SearchOptions::Branching::HALVES })
+    {
+        for (const auto branches_on_lines : { false, true })
+        {
+            options.set_branching(branching);
+            options.set_branches_on_lines(branches_on_lines);
+            solve_and_check(grid_contents,
+                            expected_solutions,
+                            log_filepath,
+                            optimize,
+                            find_all_solutions,
+                            options);
+        }
+    }
+
+    options = SearchOptions();
+
+    for (const auto strategy :
+           { SearchOptions::Strategy::LIMITED_DISCREPANCY,
+             SearchOptions::Strategy::GEOMETRIC_RESTARTS,
+             SearchOptions::Strategy::LUBY_RESTARTS })
+    {
+        options.set_strategy(strategy);
+        solve_and_check(grid_contents,
+                        expected_solutions,
+                        log_filepath,
+                        optimize,
+                        find_all_solutions,
+                        options);
+    }
+
+    // Constraining the lines in rounds, with several threads, reaches
+    // the same fixpoint as constraining them one at a time. Logging is
+    // not thread-safe.
+    if (log_filepath.empty())
+    {
+        options = SearchOptions();
+        options.set_num_threads(4);
+        solve_and_check(grid_contents,
+                        expected_solutions,
+                        log_filepath,
+                        optimize,
+                        find_all_solutions,
+                        options);
+    }
 
     find_all_solutions = false;
     solve_and_check(grid_contents,
                     expected_solutions,
                     log_filepath,
                     optimize,
-                    find_all_solutions);
+                    find_all_solutions,
+                    SearchOptions());
 }
 
 void
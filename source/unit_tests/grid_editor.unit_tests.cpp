@@ -0,0 +1,179 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "disable_warnings_from_gtest.hpp"
+#include "grid.hpp"
+#include "grid.unit_tests.utils.hpp"
+#include "grid_editor.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "set_of_characters.hpp"
+#include "utils.hpp"
+
+#include <memory>
+
+using namespace std;
+
+
+class GridEditorTest : public RegexCrosswordSolverTest
+{
+};
+
+
+namespace
+{
+
+// A grid whose two cells contain different characters.
+unique_ptr<GridEditor>
+make_editor()
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 1\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'AB|BA'\n"
+
+                               "'[AB]'\n"
+                               "'[AB]'\n");
+    return Utils::make_unique<GridEditor>(
+             GridUnitTestsUtils::read_grid(grid_contents));
+}
+
+} // unnamed namespace
+
+
+TEST_F(GridEditorTest, constructor)
+{
+    const auto editor = make_editor();
+
+    EXPECT_TRUE(editor->is_consistent());
+    EXPECT_FALSE(editor->is_solved());
+    EXPECT_EQ(SetOfCharacters("AB"), editor->possible_characters({ 0, 0 }));
+    EXPECT_EQ(SetOfCharacters("AB"), editor->possible_characters({ 0, 1 }));
+}
+
+TEST_F(GridEditorTest, assign)
+{
+    auto editor = make_editor();
+
+    EXPECT_TRUE(editor->assign({ 0, 0 }, 'A'));
+    EXPECT_TRUE(editor->is_solved());
+    EXPECT_EQ(SetOfCharacters('B'), editor->possible_characters({ 0, 1 }));
+
+    const vector<vector<size_t>> expected_changed_cells = { { 0, 0 },
+                                                            { 0, 1 } };
+    EXPECT_EQ(expected_changed_cells, editor->changed_cells());
+}
+
+TEST_F(GridEditorTest, assign_contradiction)
+{
+    auto editor = make_editor();
+
+    EXPECT_TRUE(editor->assign({ 0, 0 }, 'A'));
+    EXPECT_FALSE(editor->assign({ 0, 1 }, 'A'));
+    EXPECT_FALSE(editor->is_consistent());
+    EXPECT_FALSE(editor->is_solved());
+    EXPECT_TRUE(editor->changed_cells().empty());
+}
+
+TEST_F(GridEditorTest, assign_character_not_in_alphabet)
+{
+    auto editor = make_editor();
+
+    EXPECT_FALSE(editor->assign({ 0, 0 }, 'Z'));
+    EXPECT_TRUE(editor->retract({ 0, 0 }));
+}
+
+TEST_F(GridEditorTest, assign_same_character_again)
+{
+    auto editor = make_editor();
+
+    EXPECT_TRUE(editor->assign({ 0, 0 }, 'A'));
+    EXPECT_TRUE(editor->assign({ 0, 0 }, 'A'));
+    EXPECT_TRUE(editor->changed_cells().empty());
+}
+
+TEST_F(GridEditorTest, reassign)
+{
+    auto editor = make_editor();
+
+    EXPECT_TRUE(editor->assign({ 0, 0 }, 'A'));
+    EXPECT_TRUE(editor->assign({ 0, 0 }, 'B'));
+    EXPECT_EQ(SetOfCharacters('B'), editor->possible_characters({ 0, 0 }));
+    EXPECT_EQ(SetOfCharacters('A'), editor->possible_characters({ 0, 1 }));
+}
+
+TEST_F(GridEditorTest, retract)
+{
+    auto editor = make_editor();
+
+    EXPECT_TRUE(editor->assign({ 0, 0 }, 'A'));
+    EXPECT_FALSE(editor->assign({ 0, 1 }, 'A'));
+
+    EXPECT_TRUE(editor->retract({ 0, 1 }));
+    EXPECT_TRUE(editor->is_solved());
+    EXPECT_EQ(SetOfCharacters('B'), editor->possible_characters({ 0, 1 }));
+
+    EXPECT_TRUE(editor->retract({ 0, 0 }));
+    EXPECT_FALSE(editor->is_solved());
+    EXPECT_EQ(SetOfCharacters("AB"), editor->possible_characters({ 0, 0 }));
+    EXPECT_EQ(SetOfCharacters("AB"), editor->possible_characters({ 0, 1 }));
+
+    const vector<vector<size_t>> expected_changed_cells = { { 0, 0 },
+                                                            { 0, 1 } };
+    EXPECT_EQ(expected_changed_cells, editor->changed_cells());
+}
+
+TEST_F(GridEditorTest, retract_unassigned_cell)
+{
+    auto editor = make_editor();
+
+    EXPECT_TRUE(editor->retract({ 0, 0 }));
+    EXPECT_TRUE(editor->changed_cells().empty());
+}
+
+TEST_F(GridEditorTest, inconsistent_root)
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 1\n"
+                               "num_cols = 1\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'A'\n"
+
+                               "'B'\n");
+    GridEditor editor(GridUnitTestsUtils::read_grid(grid_contents));
+
+    EXPECT_FALSE(editor.is_consistent());
+    EXPECT_FALSE(editor.assign({ 0, 0 }, 'A'));
+    EXPECT_FALSE(editor.retract({ 0, 0 }));
+}
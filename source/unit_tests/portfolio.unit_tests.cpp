@@ -0,0 +1,161 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "disable_warnings_from_gtest.hpp"
+#include "grid.hpp"
+#include "grid.unit_tests.utils.hpp"
+#include "portfolio.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "utils.hpp"
+
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+
+class PortfolioTest : public RegexCrosswordSolverTest
+{
+};
+
+
+namespace
+{
+
+// derived from
+// http://regexcrossword.com/challenges/intermediate/puzzles/1
+const string g_grid_contents("shape = rectangular\n"
+
+                             "num_rows = 2\n"
+                             "num_cols = 3\n"
+
+                             "num_regexes_per_row = 1\n"
+                             "num_regexes_per_col = 1\n"
+
+                             "'[NOTADB]*'\n"
+                             "'WEL|BAL|EAR'\n"
+
+                             "'UB|IE|AW'\n"
+                             "'[TUBE]*'\n"
+                             "'[BORF].'\n");
+
+// Return a portfolio of 'num_workers' workers, diversified from the
+// default configuration, which solves 'g_grid_contents'.
+unique_ptr<Portfolio>
+make_portfolio(size_t num_workers)
+{
+    const Portfolio::Configuration base_configuration =
+        { RegexOptimizations::all(), SearchOptions() };
+    const auto configurations =
+        Portfolio::configurations(base_configuration, num_workers);
+
+    vector<unique_ptr<Grid>> grids;
+
+    for (const auto& configuration : configurations)
+    {
+        auto grid = GridUnitTestsUtils::read_grid(g_grid_contents);
+        grid->optimize(configuration.optimizations);
+        grids.push_back(move(grid));
+    }
+
+    return Utils::make_unique<Portfolio>(configurations, move(grids));
+}
+
+} // unnamed namespace
+
+
+TEST_F(PortfolioTest, configurations)
+{
+    using ROT = RegexOptimizations::Type;
+    using SOS = SearchOptions::Strategy;
+
+    SearchOptions options;
+    options.set_strategy(SOS::LIMITED_DISCREPANCY);
+    options.set_seed(10);
+    const Portfolio::Configuration base_configuration =
+        { RegexOptimizations::all(), options };
+
+    const auto configurations =
+        Portfolio::configurations(base_configuration, 17);
+    ASSERT_EQ(17, configurations.size());
+
+    // The first configuration is the base configuration.
+    const auto& first_options = configurations[0].search_options;
+    EXPECT_EQ(SOS::LIMITED_DISCREPANCY, first_options.strategy());
+    EXPECT_EQ(SearchOptions::Branching::CHARACTERS,
+              first_options.branching());
+    EXPECT_FALSE(first_options.branches_on_lines());
+    EXPECT_EQ(10u, first_options.seed());
+    EXPECT_TRUE(configurations[0].optimizations.is_enabled(ROT::GROUPS));
+
+    // The strategies cycle from that of the base configuration.
+    EXPECT_EQ(SOS::GEOMETRIC_RESTARTS,
+              configurations[1].search_options.strategy());
+    EXPECT_EQ(SOS::DEPTH_FIRST, configurations[2].search_options.strategy());
+    EXPECT_EQ(SOS::LUBY_RESTARTS,
+              configurations[3].search_options.strategy());
+    EXPECT_EQ(SOS::LIMITED_DISCREPANCY,
+              configurations[4].search_options.strategy());
+
+    // Each configuration has its own seed.
+    EXPECT_EQ(13u, configurations[3].search_options.seed());
+
+    // Then the optimizations, the branching, and the branching on lines
+    // are toggled.
+    EXPECT_TRUE(configurations[3].optimizations.is_enabled(ROT::GROUPS));
+    EXPECT_FALSE(configurations[4].optimizations.is_enabled(ROT::GROUPS));
+    EXPECT_EQ(SearchOptions::Branching::CHARACTERS,
+              configurations[7].search_options.branching());
+    EXPECT_EQ(SearchOptions::Branching::HALVES,
+              configurations[8].search_options.branching());
+    EXPECT_FALSE(configurations[15].search_options.branches_on_lines());
+    EXPECT_TRUE(configurations[16].search_options.branches_on_lines());
+}
+
+TEST_F(PortfolioTest, solve_with_one_worker)
+{
+    const auto portfolio = make_portfolio(1);
+
+    const auto solutions =
+        portfolio->solve(numeric_limits<unsigned int>::max());
+
+    EXPECT_EQ(4, solutions.size());
+    EXPECT_EQ(0, portfolio->winning_worker());
+}
+
+TEST_F(PortfolioTest, solve_with_several_workers)
+{
+    // Whichever worker finishes first, it finds all the solutions.
+    const auto portfolio = make_portfolio(6);
+
+    const auto solutions =
+        portfolio->solve(numeric_limits<unsigned int>::max());
+
+    EXPECT_EQ(4, solutions.size());
+    EXPECT_GT(6, portfolio->winning_worker());
+    EXPECT_FALSE(
+      portfolio->winning_grid().print_search_statistics().empty());
+}
@@ -26,9 +26,18 @@
 
 #include "disable_warnings_from_gtest.hpp"
 #include "grid.unit_tests.utils.hpp"
+#include "grid_cell.hpp"
+#include "grid_line.hpp"
 #include "rectangular_grid.hpp"
 #include "regex_crossword_solver_exception.hpp"
 #include "regex_crossword_solver_test.hpp"
+#include "search_options.hpp"
+#include "set_of_characters.hpp"
+#include "utils.hpp"
+
+#include <atomic>
+#include <limits>
+#include <unordered_set>
 
 using namespace std;
 
@@ -65,6 +74,79 @@ TEST_F(RectangularGridTest, constructor)
     EXPECT_EQ(3, grid->num_cols());
 }
 
+TEST_F(RectangularGridTest, cells_are_initialized_with_profiles)
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 2\n"
+                               "num_cols = 3\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'A[BC]*'\n"
+                               "'ABCD'\n"
+
+                               "'.*'\n"
+                               "'[AB]C|CD'\n"
+                               "'[CD]D'\n");
+    auto generic_grid = GridUnitTestsUtils::read_grid(grid_contents);
+    const auto grid =
+        GridUnitTestsUtils::downcast_grid<RectangularGrid>(move(generic_grid));
+
+    // Row 1 matches no string of 3 characters, so it narrows nothing:
+    // narrowing would leave its cells without possible characters.
+    const auto row_0 = grid->row_at(0);
+    EXPECT_EQ(SetOfCharacters("A"), row_0->cell(0)->possible_characters());
+    EXPECT_EQ(SetOfCharacters("BC"), row_0->cell(1)->possible_characters());
+    EXPECT_EQ(SetOfCharacters("C"), row_0->cell(2)->possible_characters());
+
+    const auto row_1 = grid->row_at(1);
+    EXPECT_EQ(SetOfCharacters("ABCD"), row_1->cell(0)->possible_characters());
+    EXPECT_EQ(SetOfCharacters("CD"), row_1->cell(1)->possible_characters());
+    EXPECT_EQ(SetOfCharacters("D"), row_1->cell(2)->possible_characters());
+}
+
+TEST_F(RectangularGridTest, hash)
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 2\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'.*'\n"
+                               "'[AB]*'\n"
+
+                               "'.*'\n"
+                               "'.*'\n");
+    auto generic_grid = GridUnitTestsUtils::read_grid(grid_contents);
+    const auto grid =
+        GridUnitTestsUtils::downcast_grid<RectangularGrid>(move(generic_grid));
+
+    const auto row_0 = grid->row_at(0);
+    const auto row_1 = grid->row_at(1);
+    const auto hash = grid->hash();
+    const auto row_0_hash = row_0->hash();
+
+    EXPECT_EQ(hash, row_0_hash ^ row_1->hash());
+
+    // The hashes of the grid and of the lines of a cell follow the
+    // changes of its possible characters.
+    const auto cell = row_0->cell(1);
+    const auto possible_characters = cell->possible_characters();
+    cell->set_possible_characters('A');
+    EXPECT_NE(hash, grid->hash());
+    EXPECT_NE(row_0_hash, row_0->hash());
+    EXPECT_EQ(grid->hash(), row_0->hash() ^ row_1->hash());
+
+    cell->set_possible_characters(possible_characters);
+    EXPECT_EQ(hash, grid->hash());
+    EXPECT_EQ(row_0_hash, row_0->hash());
+}
+
 TEST_F(RectangularGridTest, solve_1_solution)
 {
     // http://regexcrossword.com/challenges/intermediate/puzzles/1
@@ -139,6 +221,196 @@ TEST_F(RectangularGridTest, solve_4_solutions)
     GridUnitTestsUtils::solve_and_check(grid_contents, expected_solutions);
 }
 
+TEST_F(RectangularGridTest, solve_independent_components)
+{
+    // After constraining, the unsolved cells are (0, 1) and (1, 0),
+    // which share no line, so they are searched separately.
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 2\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'A[AB]'\n"
+                               "'[AB]A'\n"
+
+                               "'A[AB]'\n"
+                               "'[AB]A'\n");
+    const vector<vector<string>> expected_solutions({ { "AA", "AA" },
+                                                      { "AA", "BA" },
+                                                      { "AB", "AA" },
+                                                      { "AB", "BA" } });
+
+    GridUnitTestsUtils::solve_and_check(grid_contents, expected_solutions);
+}
+
+// Solve a generated grid whose lines are much longer than those of the
+// usual puzzles, with large repetition counts.
+TEST_F(RectangularGridTest, solve_long_lines)
+{
+    const size_t num_cols = 60;
+    const size_t half_num_cols = num_cols / 2;
+
+    string row_2;
+
+    while (row_2.size() != num_cols)
+    {
+        row_2 += "ABC";
+    }
+
+    const auto row_1 = string(half_num_cols, 'A') + string(half_num_cols, 'B');
+
+    string grid_contents("shape = rectangular\n"
+
+                         "num_rows = 3\n"
+                         "num_cols = " + to_string(num_cols) + "\n"
+
+                         "num_regexes_per_row = 1\n"
+                         "num_regexes_per_col = 1\n"
+
+                         "'A{" + to_string(half_num_cols) + "}B+'\n"
+                         "'(?:AB|C)*'\n"
+                         "'(.{" + to_string(half_num_cols) + "})\\1'\n");
+
+    // The third row is only constrained by its columns on its second
+    // half. Its backreference constrains its first half.
+    for (size_t i = 0; i != num_cols; ++i)
+    {
+        const auto row_3_characters = (i < half_num_cols)              ?
+                                      string("[ABC]")                  :
+                                      Utils::char_to_string(row_2[i]);
+        grid_contents += "'[AB]" + Utils::char_to_string(row_2[i]) +
+                         row_3_characters + "'\n";
+    }
+
+    const vector<vector<string>> expected_solutions({ { row_1,
+                                                        row_2,
+                                                        row_2 } });
+
+    GridUnitTestsUtils::solve_and_check(grid_contents, expected_solutions);
+}
+
+// Solve a grid whose search tree is too large for the first runs of the
+// restarts, so that the later runs reach again solutions which the
+// earlier runs already reported.
+TEST_F(RectangularGridTest, solve_with_restarts)
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 3\n"
+                               "num_cols = 3\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'[AB]*'\n"
+                               "'[AB]*'\n"
+                               "'[AB]*'\n"
+
+                               "'[AB]*'\n"
+                               "'[AB]*'\n"
+                               "'[AB]*'\n");
+    SearchOptions options;
+
+    for (const auto strategy : { SearchOptions::Strategy::GEOMETRIC_RESTARTS,
+                                 SearchOptions::Strategy::LUBY_RESTARTS })
+    {
+        options.set_strategy(strategy);
+
+        const auto grid = GridUnitTestsUtils::read_grid(grid_contents);
+        const auto solutions =
+            grid->solve(numeric_limits<unsigned int>::max(), options);
+
+        unordered_set<uint64_t> solution_hashes;
+
+        for (const auto& solution : solutions)
+        {
+            solution_hashes.insert(solution->hash());
+        }
+
+        EXPECT_EQ(512, solutions.size());
+        EXPECT_EQ(512, solution_hashes.size());
+        EXPECT_NE("runs                1", grid->print_search_statistics()[2]);
+    }
+}
+
+TEST_F(RectangularGridTest, solve_cancelled)
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 2\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'[AB]*'\n"
+                               "'[AB]*'\n"
+
+                               "'[AB]*'\n"
+                               "'[AB]*'\n");
+    const auto grid = GridUnitTestsUtils::read_grid(grid_contents);
+    const atomic<bool> is_cancelled(true);
+
+    const auto solutions = grid->solve(numeric_limits<unsigned int>::max(),
+                                       SearchOptions(),
+                                       &is_cancelled);
+
+    EXPECT_TRUE(solutions.empty());
+}
+
+TEST_F(RectangularGridTest, estimate_search_cost)
+{
+    // Each cell has two branches, and searching the first one leaves
+    // the second one with two branches, so that every probe follows a
+    // path of a search tree of 1 + 2 + 2 * 2 nodes.
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 1\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'[AB]*'\n"
+
+                               "'[AB]'\n"
+                               "'[AB]'\n");
+    const auto grid = GridUnitTestsUtils::read_grid(grid_contents);
+
+    const auto estimate = grid->estimate_search_cost(1.0);
+
+    EXPECT_LE(2, estimate.num_probes());
+    EXPECT_DOUBLE_EQ(7.0, estimate.num_nodes());
+    EXPECT_DOUBLE_EQ(7.0, estimate.min_num_nodes());
+    EXPECT_DOUBLE_EQ(7.0, estimate.max_num_nodes());
+}
+
+TEST_F(RectangularGridTest, estimate_search_cost_without_search)
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 1\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'AB'\n"
+
+                               "'[AB]'\n"
+                               "'[AB]'\n");
+    const auto grid = GridUnitTestsUtils::read_grid(grid_contents);
+
+    const auto estimate = grid->estimate_search_cost(1.0);
+
+    EXPECT_EQ(1, estimate.num_probes());
+    EXPECT_DOUBLE_EQ(1.0, estimate.num_nodes());
+    EXPECT_DOUBLE_EQ(1.0, estimate.max_num_nodes());
+}
+
 TEST_F(RectangularGridTest, invalid_num_regexes)
 {
     const string grid_contents("shape = rectangular\n"
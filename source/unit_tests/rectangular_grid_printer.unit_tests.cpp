@@ -73,6 +73,14 @@ TEST_F(RectangularGridPrinterTest, print)
     characters -= 'E';
     row_1->cell(2)->set_possible_characters(characters);
 
+    // The cells of row 2 were narrowed with the profiles of the regexes
+    // when the grid was created.
+    auto row_2 = grid.row_at(2);
+    for (size_t i = 0; i != num_cols; ++i)
+    {
+        row_2->cell(i)->set_possible_characters(Alphabet::characters());
+    }
+
     const auto verbose = true;
     const auto grid_lines = RectangularGridPrinter::print(grid, verbose);
     const auto grid_string = accumulate(grid_lines.cbegin(),
@@ -1690,6 +1690,33 @@ TEST_F(RegexConstrainTest, word_boundaries_14)
     check_constraints(*regex, constraint, 0, {});
 }
 
+// '\b' is known to be impossible as soon as it is rewound, when the
+// constraint allows only word characters around it.
+TEST_F(RegexConstrainTest, word_boundaries_15)
+{
+    const auto regex = Regex::parse(R"([AB]\b[AB=&])");
+
+    Alphabet::set("AB=&");
+
+    check_constraints(*regex, Constraint({ "AB", "AB" }), 0, {});
+    check_constraints(*regex, Constraint({ "AB", "AB=" }), 0,
+                      { Constraint({ "AB", "=" }) });
+}
+
+// '\B' is known to be impossible as soon as it is rewound, when the
+// constraint allows only word characters on one side of it and only
+// non-word characters on the other side.
+TEST_F(RegexConstrainTest, word_boundaries_16)
+{
+    const auto regex = Regex::parse(R"(.\B.)");
+
+    Alphabet::set("AB=&");
+
+    check_constraints(*regex, Constraint({ "=&", "AB" }), 0, {});
+    check_constraints(*regex, Constraint({ "=&", "AB&" }), 0,
+                      { Constraint({ "=&", "&" }) });
+}
+
 TEST_F(RegexConstrainTest, positive_lookahead_1)
 {
     const auto regex = Regex::parse("(?=A)");
@@ -1755,6 +1782,45 @@ TEST_F(RegexConstrainTest, positive_lookahead_4)
     }
 }
 
+// A lookahead whose regex constrains each position independently (the
+// first regex of each pair) reuses the constraints which its regex
+// allows from each begin position. It must constrain as the same
+// lookahead does when its regex contains a lookahead (the second
+// regex of each pair), which is enumerated each time.
+TEST_F(RegexConstrainTest, positive_lookahead_5)
+{
+    Alphabet::set("ABC");
+
+    const vector<pair<string, string>> regex_pairs =
+        { { "(?=AB|BC).*",
+            "(?=(?:AB|BC)(?=.*)).*" },
+          { "(?:A|B)(?=A|CC)(?:A|B|C)*",
+            "(?:A|B)(?=(?:A|CC)(?=.*))(?:A|B|C)*" },
+          { R"((AB|BA)(?=A.|B[BC])(..)\2)",
+            R"((AB|BA)(?=(?:A.|B[BC])(?=.*))(..)\2)" },
+          { "(?:(?=[AB]C)..|C)+",
+            "(?:(?=[AB]C(?=.*))..|C)+" } };
+
+    const vector<Constraint> constraints =
+        { Constraint::all(6),
+          Constraint({ "A",  "AB", "ABC", "C",  "ABC", "BC" }),
+          Constraint({ "AB", "B",  "AC",  "BC", "A",   "AB" }),
+          Constraint({ "BC", "AC", "C",   "AB", "AB",  "C"  }) };
+
+    for (const auto& regex_pair : regex_pairs)
+    {
+        const auto regex = Regex::parse(regex_pair.first);
+        const auto uncached_regex = Regex::parse(regex_pair.second);
+
+        for (const auto& constraint : constraints)
+        {
+            EXPECT_EQ(uncached_regex->constrain(constraint),
+                      regex->constrain(constraint))
+              << regex_pair.first;
+        }
+    }
+}
+
 TEST_F(RegexConstrainTest, other_1)
 {
     // This regex generates the following constraints of length 3:
@@ -1792,3 +1858,26 @@ TEST_F(RegexConstrainTest, other_2)
     // When ORing the possible constraints above, we get:
     EXPECT_EQ(Constraint({ "AB", "B", "ABCD" }), updated_constraint);
 }
+
+TEST_F(RegexConstrainTest, supports)
+{
+    const auto regex = Regex::parse("([AB]|BC)*D*");
+
+    set_alphabet(*regex);
+
+    // See other_2: each of the possible constraints adds characters to
+    // the ones before it (the values of '([AB]|BC)*' of length 2 come
+    // before those of length 3).
+    const Constraint constraint({ "ABCD", "B", "ABCD" });
+
+    vector<Constraint> supports;
+    const auto updated_constraint = regex->constrain(constraint, supports);
+
+    EXPECT_EQ(Constraint({ "AB", "B", "ABCD" }), updated_constraint);
+
+    const vector<Constraint> expected_supports =
+        { Constraint({ "AB", "B", "D" }),
+          Constraint({ "AB", "B", "AB" }),
+          Constraint({ "AB", "B", "C" }) };
+    EXPECT_EQ(expected_supports, supports);
+}
@@ -25,6 +25,7 @@
 
 
 #include "alphabet.hpp"
+#include "constraint.hpp"
 #include "disable_warnings_from_gtest.hpp"
 #include "regex.hpp"
 #include "regex_crossword_solver_test.hpp"
@@ -182,3 +183,255 @@ TEST_F(RegexTest, optimize_unions)
         EXPECT_EQ(optimized_regex_as_string, regex->to_string());
     }
 }
+
+TEST_F(RegexTest, optimize_repetitions)
+{
+    // for each pair of strings:
+    // * first  = non optimized regex
+    // * second = optimized regex
+    const vector<pair<string, string>> regex_pairs =
+        { { R"(A)",        R"(A)"       },
+          { R"(A*A*)",     R"(A*)"      },
+          { R"(.*.*)",     R"(.*)"      },
+          { R"(.*.)",      R"(.+)"      },
+          { R"(A+A)",      R"(A{2,})"   },
+          { R"(A?A?)",     R"(A{0,2})"  },
+          { R"(AA?B)",     R"(A{1,2}B)" },
+          { R"(A*B*)",     R"(A*B*)"    },
+          { R"(A*\.*)",    R"(A*.*)"    },
+          { R"(.*\.*)",    R"(.*.*)"    },
+          { R"((A*A*)*)",  R"(A**)"     },
+          { R"((A)*A*)",   R"(A*)"      },
+          { R"((A)*A*\1)", R"((A)*A*\1)"} };
+
+    for (const auto& regex_pair : regex_pairs)
+    {
+        const auto& non_optimized_regex_as_string = regex_pair.first;
+        const auto& optimized_regex_as_string     = regex_pair.second;
+
+        auto regex = Regex::parse(non_optimized_regex_as_string);
+
+        auto optimizations = RegexOptimizations::none();
+        optimizations.set(RegexOptimizations::Type::GROUPS, true);
+        optimizations.set(RegexOptimizations::Type::REPETITIONS, true);
+        regex = Regex::optimize(move(regex), optimizations);
+
+        EXPECT_EQ(optimized_regex_as_string, regex->to_string());
+    }
+}
+
+TEST_F(RegexTest, optimize_factorizations)
+{
+    // for each pair of strings:
+    // * first  = non optimized regex
+    // * second = optimized regex
+    const vector<pair<string, string>> regex_pairs =
+        { { R"(A)",          R"(A)"             },
+          { R"(A|B)",        R"(A|B)"           },
+          { R"(AB|AC)",      R"(A(?:B|C))"      },
+          { R"(AB|AC|AD)",   R"(A(?:B|C|D))"    },
+          { R"(AB|A)",       R"(A(?:B|))"       },
+          { R"(BA|CA)",      R"((?:B|C)A)"      },
+          { R"(A|A)",        R"(A)"             },
+          { R"(ABC|ABD)",    R"(AB(?:C|D))"     },
+          { R"((AB|AC)*)",   R"((A(?:B|C))*)"   },
+          { R"(.B|\.C)",     R"(.B|.C)"         },
+          { R"((A)B|(A)C)",  R"((A)B|(A)C)"     } };
+
+    for (const auto& regex_pair : regex_pairs)
+    {
+        const auto& non_optimized_regex_as_string = regex_pair.first;
+        const auto& optimized_regex_as_string     = regex_pair.second;
+
+        auto regex = Regex::parse(non_optimized_regex_as_string);
+
+        const auto optimizations =
+            RegexOptimizations::only(RegexOptimizations::Type::FACTORIZATIONS);
+        regex = Regex::optimize(move(regex), optimizations);
+
+        EXPECT_EQ(optimized_regex_as_string, regex->to_string());
+    }
+}
+
+TEST_F(RegexTest, optimize_all)
+{
+    // for each pair of strings:
+    // * first  = non optimized regex
+    // * second = optimized regex
+    const vector<pair<string, string>> regex_pairs =
+        { { R"(AB|AC)",       R"(A(?:{BC}))"        },
+          { R"((AB|AC)*D)",   R"(A(?:{BC})*D)"      },
+          { R"(X*X?X+)",      R"(X+)"               },
+          { R"(ABC|ABD)",     R"("AB"(?:{CD}))"     } };
+
+    for (const auto& regex_pair : regex_pairs)
+    {
+        const auto& non_optimized_regex_as_string = regex_pair.first;
+        const auto& optimized_regex_as_string     = regex_pair.second;
+
+        auto regex = Regex::parse(non_optimized_regex_as_string);
+        regex = Regex::optimize(move(regex), RegexOptimizations::all());
+
+        EXPECT_EQ(optimized_regex_as_string, regex->to_string());
+    }
+}
+
+TEST_F(RegexTest, specialize)
+{
+    Alphabet::set("ABCDE");
+
+    // for each pair of strings:
+    // * first  = non specialized regex
+    // * second = regex specialized for 3 characters
+    const vector<pair<string, string>> regex_pairs =
+        { { R"(A)",          R"(A)"             },
+          { R"(A*)",         R"(A{0,3})"        },
+          { R"(A+B)",        R"(A{1,3}B)"       },
+          { R"(A{2,})",      R"(A{2,3})"        },
+          { R"(A{0,9})",     R"(A{0,3})"        },
+          { R"(A{5})",       R"(A{5})"          },
+          { R"((AB)*)",      R"((AB)?)"         },
+          { R"((?:A*)*)",    R"((?:A{0,3})*)"   },
+          { R"(A|BCDE)",     R"(A)"             },
+          { R"(BCDE|A*)",    R"(A{0,3})"        },
+          { R"((BCDE)|A)",   R"((BCDE)|A)"      },
+          { R"(A|BCDE|C)",   R"(A|C)"           } };
+
+    for (const auto& regex_pair : regex_pairs)
+    {
+        const auto& non_specialized_regex_as_string = regex_pair.first;
+        const auto& specialized_regex_as_string     = regex_pair.second;
+
+        auto regex = Regex::parse(non_specialized_regex_as_string);
+        const auto constraint = Constraint({ "AB", "ABC", "ABCDE" });
+        const auto expected_constraint = regex->constrain(constraint);
+
+        regex = Regex::specialize(move(regex), 3);
+
+        EXPECT_EQ(specialized_regex_as_string, regex->to_string());
+        EXPECT_EQ(expected_constraint, regex->constrain(constraint))
+          << non_specialized_regex_as_string;
+    }
+}
+
+// The repetitions of a character block, like '[AB]{2,40}', are compact
+// (they do not copy the character block for each repetition). Their
+// results must be those of the equivalent repetitions of a group.
+TEST_F(RegexTest, compact_repetitions)
+{
+    Alphabet::set("ABC");
+
+    // for each pair of strings:
+    // * first  = regex with a compact repetition
+    // * second = equivalent regex without compact repetitions
+    const vector<pair<string, string>> regex_pairs =
+        { { R"([AB]{2,40})",  R"((?:[AB]){2,40})"       },
+          { R"(A*B{3}C*)",    R"((?:A)*(?:B){3}(?:C)*)" },
+          { R"(([AB]{3})\1)", R"(((?:[AB]){3})\1)"      },
+          { R"((.*)C\1)",     R"(((?:.)*)C\1)"          },
+          { R"(([^C]+)\1*)",  R"(((?:[^C])+)\1*)"       } };
+
+    const vector<Constraint> constraints =
+        { Constraint({ "ABC", "ABC", "ABC", "ABC", "ABC", "ABC" }),
+          Constraint({ "A",   "AB",  "ABC", "C",   "ABC", "BC"  }),
+          Constraint({ "AB",  "B",   "AC",  "ABC", "A",   "AB"  }),
+          Constraint({ "AB",  "AB",  "AB",  "AB",  "AB",  "AB"  }) };
+
+    for (const auto& regex_pair : regex_pairs)
+    {
+        const auto compact_regex = Regex::parse(regex_pair.first);
+        const auto regex = Regex::parse(regex_pair.second);
+
+        for (const auto& constraint : constraints)
+        {
+            EXPECT_EQ(regex->constrain(constraint),
+                      compact_regex->constrain(constraint))
+              << regex_pair.first;
+        }
+    }
+}
+
+TEST_F(RegexTest, skip_union_alternatives)
+{
+    Alphabet::set("ABC");
+
+    // 'CA' and 'CC' cannot start with A or B: they are skipped
+    EXPECT_EQ(Constraint({ "AB", "BC" }),
+              Regex::parse("AB|CA|BC|CC")->constrain(
+                Constraint({ "AB", "ABC" })));
+
+    // only the group value 'CA' can start with C
+    EXPECT_EQ(Constraint({ "C", "A", "C", "A" }),
+              Regex::parse(R"((AB|CA|BC)\1)")->constrain(
+                Constraint({ "C", "ABC", "ABC", "ABC" })));
+
+    // alternatives which may be empty are never skipped
+    EXPECT_EQ(Constraint({ "C", "C" }),
+              Regex::parse("(?:A|B|)C(?:AB|BA|C)")->constrain(
+                Constraint({ "C", "C" })));
+
+    // alternatives are skipped at each repetition
+    EXPECT_EQ(Constraint({ "C", "A", "A", "B", "C", "A", "A", "B" }),
+              Regex::parse(R"(((?:AB|BC|CA)+)\1)")->constrain(
+                Constraint({ "C", "A", "A", "ABC", "C", "ABC", "ABC", "B" })));
+
+    EXPECT_EQ(2U,
+              Regex::parse("AB|CA|BC|CC")->constraints(
+                Constraint({ "ABC", "ABC", "AB", "BC" }), 2).size());
+}
+
+TEST_F(RegexTest, num_nodes)
+{
+    EXPECT_EQ(1U, Regex::parse("A")->num_nodes());
+    EXPECT_EQ(3U, Regex::parse("AB")->num_nodes());
+    EXPECT_EQ(2U, Regex::parse("A*")->num_nodes());
+    EXPECT_EQ(4U, Regex::parse("(A|B)")->num_nodes());
+    EXPECT_EQ(4U, Regex::parse("(?=A)B")->num_nodes());
+}
+
+TEST_F(RegexTest, num_enumeration_steps)
+{
+    // The values of 'A?A?' which fit in 2 characters are: '', 'A',
+    // 'A' (second 'A?'), and 'AA'. Those of 'A{0,2}' are: '', 'A' and
+    // 'AA'.
+    EXPECT_EQ(4U, Regex::parse("A?A?")->num_enumeration_steps(2));
+    EXPECT_EQ(3U, Regex::parse("A{0,2}")->num_enumeration_steps(2));
+}
+
+TEST_F(RegexTest, has_exact_values)
+{
+    Alphabet::set("ABC");
+
+    EXPECT_TRUE(Regex::parse("A")->has_exact_values());
+    EXPECT_TRUE(Regex::parse("[AB]C|C*")->has_exact_values());
+    EXPECT_TRUE(Regex::parse("(A|BC)+")->has_exact_values());
+    EXPECT_TRUE(Regex::parse("^(?:AB){2}$")->has_exact_values());
+
+    EXPECT_FALSE(Regex::parse("(.)\\1")->has_exact_values());
+    EXPECT_FALSE(Regex::parse("A(?=B).*")->has_exact_values());
+    EXPECT_FALSE(Regex::parse("(A\\b)*")->has_exact_values());
+    EXPECT_FALSE(Regex::parse("[AB]|A\\B")->has_exact_values());
+}
+
+TEST_F(RegexTest, is_universal)
+{
+    Alphabet::set("CRX");
+
+    EXPECT_TRUE(Regex::parse(".*")->is_universal(3));
+    EXPECT_TRUE(Regex::parse("(.)*")->is_universal(3));
+    EXPECT_TRUE(Regex::parse(".*.*")->is_universal(3));
+    EXPECT_TRUE(Regex::parse("[CRX]*")->is_universal(3));
+    EXPECT_TRUE(Regex::parse("([^X]|X)+")->is_universal(3));
+    EXPECT_TRUE(Regex::parse("(C|R|X)*")->is_universal(3));
+    EXPECT_TRUE(Regex::parse(".{3}")->is_universal(3));
+    EXPECT_TRUE(Regex::parse("..?.")->is_universal(3));
+    EXPECT_TRUE(Regex::parse("(..)*.")->is_universal(3));
+
+    EXPECT_FALSE(Regex::parse(".{3}")->is_universal(2));
+    EXPECT_FALSE(Regex::parse("(..)*")->is_universal(3));
+    EXPECT_FALSE(Regex::parse("[^X]*")->is_universal(3));
+    EXPECT_FALSE(Regex::parse(".*C.*")->is_universal(3));
+    EXPECT_FALSE(Regex::parse("(.)\\1.")->is_universal(3));
+    EXPECT_FALSE(Regex::parse("(?=C).*")->is_universal(3));
+    EXPECT_FALSE(Regex::parse("^.*$")->is_universal(3));
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "disable_warnings_from_gtest.hpp"
+#include "grid.hpp"
+#include "grid.unit_tests.utils.hpp"
+#include "regex_crossword_solver_exception.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "regex_editor.hpp"
+#include "regex_optimizations.hpp"
+#include "utils.hpp"
+
+#include <memory>
+
+using namespace std;
+
+
+class RegexEditorTest : public RegexCrosswordSolverTest
+{
+};
+
+
+namespace
+{
+
+// Line 0 is the first row, and line 2 the first column. The grid has
+// two solutions, with "AB" or "BB" on the first row.
+unique_ptr<RegexEditor>
+make_editor()
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 2\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'[AB]B'\n"
+                               "'CD'\n"
+
+                               "'[AB]C'\n"
+                               "'BD'\n");
+    return Utils::make_unique<RegexEditor>(
+             GridUnitTestsUtils::read_grid(grid_contents),
+             RegexOptimizations::all());
+}
+
+} // unnamed namespace
+
+
+TEST_F(RegexEditorTest, constructor)
+{
+    const auto editor = make_editor();
+
+    EXPECT_EQ(4, editor->num_lines());
+    EXPECT_EQ(1, editor->num_regexes(0));
+    EXPECT_EQ("[AB]B", editor->regex(0, 0));
+    EXPECT_EQ(2, editor->num_solutions());
+    EXPECT_FALSE(editor->has_unique_solution());
+}
+
+TEST_F(RegexEditorTest, replace_with_narrower_regex)
+{
+    auto editor = make_editor();
+
+    // "AB" matches no strings which "[AB]B" does not match, so that
+    // constraining starts from the root.
+    EXPECT_EQ(1, editor->replace_regex(0, 0, "AB"));
+    EXPECT_TRUE(editor->has_unique_solution());
+    EXPECT_EQ("AB", editor->regex(0, 0));
+    EXPECT_EQ("edits from root     1", editor->print_statistics()[1]);
+}
+
+TEST_F(RegexEditorTest, replace_with_wider_regex)
+{
+    auto editor = make_editor();
+
+    EXPECT_EQ(1, editor->replace_regex(0, 0, "AB"));
+    EXPECT_EQ(2, editor->replace_regex(0, 0, "(A|B)B"));
+    EXPECT_EQ(2, editor->replace_regex(1, 0, ".*"));
+
+    const auto statistics = editor->print_statistics();
+    EXPECT_EQ("edits               3", statistics[0]);
+    EXPECT_EQ("edits from root     1", statistics[1]);
+}
+
+TEST_F(RegexEditorTest, replace_without_solutions)
+{
+    auto editor = make_editor();
+
+    EXPECT_EQ(0, editor->replace_regex(2, 0, "CC"));
+    EXPECT_EQ(0, editor->replace_regex(0, 0, "AB"));
+    EXPECT_TRUE(editor->solutions().empty());
+}
+
+TEST_F(RegexEditorTest, replace_changing_alphabet)
+{
+    auto editor = make_editor();
+
+    EXPECT_EQ(0, editor->replace_regex(0, 0, "XB"));
+    EXPECT_EQ(1, editor->replace_regex(0, 0, "AB"));
+    EXPECT_EQ("alphabet changes    2", editor->print_statistics()[2]);
+}
+
+// ' ', which the new alphabet adds before 'A' and 'B', is the only
+// non-word character of the grid.
+TEST_F(RegexEditorTest, replace_changing_alphabet_with_non_word_character)
+{
+    const string grid_contents("shape = rectangular\n"
+
+                               "num_rows = 1\n"
+                               "num_cols = 2\n"
+
+                               "num_regexes_per_row = 1\n"
+                               "num_regexes_per_col = 1\n"
+
+                               "'AB'\n"
+
+                               "'A'\n"
+                               "'B'\n");
+    RegexEditor editor(GridUnitTestsUtils::read_grid(grid_contents),
+                       RegexOptimizations::all());
+
+    EXPECT_EQ(1, editor.replace_regex(2, 0, "[B ]"));
+    EXPECT_EQ(1, editor.replace_regex(0, 0, "A\\B."));
+}
+
+TEST_F(RegexEditorTest, replace_with_invalid_regex)
+{
+    auto editor = make_editor();
+
+    EXPECT_THROW(editor->replace_regex(0, 0, "(AB"), RegexParseException);
+    EXPECT_EQ("[AB]B", editor->regex(0, 0));
+    EXPECT_EQ(2, editor->num_solutions());
+    EXPECT_EQ("edits               0", editor->print_statistics()[0]);
+}
@@ -0,0 +1,146 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "alphabet.hpp"
+#include "constraint.hpp"
+#include "disable_warnings_from_gtest.hpp"
+#include "regex.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "regex_kernel.hpp"
+
+using namespace std;
+
+
+class RegexKernelTest : public RegexCrosswordSolverTest
+{
+};
+
+
+namespace
+{
+
+// Return the name of the kernel created for 'regex_as_string', or ""
+// if no kernel supports that regex.
+string
+kernel_name(const string& regex_as_string)
+{
+    const auto kernel = RegexKernel::create(*Regex::parse(regex_as_string));
+    return kernel ? kernel->name() : "";
+}
+
+// Return a pseudo-random constraint of 'size' elements, each of which
+// contains each character of the alphabet with probability 3/4.
+Constraint
+random_constraint(size_t size, unsigned int& seed)
+{
+    vector<SetOfCharacters> elements(size);
+
+    for (auto& element : elements)
+    {
+        for (const auto c : Alphabet::characters_as_string())
+        {
+            seed = seed * 1103515245 + 12345;
+
+            if ((seed >> 16) % 4 != 0)
+            {
+                element |= SetOfCharacters(c);
+            }
+        }
+    }
+
+    return Constraint(elements);
+}
+
+// Check that the kernel of 'regex_as_string' constrains lines exactly
+// like the regex itself.
+void
+check_kernel(const string& regex_as_string)
+{
+    const auto regex = Regex::parse(regex_as_string);
+    const auto kernel = RegexKernel::create(*regex);
+    ASSERT_TRUE(kernel != nullptr) << regex_as_string;
+
+    unsigned int seed = 1;
+
+    for (size_t size = 1; size <= 7; ++size)
+    {
+        for (int i = 0; i != 50; ++i)
+        {
+            const auto constraint = random_constraint(size, seed);
+            EXPECT_EQ(regex->constrain(constraint),
+                      kernel->constrain(constraint)) << regex_as_string;
+        }
+    }
+}
+
+} // unnamed namespace
+
+
+TEST_F(RegexKernelTest, create)
+{
+    EXPECT_EQ("class_star", kernel_name("[CR]*"));
+    EXPECT_EQ("class_star", kernel_name("(C|R)*"));
+    EXPECT_EQ("class_star", kernel_name(".*"));
+    EXPECT_EQ("class_star", kernel_name("(A|)*"));
+    EXPECT_EQ("alternation_star", kernel_name("(DI|NS|TH|OM)*"));
+    EXPECT_EQ("alternation_star", kernel_name("(RR|HHH)*"));
+    EXPECT_EQ("literal_sandwich", kernel_name(".*XEXM*"));
+    EXPECT_EQ("literal_sandwich", kernel_name("[^C]*MMM[^C]*"));
+    EXPECT_EQ("literal_sandwich", kernel_name("A[BC]D*"));
+    EXPECT_EQ("block_sequence", kernel_name("A+[BC]?D{2,3}"));
+    EXPECT_EQ("block_sequence", kernel_name("ABC"));
+    EXPECT_EQ("block_sequence", kernel_name("A*B*"));
+    EXPECT_EQ("block_sequence", kernel_name("(A|B)C*"));
+
+    EXPECT_EQ("", kernel_name("(.)\\1"));
+    EXPECT_EQ("", kernel_name("(?=A).*"));
+    EXPECT_EQ("", kernel_name("^A*$"));
+    EXPECT_EQ("", kernel_name("(AB)*C"));
+    EXPECT_EQ("", kernel_name("(AB)+"));
+}
+
+TEST_F(RegexKernelTest, constrain)
+{
+    Alphabet::set("ABCD");
+
+    check_kernel("[AB]*");
+    check_kernel("(A|C)*");
+    check_kernel(".*");
+    check_kernel("(AB|CD|BA)*");
+    check_kernel("(AA|BBB)*");
+    check_kernel("(A[BC]|D)*");
+    check_kernel(".*ABA*");
+    check_kernel("[^C]*CCC[^C]*");
+    check_kernel("AB.*");
+    check_kernel("[AB]*C");
+    check_kernel("(A|B)C*");
+    check_kernel("A+[BC]?D{2,3}");
+    check_kernel("A*B*C*");
+    check_kernel("A{2}.{0,2}B+");
+    check_kernel("(A|)B*C?");
+    check_kernel("ABC");
+    check_kernel("A{9}");
+}
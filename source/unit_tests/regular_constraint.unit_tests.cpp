@@ -0,0 +1,254 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "alphabet.hpp"
+#include "constraint.hpp"
+#include "disable_warnings_from_gtest.hpp"
+#include "regex.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "regular_constraint.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+
+class RegularConstraintTest : public RegexCrosswordSolverTest
+{
+};
+
+
+TEST_F(RegularConstraintTest, create)
+{
+    Alphabet::set("ABC");
+
+    EXPECT_NE(nullptr, RegularConstraint::create(*Regex::parse("A*B"), 3));
+    EXPECT_NE(nullptr, RegularConstraint::create(*Regex::parse("^A|B$"), 1));
+    EXPECT_NE(nullptr, RegularConstraint::create(*Regex::parse("(A|B){2,}"),
+                                                 3));
+
+    // The values of these regexes are not exact.
+    EXPECT_EQ(nullptr, RegularConstraint::create(*Regex::parse("(A)\\1"), 2));
+    EXPECT_EQ(nullptr, RegularConstraint::create(*Regex::parse("(?=A).*"),
+                                                 2));
+    EXPECT_EQ(nullptr, RegularConstraint::create(*Regex::parse("A\\bB"), 2));
+}
+
+TEST_F(RegularConstraintTest, constrain)
+{
+    Alphabet::set("ABC");
+
+    const auto regular_constraint = RegularConstraint::create(
+                                      *Regex::parse("AB|BA"), 2);
+    ASSERT_NE(nullptr, regular_constraint);
+
+    EXPECT_EQ(Constraint({ "AB", "AB" }),
+              regular_constraint->constrain(Constraint({ "ABC", "ABC" })));
+    EXPECT_EQ(Constraint({ "B", "A" }),
+              regular_constraint->constrain(Constraint({ "AB", "A" })));
+    EXPECT_TRUE(regular_constraint->constrain(Constraint({ "B", "" }))
+                  .is_impossible());
+
+    // A constraint which is not tighter than the previous one starts
+    // afresh.
+    EXPECT_EQ(Constraint({ "A", "B" }),
+              regular_constraint->constrain(Constraint({ "A", "ABC" })));
+}
+
+TEST_F(RegularConstraintTest, get_strings)
+{
+    Alphabet::set("ABC");
+
+    const auto regular_constraint = RegularConstraint::create(
+                                      *Regex::parse("A[BC]|C.|BA"), 2);
+    ASSERT_NE(nullptr, regular_constraint);
+
+    regular_constraint->constrain(Constraint({ "AB", "ABC" }));
+
+    vector<string> strings;
+    EXPECT_TRUE(regular_constraint->get_strings(strings, 3));
+    sort(strings.begin(), strings.end());
+    const vector<string> expected = { "AB", "AC", "BA" };
+    EXPECT_EQ(expected, strings);
+
+    // There are more than 2 strings.
+    EXPECT_FALSE(regular_constraint->get_strings(strings, 2));
+
+    EXPECT_TRUE(regular_constraint->constrain(Constraint({ "A", "A" }))
+                  .is_impossible());
+    EXPECT_TRUE(regular_constraint->get_strings(strings, 2));
+    EXPECT_TRUE(strings.empty());
+}
+
+TEST_F(RegularConstraintTest, constrain_anchors_and_repetitions)
+{
+    Alphabet::set("ABC");
+
+    struct TestData
+    {
+        string     regex;
+        Constraint constraint;
+        Constraint expected_result;
+    };
+
+    const TestData test_data[] =
+    {
+        { "A*B",
+          Constraint({ "ABC", "ABC", "ABC" }),
+          Constraint({ "A", "A", "B" }) },
+        { "(AB)*",
+          Constraint({ "ABC", "ABC", "ABC" }),
+          Constraint({ "", "", "" }) },
+        { "(A|BC)+",
+          Constraint({ "ABC", "ABC", "ABC" }),
+          Constraint({ "AB", "ABC", "AC" }) },
+        { "A{2}B?",
+          Constraint({ "ABC", "ABC", "ABC" }),
+          Constraint({ "A", "A", "B" }) },
+        { "A?B{1,2}",
+          Constraint({ "ABC", "ABC", "ABC" }),
+          Constraint({ "A", "B", "B" }) },
+        { "(A*)*C",
+          Constraint({ "ABC", "ABC", "ABC" }),
+          Constraint({ "A", "A", "C" }) },
+        { "^A|B$",
+          Constraint({ "ABC" }),
+          Constraint({ "AB" }) },
+        { "A^B",
+          Constraint({ "ABC", "ABC" }),
+          Constraint({ "", "" }) },
+        { "(^A|B)+",
+          Constraint({ "ABC", "ABC", "ABC" }),
+          Constraint({ "AB", "B", "B" }) },
+        { "[^A]C|.$",
+          Constraint({ "ABC", "ABC" }),
+          Constraint({ "BC", "C" }) },
+        { "A()B|CA",
+          Constraint({ "ABC", "ABC" }),
+          Constraint({ "AC", "AB" }) },
+    };
+
+    for (const auto& data : test_data)
+    {
+        const auto regular_constraint = RegularConstraint::create(
+                                          *Regex::parse(data.regex),
+                                          data.constraint.size());
+        ASSERT_NE(nullptr, regular_constraint) << data.regex;
+
+        EXPECT_EQ(data.expected_result,
+                  regular_constraint->constrain(data.constraint))
+            << data.regex;
+    }
+}
+
+TEST_F(RegularConstraintTest, constrain_copy)
+{
+    Alphabet::set("ABC");
+
+    const auto regular_constraint = RegularConstraint::create(
+                                      *Regex::parse("AB|BA|BB"), 2);
+    ASSERT_NE(nullptr, regular_constraint);
+    EXPECT_EQ(Constraint({ "AB", "AB" }),
+              regular_constraint->constrain(Constraint({ "ABC", "ABC" })));
+
+    auto copy = *regular_constraint;
+    EXPECT_EQ(Constraint({ "A", "B" }),
+              copy.constrain(Constraint({ "A", "ABC" })));
+
+    // Constraining the copy does not affect the original.
+    EXPECT_EQ(Constraint({ "B", "AB" }),
+              regular_constraint->constrain(Constraint({ "B", "AB" })));
+}
+
+TEST_F(RegularConstraintTest, constrain_same_as_regex)
+{
+    Alphabet::set("ABC");
+
+    const vector<string> regexes =
+    {
+        "(A|B)*C(A|C)*",
+        "(AB|C)*A?",
+        "[AB]{2,3}C*",
+        "(?:A|BC|CA)*|B+C",
+        "(A*B*)*C.",
+    };
+
+    const vector<Constraint> constraints =
+    {
+        Constraint({ "ABC", "ABC", "ABC", "ABC" }),
+        Constraint({ "ABC", "AB",  "ABC", "ABC" }),
+        Constraint({ "ABC", "AB",  "BC",  "ABC" }),
+        Constraint({ "AC",  "AB",  "BC",  "C"   }),
+        Constraint({ "A",   "AB",  "B",   "C"   }),
+    };
+
+    for (const auto& regex_as_string : regexes)
+    {
+        const auto regex = Regex::parse(regex_as_string);
+        const auto regular_constraint = RegularConstraint::create(*regex, 4);
+        ASSERT_NE(nullptr, regular_constraint) << regex_as_string;
+
+        // The constraints get tighter, so each one but the first is
+        // handled incrementally.
+        for (const auto& constraint : constraints)
+        {
+            EXPECT_EQ(regex->constrain(constraint),
+                      regular_constraint->constrain(constraint))
+                << regex_as_string;
+        }
+    }
+}
+
+TEST_F(RegularConstraintTest, constrain_several_regexes)
+{
+    Alphabet::set("ABC");
+
+    const auto regex_1 = Regex::parse("A.|B.|CC");
+    const auto regex_2 = Regex::parse(".A|CB|.C");
+
+    // Each regex alone is consistent with { "ABC", "ABC" }, but only
+    // "AA", "AC", "BA", "BC" and "CC" match both.
+    EXPECT_EQ(Constraint({ "ABC", "ABC" }),
+              regex_1->constrain(Constraint({ "ABC", "ABC" })));
+    EXPECT_EQ(Constraint({ "ABC", "ABC" }),
+              regex_2->constrain(Constraint({ "ABC", "ABC" })));
+
+    const auto regular_constraint = RegularConstraint::create(
+                                      { regex_1.get(), regex_2.get() }, 2);
+    ASSERT_NE(nullptr, regular_constraint);
+
+    EXPECT_EQ(Constraint({ "ABC", "AC" }),
+              regular_constraint->constrain(Constraint({ "ABC", "ABC" })));
+    EXPECT_EQ(Constraint({ "AB", "A" }),
+              regular_constraint->constrain(Constraint({ "ABC", "AB" })));
+    EXPECT_TRUE(regular_constraint->constrain(Constraint({ "C", "A" }))
+                  .is_impossible());
+
+    // One regex cannot be represented as an automaton.
+    const auto regex_3 = Regex::parse("(.)\\1");
+    EXPECT_EQ(nullptr,
+              RegularConstraint::create({ regex_1.get(), regex_3.get() }, 2));
+}
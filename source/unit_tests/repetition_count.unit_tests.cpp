@@ -36,6 +36,12 @@ class RepetitionCountTest : public RegexCrosswordSolverTest
 };
 
 
+TEST_F(RepetitionCountTest, count)
+{
+    EXPECT_EQ(0U, RepetitionCount(0).count());
+    EXPECT_EQ(3U, RepetitionCount(3).count());
+}
+
 TEST_F(RepetitionCountTest, is_not_infinite)
 {
     EXPECT_TRUE(RepetitionCount(0).is_not_infinite());
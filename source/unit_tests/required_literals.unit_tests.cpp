@@ -0,0 +1,184 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "alphabet.hpp"
+#include "constraint.hpp"
+#include "disable_warnings_from_gtest.hpp"
+#include "regex.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "required_literals.hpp"
+
+using namespace std;
+
+
+class RequiredLiteralsTest : public RegexCrosswordSolverTest
+{
+};
+
+
+namespace
+{
+
+// Return the required literals of 'regex_as_string', each literal
+// being represented by the characters of its elements, between
+// brackets.
+vector<string>
+literals_as_strings(const string& regex_as_string)
+{
+    const auto required_literals =
+        Regex::parse(regex_as_string)->required_literals();
+    vector<string> result;
+
+    for (const auto& literal : required_literals.literals())
+    {
+        string literal_as_string;
+
+        for (const auto& characters : literal)
+        {
+            literal_as_string += '[' + characters.to_string() + ']';
+        }
+
+        result.push_back(literal_as_string);
+    }
+
+    return result;
+}
+
+} // unnamed namespace
+
+
+TEST_F(RequiredLiteralsTest, literals)
+{
+    Alphabet::set("CDEHMNRX");
+
+    EXPECT_EQ((vector<string>{ "[X][H][C][R]", "[X]" }),
+              literals_as_strings(".*XHCR.*X.*"));
+    EXPECT_EQ((vector<string>{ "[D][D]", "[C][C][M]" }),
+              literals_as_strings(".*DD.*CCM.*"));
+    EXPECT_EQ((vector<string>{ "[CDEHMNRX][C]" }),
+              literals_as_strings(".*(?:.C)+"));
+    EXPECT_EQ((vector<string>{ "[CR][DE]" }),
+              literals_as_strings("(CD|RE)+"));
+    EXPECT_EQ((vector<string>{ "[C]" }), literals_as_strings("C(D|EE)"));
+    EXPECT_EQ((vector<string>{ "[X][X]" }), literals_as_strings("X{2,}"));
+    EXPECT_EQ(vector<string>(), literals_as_strings("X*"));
+    EXPECT_EQ((vector<string>{ "[CDEHMNRX]" }),
+              literals_as_strings("(.)\\1"));
+
+    const auto required_literals =
+        Regex::parse("N.*X.X.X.*E")->required_literals();
+    EXPECT_EQ(3U, required_literals.literals().size());
+    EXPECT_TRUE(required_literals.is_prefix());
+    EXPECT_TRUE(required_literals.is_suffix());
+    EXPECT_FALSE(required_literals.is_exact());
+
+    EXPECT_TRUE(Regex::parse("C[DE]")->required_literals().is_exact());
+    EXPECT_TRUE(Regex::parse("C*")->required_literals().constrains_nothing());
+}
+
+TEST_F(RequiredLiteralsTest, constrain)
+{
+    Alphabet::set("ABC");
+
+    const auto ab = Regex::parse(".*AB.*")->required_literals();
+    EXPECT_EQ(Constraint({ "ABC", "AB", "ABC" }),
+              ab.constrain(Constraint({ "ABC", "ABC", "ABC" })));
+    EXPECT_EQ(Constraint({ "A", "B", "C" }),
+              ab.constrain(Constraint({ "ABC", "ABC", "C" })));
+    EXPECT_TRUE(ab.constrain(Constraint({ "C", "AB", "C" })).is_impossible());
+
+    const auto a_then_b = Regex::parse("A.*B.*")->required_literals();
+    EXPECT_EQ(Constraint({ "A", "ABC", "B" }),
+              a_then_b.constrain(Constraint({ "ABC", "ABC", "B" })));
+    EXPECT_TRUE(
+      a_then_b.constrain(Constraint({ "A", "A", "A" })).is_impossible());
+
+    const auto exact = Regex::parse("A[BC]")->required_literals();
+    EXPECT_EQ(Constraint({ "A", "B" }),
+              exact.constrain(Constraint({ "AB", "AB" })));
+    EXPECT_TRUE(
+      exact.constrain(Constraint({ "A", "B", "C" })).is_impossible());
+}
+
+// Narrowing a constraint with the required literals of a regex does not
+// change the result of Regex::constrain().
+TEST_F(RequiredLiteralsTest, constrain_is_safe)
+{
+    Alphabet::set("ABCD");
+
+    const vector<string> regexes_as_strings =
+        { ".*AB.*C.*", "A.*B.C.*D", "(AB|CD)+.*", ".*(A|B)C{2,}",
+          "A+B?.*DA", "(.)\\1.*A", ".*(?=AB)..C", "(A.|B)*C" };
+
+    unsigned int seed = 1;
+
+    for (const auto& regex_as_string : regexes_as_strings)
+    {
+        const auto regex = Regex::parse(regex_as_string);
+        const auto required_literals = regex->required_literals();
+
+        for (size_t size = 1; size <= 6; ++size)
+        {
+            for (int i = 0; i != 40; ++i)
+            {
+                vector<SetOfCharacters> elements(size);
+
+                for (auto& element : elements)
+                {
+                    for (const auto c : Alphabet::characters_as_string())
+                    {
+                        seed = seed * 1103515245 + 12345;
+
+                        if ((seed >> 16) % 4 != 0)
+                        {
+                            element |= SetOfCharacters(c);
+                        }
+                    }
+                }
+
+                const Constraint constraint(elements);
+                const auto narrowed_constraint =
+                    required_literals.constrain(constraint);
+                const auto expected_constraint = regex->constrain(constraint);
+
+                EXPECT_TRUE(expected_constraint.is_tighter_than_or_equal_to(
+                              narrowed_constraint)) << regex_as_string;
+
+                if (narrowed_constraint.is_possible())
+                {
+                    EXPECT_EQ(expected_constraint,
+                              regex->constrain(narrowed_constraint))
+                      << regex_as_string;
+                }
+                else
+                {
+                    EXPECT_TRUE(expected_constraint.is_impossible())
+                      << regex_as_string;
+                }
+            }
+        }
+    }
+}
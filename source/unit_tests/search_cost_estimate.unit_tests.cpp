@@ -0,0 +1,108 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "disable_warnings_from_gtest.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "search_cost_estimate.hpp"
+
+#include <cmath>
+
+using namespace std;
+
+
+class SearchCostEstimateTest : public RegexCrosswordSolverTest
+{
+};
+
+
+TEST_F(SearchCostEstimateTest, no_probes)
+{
+    const SearchCostEstimate estimate;
+
+    EXPECT_EQ(0, estimate.num_probes());
+    EXPECT_EQ(0.0, estimate.num_nodes());
+    EXPECT_EQ(0.0, estimate.time_ms());
+}
+
+TEST_F(SearchCostEstimateTest, one_probe)
+{
+    SearchCostEstimate estimate;
+
+    estimate.add_probe(15.0, 4, 2.0);
+
+    EXPECT_EQ(1, estimate.num_probes());
+    EXPECT_DOUBLE_EQ(15.0, estimate.num_nodes());
+    EXPECT_DOUBLE_EQ(15.0, estimate.min_num_nodes());
+    EXPECT_DOUBLE_EQ(15.0, estimate.max_num_nodes());
+    EXPECT_DOUBLE_EQ(7.5, estimate.time_ms());
+}
+
+TEST_F(SearchCostEstimateTest, several_probes)
+{
+    SearchCostEstimate estimate;
+
+    estimate.add_probe(10.0, 3, 1.0);
+    estimate.add_probe(30.0, 3, 2.0);
+    estimate.add_probe(20.0, 4, 2.0);
+
+    // mean = 20, sample variance = 100, half width = 1.96 * 10 / sqrt(3)
+    const auto half_width = 1.96 * 10.0 / sqrt(3.0);
+
+    EXPECT_EQ(3, estimate.num_probes());
+    EXPECT_DOUBLE_EQ(20.0, estimate.num_nodes());
+    EXPECT_DOUBLE_EQ(20.0 - half_width, estimate.min_num_nodes());
+    EXPECT_DOUBLE_EQ(20.0 + half_width, estimate.max_num_nodes());
+
+    // 5 milliseconds for 10 nodes
+    EXPECT_DOUBLE_EQ(10.0, estimate.time_ms());
+    EXPECT_DOUBLE_EQ((20.0 - half_width) * 0.5, estimate.min_time_ms());
+    EXPECT_DOUBLE_EQ((20.0 + half_width) * 0.5, estimate.max_time_ms());
+}
+
+TEST_F(SearchCostEstimateTest, min_num_nodes_is_at_least_one)
+{
+    SearchCostEstimate estimate;
+
+    estimate.add_probe(1.0, 1, 1.0);
+    estimate.add_probe(1000.0, 10, 1.0);
+
+    EXPECT_DOUBLE_EQ(1.0, estimate.min_num_nodes());
+}
+
+TEST_F(SearchCostEstimateTest, print)
+{
+    SearchCostEstimate estimate;
+
+    estimate.add_probe(7.0, 3, 1.5);
+    estimate.add_probe(7.0, 3, 1.5);
+
+    const vector<string> expected = { "probes              2",
+                                      "nodes               7",
+                                      "nodes (95%)         7 - 7",
+                                      "time (ms)           3.5",
+                                      "time (ms, 95%)      3.5 - 3.5" };
+    EXPECT_EQ(expected, estimate.print());
+}
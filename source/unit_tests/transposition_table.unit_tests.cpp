@@ -0,0 +1,72 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "disable_warnings_from_gtest.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "transposition_table.hpp"
+
+using namespace std;
+
+
+class TranspositionTableTest : public RegexCrosswordSolverTest
+{
+};
+
+
+TEST_F(TranspositionTableTest, record_failure)
+{
+    TranspositionTable table(4);
+
+    EXPECT_FALSE(table.is_known_failure(0x1234));
+
+    table.record_failure(0x1234);
+    EXPECT_TRUE(table.is_known_failure(0x1234));
+    EXPECT_FALSE(table.is_known_failure(0x1235));
+
+    // 0x5674 has the same slot as 0x1234, so it replaces it.
+    table.record_failure(0x5674);
+    EXPECT_TRUE(table.is_known_failure(0x5674));
+    EXPECT_FALSE(table.is_known_failure(0x1234));
+
+    // A hash of 0 marks the empty slots, so it is not recorded.
+    table.record_failure(0);
+    EXPECT_FALSE(table.is_known_failure(0));
+}
+
+TEST_F(TranspositionTableTest, print_statistics)
+{
+    TranspositionTable table(4);
+
+    table.record_failure(1);
+    table.is_known_failure(1);
+    table.is_known_failure(2);
+
+    const vector<string> expected = { "lookups             2",
+                                      "hits                1",
+                                      "hit rate            50%",
+                                      "failures            1" };
+    EXPECT_EQ(expected, table.print_statistics());
+}
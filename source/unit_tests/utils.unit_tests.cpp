@@ -136,6 +136,12 @@ TEST(Utils, split_into_lines)
     }
 }
 
+TEST(Utils, statistics_line)
+{
+    EXPECT_EQ("lookups             12",
+              Utils::statistics_line("lookups", "12"));
+}
+
 TEST(Utils, string_to_unsigned)
 {
     size_t number = 0;
@@ -0,0 +1,81 @@
+// Copyright (c) 2016 Antoine Trux
+//
+// The original version is available at
+// http://solving-regular-expression-crosswords.blogspot.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice, the above original version notice, and
+// this permission notice shall be included in all copies or substantial
+// portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "alphabet.hpp"
+#include "disable_warnings_from_gtest.hpp"
+#include "regex_crossword_solver_test.hpp"
+#include "set_of_characters.hpp"
+#include "zobrist_hash.hpp"
+
+using namespace std;
+
+
+class ZobristHashTest : public RegexCrosswordSolverTest
+{
+};
+
+
+TEST_F(ZobristHashTest, cell_seed)
+{
+    EXPECT_EQ(ZobristHash::cell_seed({ 1, 2 }),
+              ZobristHash::cell_seed({ 1, 2 }));
+    EXPECT_NE(ZobristHash::cell_seed({ 1, 2 }),
+              ZobristHash::cell_seed({ 2, 1 }));
+    EXPECT_NE(ZobristHash::cell_seed({ 1, 2 }),
+              ZobristHash::cell_seed({ 1, 2, 0 }));
+}
+
+TEST_F(ZobristHashTest, hash)
+{
+    Alphabet::set("ABCD");
+
+    const auto seed = ZobristHash::cell_seed({ 0, 0 });
+
+    EXPECT_EQ(0, ZobristHash::hash(seed, SetOfCharacters()));
+    EXPECT_NE(ZobristHash::hash(seed, SetOfCharacters("AB")),
+              ZobristHash::hash(seed, SetOfCharacters("AC")));
+    EXPECT_NE(ZobristHash::hash(seed, SetOfCharacters("AB")),
+              ZobristHash::hash(ZobristHash::cell_seed({ 0, 1 }),
+                                SetOfCharacters("AB")));
+    EXPECT_EQ(ZobristHash::hash(seed, SetOfCharacters("AB")),
+              ZobristHash::hash(seed, SetOfCharacters("A")) ^
+              ZobristHash::hash(seed, SetOfCharacters("B")));
+}
+
+TEST_F(ZobristHashTest, hash_change)
+{
+    Alphabet::set("ABCD");
+
+    const auto seed = ZobristHash::cell_seed({ 3, 1 });
+    const SetOfCharacters old_characters("ABC");
+    const SetOfCharacters new_characters("BD");
+
+    EXPECT_EQ(ZobristHash::hash(seed, new_characters),
+              ZobristHash::hash(seed, old_characters) ^
+              ZobristHash::hash_change(seed, old_characters, new_characters));
+    EXPECT_EQ(0, ZobristHash::hash_change(seed, old_characters,
+                                          old_characters));
+}